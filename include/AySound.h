@@ -32,6 +32,7 @@
 
 #include "hardconfig.h"
 #include "fabgl.h"
+#include "Machine.h"
 
 class AySound
 {
@@ -59,29 +60,29 @@ public:
     static void selectRegister(uint8_t data);
     static void setRegisterData(uint8_t data);
 
-    static SquareWaveformGenerator _channel[3];
+    static MACHINE_STATE SquareWaveformGenerator _channel[3];
 
 private:
-    static uint8_t finePitchChannelA;
-    static uint8_t coarsePitchChannelA;
-    static uint8_t finePitchChannelB;
-    static uint8_t coarsePitchChannelB;
-    static uint8_t finePitchChannelC;
-    static uint8_t coarsePitchChannelC;
-    static uint8_t noisePitch;
-    static uint8_t mixer;
-    static uint8_t volumeChannelA;
-    static uint8_t volumeChannelB;
-    static uint8_t volumeChannelC;
-    static uint8_t envelopeFineDuration;
-    static uint8_t envelopeCoarseDuration;
-    static uint8_t envelopeShape;
-    static uint8_t ioPortA;
+    static MACHINE_STATE uint8_t finePitchChannelA;
+    static MACHINE_STATE uint8_t coarsePitchChannelA;
+    static MACHINE_STATE uint8_t finePitchChannelB;
+    static MACHINE_STATE uint8_t coarsePitchChannelB;
+    static MACHINE_STATE uint8_t finePitchChannelC;
+    static MACHINE_STATE uint8_t coarsePitchChannelC;
+    static MACHINE_STATE uint8_t noisePitch;
+    static MACHINE_STATE uint8_t mixer;
+    static MACHINE_STATE uint8_t volumeChannelA;
+    static MACHINE_STATE uint8_t volumeChannelB;
+    static MACHINE_STATE uint8_t volumeChannelC;
+    static MACHINE_STATE uint8_t envelopeFineDuration;
+    static MACHINE_STATE uint8_t envelopeCoarseDuration;
+    static MACHINE_STATE uint8_t envelopeShape;
+    static MACHINE_STATE uint8_t ioPortA;
 
     // Status
-    static uint8_t selectedRegister;
-    static uint8_t channelVolume[3];
-    static uint16_t channelFrequency[3];
+    static MACHINE_STATE uint8_t selectedRegister;
+    static MACHINE_STATE uint8_t channelVolume[3];
+    static MACHINE_STATE uint16_t channelFrequency[3];
 #endif
 };
 
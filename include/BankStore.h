@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef BankStore_h
+#define BankStore_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+#include "Machine.h"
+
+// 128K RAM without PSRAM (see BANK_STORE in hardconfig.h): banks 2 and 5
+// have their own pages, the rest share BANK_STORE_FRAMES pages and are
+// kept RLE compressed in a pool reserved at setup while out of them.
+// Mem::ram[n] is NULL for those.
+class BankStore
+{
+public:
+    // allocate the shared pages, bank 0 page included (from Mem::ram0),
+    // and the pool; the first banks get the pages, the others start cleared
+    static void setup();
+
+    // get the banks paged in (0xC000 and shadow screen) into SRAM, called
+    // by Mem::updatePaging before using ram[]
+    static void map();
+
+    // get bank into SRAM along with the paged in ones (Mem::bank). The
+    // pointer is only valid until the next call: it may take its page
+    static uint8_t* get(uint8_t bank);
+
+private:
+    static uint8_t* fetch(uint8_t bank);
+    static bool evict(uint8_t bank, bool spill);
+    static void release(uint8_t bank);
+    static bool inPool(const uint8_t* blob);
+
+    static MACHINE_STATE uint8_t* packed[8];      // NULL, all zeros
+    static MACHINE_STATE uint16_t packedSize[8];
+    static MACHINE_STATE bool pinned[8];          // fetched since map()
+    static MACHINE_STATE uint32_t lastUse[8];
+    static MACHINE_STATE uint32_t useClock;
+    static MACHINE_STATE uint8_t* pool;
+    static MACHINE_STATE uint32_t poolSize;
+    static MACHINE_STATE uint32_t poolUsed;
+};
+
+#endif // BankStore_h
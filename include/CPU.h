@@ -32,6 +32,14 @@
 
 #include <inttypes.h>
 #include "ESPectrum.h"
+#include "Machine.h"
+
+// Z80 cores (see Z80_FAST_CORE in hardconfig.h)
+#define CPU_CORE_PRECISE 0
+#define CPU_CORE_FAST    1
+
+// true if accesses to addr are slowed down by the ULA on current machine
+#define ADDRESS_CONTENDED(addr) (CPU::contendedSlot[(addr) >> 14])
 
 class CPU
 {
@@ -52,14 +60,39 @@ public:
     static uint32_t microsPerFrame();
 
     // CPU Tstates elapsed in current frame
-    static uint32_t tstates;
+    static MACHINE_STATE uint32_t tstates;
+
+    // CPU Tstates elapsed since reset, up to the start of current frame
+    static MACHINE_STATE uint64_t global_tstates;
+
+    // CPU Tstates elapsed since reset, exact inside the frame too
+    static uint64_t getGlobalTstates() { return global_tstates + tstates; }
+
+    // 16K slots contended by the ULA (1) or not (0), see ADDRESS_CONTENDED
+    static MACHINE_STATE uint8_t contendedSlot[4];
+
+    // pick the contention policy of the current arch (on machine change)
+    static void setupContention();
+
+    // refresh contendedSlot after a paging change
+    static void updateContention();
+
+    #if defined(ROM_HLE) || defined(Z80_FAST_CORE)
+    // give the machine T-states already run (a loop done natively, a fast
+    // core batch), split where the video renderer has work to do as
+    // ALU_video draws one step a call
+    static void skipTstates(uint32_t count);
+    #endif
+
+    #ifdef Z80_FAST_CORE
+    // Z80 core running the next frames (CPU_CORE_PRECISE or CPU_CORE_FAST)
+    static MACHINE_STATE uint8_t core;
+    static void setCore(uint8_t newCore);
+    #endif
 
-    // CPU Tstates elapsed since reset
-    static uint64_t global_tstates;
-    
     #if (defined(LOG_DEBUG_TIMING) && defined(SHOW_FPS))
     // Frames elapsed
-    static uint32_t framecnt;
+    static MACHINE_STATE uint32_t framecnt;
     #endif
 
 };
@@ -68,10 +101,10 @@ public:
 #define SPEC_W 256
 #define SPEC_H 192
 
-static unsigned int is169;
+static MACHINE_STATE unsigned int is169;
 
-static unsigned int flashing = 0;
-static unsigned int halfsec, sp_int_ctr;
+static MACHINE_STATE unsigned int flashing = 0;
+static MACHINE_STATE unsigned int halfsec, sp_int_ctr;
 
 static unsigned int offBmp[SPEC_H];
 static unsigned int offAtt[SPEC_H];
@@ -79,5 +112,6 @@ static unsigned int offAtt[SPEC_H];
 void ALU_video_init();
 void ALU_video_reset();
 static void ALU_video(unsigned int statestoadd);
+static uint32_t ALU_video_nextEvent();
 
 #endif // CPU_h
@@ -31,6 +31,7 @@
 #define Config_h
 
 #include <Arduino.h>
+#include "Machine.h"
 
 class Config
 {
@@ -41,7 +42,7 @@ public:
     // config variables
     static const String& getArch()   { return arch;   }
     static const String& getRomSet() { return romSet; }
-    static String   ram_file;
+    static MACHINE_STATE String   ram_file;
     static bool     slog_on;
     static bool     aspect_16_9;
 
@@ -63,9 +64,16 @@ public:
     // load lists of TAP files
     static void loadTapLists();
 
+#ifdef Z80_FAST_CORE
+    // snapshots run with the fast Z80 core, one file name per line
+    static String   fast_core_list;
+    static bool     isFastCore(String filename);
+    static void     setFastCore(String filename, bool fast);
+#endif
+
 private:
-    static String   arch;
-    static String   romSet;
+    static MACHINE_STATE String   arch;
+    static MACHINE_STATE String   romSet;
 };
 
 #endif // Config.h
\ No newline at end of file
@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef Debugger_h
+#define Debugger_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+#include "Machine.h"
+
+// breakpoint / watchpoint kinds
+#define BP_EXEC  0x01
+#define BP_READ  0x02
+#define BP_WRITE 0x04
+#define BP_IN    0x08
+#define BP_OUT   0x10
+#define BP_KINDS 5
+
+// break at next opcode fetch, whatever the address
+#define BP_STEP  0x20
+
+class Debugger
+{
+public:
+    // set / clear a breakpoint (BP_EXEC) or watchpoint at an address or port
+    static bool set(uint8_t kind, uint16_t addr);
+    static void clear(uint8_t kind, uint16_t addr);
+    static void clearAll();
+
+    // check an access from Z80Ops; breaks into the serial prompt on a hit
+    template<uint8_t kind> static void check(uint16_t addr, uint8_t value = 0);
+
+    // run pending serial commands (call once per frame)
+    static void pollSerial();
+
+    // kinds with at least one point set, plus BP_STEP
+    static MACHINE_STATE uint8_t armed;
+
+private:
+    static void hit(uint8_t kind, uint16_t addr, uint8_t value);
+    static void prompt();
+    static bool command(const char* line);
+    static bool readLine();
+    static void list(uint8_t kind);
+    static void updateArmed();
+
+    // one bit per address / port, allocated when the first point is set
+    static MACHINE_STATE uint8_t* bitmap[BP_KINDS];
+    static MACHINE_STATE uint16_t count[BP_KINDS];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// inline check, only the armed test remains in the access path
+
+template<uint8_t kind>
+inline void Debugger::check(uint16_t addr, uint8_t value) {
+    if (__builtin_expect((armed & (kind == BP_EXEC ? BP_EXEC | BP_STEP : kind)) != 0, 0))
+        hit(kind, addr, value);
+}
+
+#endif // Debugger_h
@@ -32,6 +32,7 @@
 
 #include "hardpins.h"
 #include <FS.h>
+#include "Machine.h"
 
 // Declared vars
 #ifdef COLOR_3B
@@ -79,22 +80,22 @@ public:
     static void reset();
 
     // Video
-    static VGA vga;
-    static uint8_t borderColor;
+    static MACHINE_STATE VGA vga;
+    static MACHINE_STATE uint8_t borderColor;
     static void processKeyboard();
 
     // Audio
-    static unsigned char audioBuffer[2][ESP_AUDIO_SAMPLES];
-    static unsigned char overSamplebuf[ESP_AUDIO_OVERSAMPLES];
+    static MACHINE_STATE unsigned char audioBuffer[2][ESP_AUDIO_SAMPLES];
+    static MACHINE_STATE unsigned char overSamplebuf[ESP_AUDIO_OVERSAMPLES];
     static signed char aud_volume;
-    static int buffertofill;
-    static int buffertoplay;
-    static uint32_t audbufcnt;
-    static int lastaudioBit;
+    static MACHINE_STATE int buffertofill;
+    static MACHINE_STATE int buffertoplay;
+    static MACHINE_STATE uint32_t audbufcnt;
+    static MACHINE_STATE int lastaudioBit;
     static void audioFrameStart();
     static void audioGetSample(int Audiobit);
     static void audioFrameEnd();
-    static int samplesPerFrame;
+    static MACHINE_STATE int samplesPerFrame;
 
 
     //static int ESPoffset; // Testing
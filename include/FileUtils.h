@@ -64,6 +64,9 @@ private:
 #define DISK_SNA_DIR "/sna"
 #define DISK_TAP_DIR "/tap"
 #define DISK_PSNA_FILE "/persist/persist"
+#define DISK_PROFILE_FILE "/z80prof.csv"
+#define DISK_HOTSPOTS_FILE "/hotspots.csv"
+#define DISK_COVERAGE_FILE "/coverage.bin"
 #define NO_RAM_FILE "none"
 #define SNA_48K_SIZE 49179
 #define SNA_128K_SIZE1 131103
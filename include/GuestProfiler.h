@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef GuestProfiler_h
+#define GuestProfiler_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+#include "Machine.h"
+#include "Mem.h"
+
+// physical pages: 0..3 are ROM 0..3, 4..11 are RAM 0..7
+#define GPROF_PAGES 12
+#define GPROF_RAM_PAGE 4
+
+#define GPROF_BUCKETS_PER_PAGE (MEM_PG_SZ >> GUEST_PROFILER_BUCKET_BITS)
+#define GPROF_COVERAGE_PAGE_SZ (MEM_PG_SZ >> 3)
+
+class GuestProfiler
+{
+public:
+    // allocate histogram and coverage bitmaps (cleared)
+    static void setup();
+
+    // clear histogram and coverage bitmaps
+    static void clear();
+
+    // record current guest PC into the hotspot histogram
+    static void sample();
+
+    // mark address as executed, called for every opcode fetch
+    static void markExecuted(uint16_t addr);
+
+    // print top hotspots and coverage summary over Serial
+    static void printReport();
+
+    // save histogram (CSV) and coverage bitmaps (raw) to disk
+    static bool save();
+
+    // physical page mapped at a given guest address
+    static uint8_t physPage(uint16_t addr);
+
+private:
+    static void sampleAt(uint16_t addr);
+
+    static MACHINE_STATE uint32_t* hotspots;
+    static MACHINE_STATE uint8_t* coverage;
+    static MACHINE_STATE uint32_t samples;
+    #if GUEST_PROFILER_EVERY > 0
+    static MACHINE_STATE uint32_t countdown;
+    #endif
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// inline functions, called from the opcode fetch path
+
+inline uint8_t GuestProfiler::physPage(uint16_t addr) {
+    switch (addr >> 14) {
+    case 0:
+        return Mem::romInUse;
+    case 1:
+        return GPROF_RAM_PAGE + 5;
+    case 2:
+        return GPROF_RAM_PAGE + 2;
+    default:
+        return GPROF_RAM_PAGE + Mem::bankLatch;
+    }
+}
+
+inline void GuestProfiler::sampleAt(uint16_t addr) {
+    hotspots[physPage(addr) * GPROF_BUCKETS_PER_PAGE
+             + ((addr & (MEM_PG_SZ - 1)) >> GUEST_PROFILER_BUCKET_BITS)]++;
+    samples++;
+}
+
+inline void GuestProfiler::markExecuted(uint16_t addr) {
+    if (coverage == NULL) return;
+
+    uint16_t offset = addr & (MEM_PG_SZ - 1);
+    coverage[physPage(addr) * GPROF_COVERAGE_PAGE_SZ + (offset >> 3)] |= 1 << (offset & 7);
+
+    #if GUEST_PROFILER_EVERY > 0
+    if (--countdown == 0) {
+        countdown = GUEST_PROFILER_EVERY;
+        sampleAt(addr);
+    }
+    #endif
+}
+
+#endif // GuestProfiler_h
@@ -0,0 +1,68 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef Machine_h
+#define Machine_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+
+// Storage class for every piece of emulated machine state (Z80 registers,
+// memory paging, ports, ULA/video counters, AY registers, tape, arch).
+// Device builds keep one plain static machine; host builds that define
+// MACHINE_PER_THREAD get an independent machine on every thread.
+#ifdef MACHINE_PER_THREAD
+#define MACHINE_STATE thread_local
+#else
+#define MACHINE_STATE
+#endif
+
+// Host machine (MACHINE_PER_THREAD, see Machine.cpp): the Z80, memory
+// paging and keyboard of a 48K or 128K Spectrum, with no video, sound,
+// contention or tape. Every call works on the calling thread's machine,
+// so run each machine on a thread of its own. The ESP32 runs its one
+// machine through ESPectrum and CPU instead.
+class Machine
+{
+public:
+    // hook ROM and RAM pages to the calling thread's machine: ROM 0 (and 1
+    // on 128K), RAM banks 0-7 (only 5, 2 and 0 are used on 48K)
+    static void attachMemory(uint8_t* const rom[4], uint8_t* const ram[8], bool is128K);
+
+    // power on the calling thread's machine
+    static void reset();
+
+    // emulate one frame, with the interrupt at its end. Returns T-states run
+    static uint32_t runFrame();
+
+    // keyboard half row (0 = CAPS SHIFT..V, 7 = SPACE..B), bit set: key down
+    static void setKeys(uint8_t row, uint8_t keys);
+};
+
+#endif // Machine_h
@@ -31,39 +31,93 @@
 #define Mem_h
 
 #include <inttypes.h>
+#include "Machine.h"
+#ifdef RAM_MIGRATION
+#include "RamPlacement.h"
+#endif
 
 #define ADDRESS_IN_LOW_RAM(addr) (1 == (addr >> 14))
 
 #define MEM_PG_SZ 0x4000
 
+// dirty map granularity: 256 byte blocks, 64 per 16K page
+#define MEM_DIRTY_BLOCK_SZ 0x100
+#define MEM_DIRTY_BLOCKS (MEM_PG_SZ / MEM_DIRTY_BLOCK_SZ)
+
 class Mem
 {
 public:
-    static uint8_t* rom0;
-    static uint8_t* rom1;
-    static uint8_t* rom2;
-    static uint8_t* rom3;
-
-    static uint8_t* rom[4];
-
-    static uint8_t* ram0;
-    static uint8_t* ram1;
-    static uint8_t* ram2;
-    static uint8_t* ram3;
-    static uint8_t* ram4;
-    static uint8_t* ram5;
-    static uint8_t* ram6;
-    static uint8_t* ram7;
-
-    static uint8_t* ram[8];
-
-    static volatile uint8_t bankLatch;
-    static volatile uint8_t videoLatch;
-    static volatile uint8_t romLatch;
-    static volatile uint8_t pagingLock;
-    static uint8_t modeSP3;
-    static uint8_t romSP3;
-    static uint8_t romInUse;
+    static MACHINE_STATE uint8_t* rom0;
+    static MACHINE_STATE uint8_t* rom1;
+    static MACHINE_STATE uint8_t* rom2;
+    static MACHINE_STATE uint8_t* rom3;
+
+    static MACHINE_STATE uint8_t* rom[4];
+
+    static MACHINE_STATE uint8_t* ram0;
+    static MACHINE_STATE uint8_t* ram1;
+    static MACHINE_STATE uint8_t* ram2;
+    static MACHINE_STATE uint8_t* ram3;
+    static MACHINE_STATE uint8_t* ram4;
+    static MACHINE_STATE uint8_t* ram5;
+    static MACHINE_STATE uint8_t* ram6;
+    static MACHINE_STATE uint8_t* ram7;
+
+    static MACHINE_STATE uint8_t* ram[8];
+
+    static MACHINE_STATE volatile uint8_t bankLatch;
+    static MACHINE_STATE volatile uint8_t videoLatch;
+    static MACHINE_STATE volatile uint8_t romLatch;
+    static MACHINE_STATE volatile uint8_t pagingLock;
+    static MACHINE_STATE uint8_t modeSP3;
+    static MACHINE_STATE uint8_t romSP3;
+    // special paging configuration (0x1FFD bits 1-2, used when modeSP3)
+    static MACHINE_STATE uint8_t specialSP3;
+    // +2A / +3 memory controller present (port 0x1FFD decoded)
+    static MACHINE_STATE bool plus3Paging;
+    // RAM bank in each slot for every special paging configuration
+    static const uint8_t specialBanks[4][4];
+    static MACHINE_STATE uint8_t romInUse;
+
+    // memory map: page read from and page written to for each 16K slot,
+    // and the offset mask for writes: 0 on ROM, which is written to
+    // romSink, one byte never read back
+    static MACHINE_STATE uint8_t* readPage[4];
+    static MACHINE_STATE uint8_t* writePage[4];
+    static MACHINE_STATE uint16_t writeMask[4];
+    static MACHINE_STATE uint8_t romSink;
+
+    // dirty map: one byte per 256-byte block of each RAM bank, set by
+    // writebyte and cleared by the consumer (snapshot deltas, rewind,
+    // screen redraw...). The entries after bank 7 take the ROM writes.
+    static MACHINE_STATE uint8_t dirty[9 * MEM_DIRTY_BLOCKS];
+    // dirty map entries for the page written to in each 16K slot
+    static MACHINE_STATE uint8_t* writeDirty[4];
+
+    #ifdef RAM_MIGRATION
+    // reads and writes left until the next one sampled for RamPlacement
+    static MACHINE_STATE uint8_t accessSample;
+    #endif
+
+    static bool isDirty(uint8_t bank, uint8_t block);
+    // any block of the bank written to since last cleared
+    static bool isBankDirty(uint8_t bank);
+    static void clearDirty(uint8_t bank);
+    // whole RAM changed (snapshot load, machine switch)
+    static void setAllDirty();
+
+    // select ROM page and rebuild the memory map (so call it also after
+    // changing bankLatch or the +2A/+3 modes, as every paging write does)
+    static void selectRom(uint8_t romPage);
+    // rebuild readPage / writePage from the paging latches
+    static void updatePaging();
+
+    // set RAM bank page (ram[bank] and its ramN alias)
+    static void setRam(uint8_t bank, uint8_t* page);
+    // RAM bank page, for whole page copies (snapshots): with BANK_STORE
+    // it may be compressed, so get it this way and not from ram[]. The
+    // pointer is only valid until the next call, don't hold two at once
+    static uint8_t* bank(uint8_t n);
 
     static uint8_t readbyte(uint16_t addr);
     static uint16_t readword(uint16_t addr);
@@ -75,41 +129,32 @@ public:
 //
 // inline memory access functions
 
+inline void Mem::selectRom(uint8_t romPage) {
+    romInUse = romPage;
+    updatePaging();
+}
+
 inline uint8_t Mem::readbyte(uint16_t addr) {
-    uint8_t page = addr >> 14;
-    switch (page) {
-    case 0:
-        return rom[romInUse][addr];
-    case 1:
-        return ram5[addr - 0x4000];
-    case 2:
-        return ram2[addr - 0x8000];
-    case 3:
-        return ram[bankLatch][addr - 0xC000];
-    }
+    #ifdef RAM_MIGRATION
+    if (--accessSample == 0) RamPlacement::sample(addr >> 14);
+    #endif
+    return readPage[addr >> 14][addr & 0x3fff];
 }
 
 inline uint16_t Mem::readword(uint16_t addr) {
     return ((readbyte(addr + 1) << 8) | readbyte(addr));
 }
 
-inline void Mem::writebyte(uint16_t addr, uint8_t data)
-{
-    uint8_t page = addr >> 14;
-    switch (page) {
-    case 0:
-        return;
-    case 1:
-        ram5[addr - 0x4000] = data;
-        break;
-    case 2:
-        ram2[addr - 0x8000] = data;
-        break;
-    case 3:
-        ram[bankLatch][addr - 0xC000] = data;
-        break;
-    }
-    return;
+inline void Mem::writebyte(uint16_t addr, uint8_t data) {
+    #ifdef RAM_MIGRATION
+    if (--accessSample == 0) RamPlacement::sample(addr >> 14);
+    #endif
+    writePage[addr >> 14][addr & writeMask[addr >> 14]] = data;
+    writeDirty[addr >> 14][(addr >> 8) & 0x3f] = 1;
+}
+
+inline bool Mem::isDirty(uint8_t bank, uint8_t block) {
+    return dirty[bank * MEM_DIRTY_BLOCKS + block];
 }
 
 inline void Mem::writeword(uint16_t addr, uint16_t data) {
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef MemHeatmap_h
+#define MemHeatmap_h
+
+#include <inttypes.h>
+#include <stddef.h>
+#include "hardconfig.h"
+#include "Machine.h"
+#include "Mem.h"
+
+// physical pages: 0..3 are ROM 0..3, 4..11 are RAM 0..7
+#define HEAT_PAGES 12
+#define HEAT_RAM_PAGE 4
+
+// 256 byte blocks, as the dirty map
+#define HEAT_BLOCKS_PER_PAGE MEM_DIRTY_BLOCKS
+
+#define HEAT_READ 0
+#define HEAT_WRITE 1
+#define HEAT_FETCH 2
+#define HEAT_KINDS 3
+
+// Memory access heatmap (see MEM_HEATMAP in hardconfig.h)
+class MemHeatmap
+{
+public:
+    // allocate the counters (cleared)
+    static void setup();
+
+    // clear the counters
+    static void clear();
+
+    // count an access, called from the memory callbacks
+    static void countRead(uint16_t addr);
+    static void countWrite(uint16_t addr);
+    static void countFetch(uint16_t addr);
+
+    // every block accessed over Serial, as CSV
+    static void printCSV();
+
+    // one character per block over Serial, a line per page: accesses on
+    // a log scale, then blocks both written and fetched from
+    static void printMap();
+
+    // bar per page (fetches, reads, writes) in the OSD, until a key
+    static void drawChart();
+
+private:
+    static uint8_t physPage(uint16_t addr);
+    static void count(uint16_t addr, uint8_t kind);
+    static uint32_t pageTotal(uint8_t page, uint8_t kind);
+
+    static MACHINE_STATE uint32_t* counts;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// inline functions, called from the memory access path
+
+// RAM banks found from the dirty map row written to in the slot, so the
+// +2A/+3 special modes come out right too
+inline uint8_t MemHeatmap::physPage(uint16_t addr) {
+    uint8_t bank = (Mem::writeDirty[addr >> 14] - Mem::dirty) / MEM_DIRTY_BLOCKS;
+    return bank < 8 ? HEAT_RAM_PAGE + bank : Mem::romInUse;
+}
+
+inline void MemHeatmap::count(uint16_t addr, uint8_t kind) {
+    if (counts == NULL) return;
+
+    uint32_t block = physPage(addr) * HEAT_BLOCKS_PER_PAGE
+                   + ((addr & (MEM_PG_SZ - 1)) / MEM_DIRTY_BLOCK_SZ);
+    counts[block * HEAT_KINDS + kind]++;
+}
+
+inline void MemHeatmap::countRead(uint16_t addr) { count(addr, HEAT_READ); }
+inline void MemHeatmap::countWrite(uint16_t addr) { count(addr, HEAT_WRITE); }
+inline void MemHeatmap::countFetch(uint16_t addr) { count(addr, HEAT_FETCH); }
+
+#endif // MemHeatmap_h
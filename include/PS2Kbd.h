@@ -90,6 +90,8 @@ public:
 #define KEY_PAGE_UP      0xE07D
 #define KEY_PAGE_DOWN    0xE07A
 #define KEY_PAUSE        0xE11477E1F014E077
+#define KEY_SCROLL_LOCK  0x7E
+#define KEY_PRINT_SCREEN 0xE07C
 
 #define KEY_COMMA     0x41
 #define KEY_DOT       0x49
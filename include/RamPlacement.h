@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef RamPlacement_h
+#define RamPlacement_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+#include "Machine.h"
+
+// Adaptive SRAM/PSRAM placement of the RAM banks (see RAM_MIGRATION in
+// hardconfig.h). Banks count the memory accesses sampled from them, and
+// the busiest ones are swapped into SRAM between frames.
+class RamPlacement
+{
+public:
+    // find out which banks setup put into SRAM, once they are allocated
+    static void setup();
+
+    // count an access to the bank in slot, one every RAM_MIGRATION_SAMPLE
+    // reads and writes (from Mem::readbyte / writebyte)
+    static void sample(uint8_t slot);
+
+    // close the frame, and every RAM_MIGRATION_FRAMES swap at most a
+    // pair of banks. Call between frames only (CPU::tstates about to reset)
+    static void frameEnd();
+
+private:
+    static void swapBanks(uint8_t toSram, uint8_t toPsram);
+
+    static MACHINE_STATE uint32_t use[8];
+    static MACHINE_STATE uint32_t score[8];
+    static MACHINE_STATE bool inSram[8];
+    static MACHINE_STATE uint16_t frames;
+};
+
+#endif // RamPlacement_h
@@ -0,0 +1,55 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef RomHLE_h
+#define RomHLE_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+
+// High level emulation of the delay loops in the 48K ROM (see ROM_HLE in
+// hardconfig.h). Each loop is skipped a whole number of passes at a time,
+// leaving registers, MEMPTR, R and the clock as the interpreter would.
+class RomHLE
+{
+public:
+    // tell the Z80 core which ROM addresses to hand to run()
+    static void setup();
+
+    // run the loop at pc natively, without reaching deadline (T-states in
+    // frame). false if pc is not a known loop or nothing could be skipped
+    static bool run(uint16_t pc, uint32_t deadline);
+
+private:
+    static bool matches(uint16_t pc, const uint8_t* code, uint8_t len);
+    static bool beeperDelay(uint32_t deadline);
+    static bool djnzDelay(uint16_t pc, uint32_t deadline);
+};
+
+#endif // RomHLE_h
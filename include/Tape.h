@@ -1,4 +1,5 @@
 #include <FS.h>
+#include "Machine.h"
 
 #ifndef Tape_h
 #define Tape_h
@@ -39,10 +40,10 @@ class Tape
 public:
 
     // Tape
-    static String tapeFileName;
-    static uint8_t tapeStatus;
-    static uint8_t SaveStatus;
-    static uint8_t romLoading;
+    static MACHINE_STATE String tapeFileName;
+    static MACHINE_STATE uint8_t tapeStatus;
+    static MACHINE_STATE uint8_t SaveStatus;
+    static MACHINE_STATE uint8_t romLoading;
 
     static void Init();
     static bool TAP_Load();
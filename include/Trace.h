@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef Trace_h
+#define Trace_h
+
+#include <inttypes.h>
+#include "hardconfig.h"
+#include "Machine.h"
+
+// The ring is made of INSTR_TRACE_BLOCKS blocks. Each block starts with a
+// keyframe holding the full state the first record is relative to, so the
+// oldest block can be overwritten without breaking the ones after it.
+#define TRACE_BLOCK_SZ 256
+#define TRACE_KEYFRAME_SZ 7     // pc (2), bank state (1), T-states (4)
+#define TRACE_RECORD_MAX 13     // header, pc (2), bank state, T-states (5), opcode (4)
+
+// record header byte (0 ends a block)
+#define TRACE_REC      0x80
+#define TRACE_OPLEN    0x03     // opcode bytes: 0 -> 1, 1 -> 2 (prefix, opcode), 2 -> 4 (DD/FD CB d opcode)
+#define TRACE_PC_SHIFT 2
+#define TRACE_PC_MASK  0x1c     // 1..6: pc is previous pc + n
+#define TRACE_PC_REL8  0        // signed 8 bit delta from previous pc follows
+#define TRACE_PC_ABS   7        // absolute pc follows
+#define TRACE_BANK     0x20     // bank state byte follows
+
+class Trace
+{
+public:
+    // allocate the ring and start tracing
+    static void setup();
+
+    // drop all records, re-arm crash detection
+    static void clear();
+
+    // record the instruction about to run at pc, called from Z80::execute
+    static void record(uint16_t pc);
+
+    // print the last n recorded instructions (0 for all) over Serial
+    static void dump(uint32_t n = 0);
+
+private:
+    static void newBlock();
+    static uint32_t walk(uint32_t skip);
+    static uint8_t bankState();
+
+    static MACHINE_STATE uint8_t* ring;
+    static MACHINE_STATE uint8_t block;     // block being written
+    static MACHINE_STATE uint8_t filled;    // blocks holding records
+    static MACHINE_STATE uint16_t pos;      // write offset into ring
+    static MACHINE_STATE uint16_t lastPC;
+    static MACHINE_STATE uint8_t lastBank;
+    static MACHINE_STATE uint32_t lastTstates;
+    static MACHINE_STATE bool crashed;
+};
+
+#endif // Trace_h
@@ -21,8 +21,12 @@
 #define Z80CPP_H
 
 #include "../hardconfig.h"
+#include "../Machine.h"
 
 #include <stdint.h>
+#ifdef Z80_PROFILER
+#include <stdio.h>
+#endif
 
 #pragma GCC optimize ("O3")
 
@@ -42,8 +46,6 @@ typedef union {
     uint16_t word;
 } RegisterPair;
 
-#include "z80operations.h"
-
 #define REG_B   regBC.byte8.hi
 #define REG_C   regBC.byte8.lo
 #define REG_BC  regBC.word
@@ -89,25 +91,45 @@ typedef union {
 #define REG_Z   memptr.byte8.lo
 #define REG_WZ  memptr.word
 
+#endif // Z80CPP_H
+
+/* Variantes del núcleo: el mismo código compilado otra vez contra otra clase
+ * de callbacks (ver Z80_Fast.cpp). Esa unidad define Z80_CORE_VARIANT y
+ * renombra Z80 y Z80Ops con macros antes de incluir Z80_JLS.cpp; la clase
+ * resultante no declara estado propio, hereda el de Z80State (la clase Z80
+ * de siempre), así que todas las variantes ven los mismos registros.
+ */
+#if (!defined(Z80_CORE_VARIANT) && !defined(Z80CPP_CLASS_H)) \
+    || (defined(Z80_CORE_VARIANT) && !defined(Z80CPP_VARIANT_H))
+
+#include "z80operations.h"
+
+#ifdef Z80_CORE_VARIANT
+#define Z80CPP_VARIANT_H
+class Z80 : public Z80State {
+#else
+#define Z80CPP_CLASS_H
 class Z80 {
 public:
     // Modos de interrupción
     enum IntMode {
         IM0, IM1, IM2
     };
-private:
+#endif
+protected:
+#ifndef Z80_CORE_VARIANT
     // Código de instrucción a ejecutar
     // Poner esta variable como local produce peor rendimiento
     // ZEXALL test: (local) 1:54 vs 1:47 (visitante)
-    static uint8_t opCode;
+    static MACHINE_STATE uint8_t opCode;
     // Se está ejecutando una instrucción prefijada con DD, ED o FD
     // Los valores permitidos son [0x00, 0xDD, 0xED, 0xFD]
     // El prefijo 0xCB queda al margen porque, detrás de 0xCB, siempre
     // viene un código de instrucción válido, tanto si delante va un
     // 0xDD o 0xFD como si no.
-    static uint8_t prefixOpcode;
+    static MACHINE_STATE uint8_t prefixOpcode;
     // Subsistema de notificaciones
-    static bool execDone;
+    static MACHINE_STATE bool execDone;
     // Posiciones de los flags
     const static uint8_t CARRY_MASK = 0x01;
     const static uint8_t ADDSUB_MASK = 0x02;
@@ -125,13 +147,40 @@ private:
     const static uint8_t FLAG_SZP_MASK = FLAG_SZ_MASK | PARITY_MASK;
     const static uint8_t FLAG_SZHP_MASK = FLAG_SZP_MASK | HALFCARRY_MASK;
     // Acumulador y resto de registros de 8 bits
-    static uint8_t regA;
+    static MACHINE_STATE uint8_t regA;
     // Flags sIGN, zERO, 5, hALFCARRY, 3, pARITY y ADDSUB (n)
-    static uint8_t sz5h3pnFlags;
+    static MACHINE_STATE uint8_t sz5h3pnFlags;
     // El flag Carry es el único que se trata aparte
-    static bool carryFlag;
+    static MACHINE_STATE bool carryFlag;
+#endif // Z80_CORE_VARIANT
+#ifdef Z80_LAZY_FLAGS
+#ifndef Z80_CORE_VARIANT
+    /* Flags diferidos: las operaciones de 8 bits (ADD/ADC/SUB/SBC/CP,
+     * AND/OR/XOR, INC/DEC) solo guardan el tipo de operación, los operandos
+     * y el resultado. sz5h3pnFlags y carryFlag no son válidos mientras
+     * lazyFlags != LAZY_NONE (salvo el carry tras INC/DEC, que no lo tocan)
+     * y se calculan en materializeFlags() cuando alguien los lee.
+     */
+    enum LazyFlags { LAZY_NONE, LAZY_INC, LAZY_DEC, LAZY_AND, LAZY_OR, LAZY_ADD, LAZY_SUB, LAZY_CP };
+    static MACHINE_STATE uint8_t lazyFlags;
+    // Operandos (A antes de la operación y el otro operando)
+    static MACHINE_STATE uint8_t lazyOper1, lazyOper2;
+    // Resultado de 9 bits: desde LAZY_AND en adelante el bit 8 es el carry
+    static MACHINE_STATE uint16_t lazyRes;
+#endif // Z80_CORE_VARIANT
+    static void materializeFlags(void);
+#endif
+    // Pone al día sz5h3pnFlags y carryFlag antes de leerlos o modificarlos
+    static inline void syncFlags(void) {
+#ifdef Z80_LAZY_FLAGS
+        if (lazyFlags != LAZY_NONE) {
+            materializeFlags();
+        }
+#endif
+    }
+#ifndef Z80_CORE_VARIANT
     // Registros principales y alternativos
-    static RegisterPair regBC, regBCx, regDE, regDEx, regHL, regHLx;
+    static MACHINE_STATE RegisterPair regBC, regBCx, regDE, regDEx, regHL, regHLx;
     /* Flags para indicar la modificación del registro F en la instrucción actual
      * y en la anterior.
      * Son necesarios para emular el comportamiento de los bits 3 y 5 del
@@ -142,40 +191,42 @@ private:
      *
      * Thanks to Patrik Rak for his tests and investigations.
      */
-    static bool flagQ, lastFlagQ;
+    static MACHINE_STATE bool flagQ, lastFlagQ;
 
     // Acumulador alternativo y flags -- 8 bits
-    static RegisterPair regAFx;
+    static MACHINE_STATE RegisterPair regAFx;
 
     // Registros de propósito específico
     // *PC -- Program Counter -- 16 bits*
-    static RegisterPair regPC;
+    static MACHINE_STATE RegisterPair regPC;
     // *IX -- Registro de índice -- 16 bits*
-    static RegisterPair regIX;
+    static MACHINE_STATE RegisterPair regIX;
     // *IY -- Registro de índice -- 16 bits*
-    static RegisterPair regIY;
+    static MACHINE_STATE RegisterPair regIY;
     // *SP -- Stack Pointer -- 16 bits*
-    static RegisterPair regSP;
+    static MACHINE_STATE RegisterPair regSP;
     // *I -- Vector de interrupción -- 8 bits*
-    static uint8_t regI;
+    static MACHINE_STATE uint8_t regI;
     // *R -- Refresco de memoria -- 7 bits*
-    static uint8_t regR;
+    static MACHINE_STATE uint8_t regR;
     // *R7 -- Refresco de memoria -- 1 bit* (bit superior de R)
-    static bool regRbit7;
+    static MACHINE_STATE bool regRbit7;
     //Flip-flops de interrupción
-    static bool ffIFF1;
-    static bool ffIFF2;
+    static MACHINE_STATE bool ffIFF1;
+    static MACHINE_STATE bool ffIFF2;
     // EI solo habilita las interrupciones DESPUES de ejecutar la
     // siguiente instrucción (excepto si la siguiente instrucción es un EI...)
-    static bool pendingEI;
+    static MACHINE_STATE bool pendingEI;
     // Estado de la línea NMI
-    static bool activeNMI;
+    static MACHINE_STATE bool activeNMI;
+    // Estado de la línea INT (activa hasta que la CPU acepta la interrupción)
+    static MACHINE_STATE bool activeINT;
     // Modo de interrupción
-    static IntMode modeINT;
+    static MACHINE_STATE IntMode modeINT;
     // halted == true cuando la CPU está ejecutando un HALT (28/03/2010)
-    static bool halted;
+    static MACHINE_STATE bool halted;
     // pinReset == true, se ha producido un reset a través de la patilla
-    static bool pinReset;
+    static MACHINE_STATE bool pinReset;
     /*
      * Registro interno que usa la CPU de la siguiente forma
      *
@@ -197,7 +248,8 @@ private:
      *                Shit yourself, little parrot.
      */
 
-    static RegisterPair memptr;
+    static MACHINE_STATE RegisterPair memptr;
+#endif // Z80_CORE_VARIANT
     // I and R registers
     static inline RegisterPair getPairIR(void);
 
@@ -211,16 +263,129 @@ private:
      * importante para muchas operaciones que ponen ciertos flags a 0 por real
      * decreto. Si lo ponen a 1 por el mismo método basta con hacer un OR con
      * la máscara correspondiente.
+     * Las tablas se generan en tiempo de compilación (constexpr) y son
+     * de solo lectura, así que van a flash salvo con Z80_TABLES_IN_DRAM.
      */
-    static uint8_t sz53n_addTable[256];
-    static uint8_t sz53pn_addTable[256];
-    static uint8_t sz53n_subTable[256];
-    static uint8_t sz53pn_subTable[256];
-
-    // Un true en una dirección indica que se debe notificar que se va a
-    // ejecutar la instrucción que está en esa direción.
+#ifndef Z80_CORE_VARIANT
+    static const uint8_t sz53n_addTable[256];
+    static const uint8_t sz53pn_addTable[256];
+    static const uint8_t sz53n_subTable[256];
+    static const uint8_t sz53pn_subTable[256];
+
+    // Resultado de DAA precalculado para cada A y flags de entrada.
+    // Índice: A | carry << 8 | halfcarry << 9 | addsub << 10
+    // Valor: A << 8 | F (con el carry en el bit 0)
+    static const uint16_t daaTable[2048];
+#endif // Z80_CORE_VARIANT
+
+    // Generadores de las tablas
+    static constexpr uint8_t parity(uint32_t value);
+    static constexpr uint8_t sz53n(uint32_t value);
+    static constexpr uint8_t daaAdjust(uint32_t idx);
+    static constexpr uint8_t daaResult(uint32_t idx);
+    static constexpr uint16_t daaEntry(uint32_t idx);
+
+    // Hay puntos de ruptura o vigilancia armados. Los comprueba la máquina
+    // en Z80Ops; aquí solo evita atajos que se saltarían esas comprobaciones.
+#ifndef Z80_CORE_VARIANT
 #ifdef WITH_BREAKPOINT_SUPPORT
-    static bool breakpointEnabled {false};
+    static MACHINE_STATE bool breakpointEnabled;
+#endif
+#ifdef INSTR_TRACE
+    // Traza de instrucciones activa: execute() pasa cada PC a Z80Ops
+    static MACHINE_STATE bool traceEnabled;
+#endif
+#ifdef ROM_HLE
+    // Páginas de la ROM con rutinas para Z80Ops::romRoutine (las mismas en
+    // todas las máquinas: no es MACHINE_STATE)
+    static MACHINE_STATE uint8_t romHookPage[64];
+#endif
+#endif // Z80_CORE_VARIANT
+#ifdef Z80_PROFILER
+#ifndef Z80_CORE_VARIANT
+    // Perfilador: veces, T-estados y ciclos del host por código de operación
+    // en cada tabla de decodificación (DDCB cuenta también FDCB)
+    enum ProfTable { PROF_BASE, PROF_CB, PROF_ED, PROF_DD, PROF_FD, PROF_DDCB, PROF_TABLES };
+    static MACHINE_STATE uint32_t profCount[PROF_TABLES][256];
+    static MACHINE_STATE uint64_t profTstates[PROF_TABLES][256];
+    static MACHINE_STATE uint64_t profCycles[PROF_TABLES][256];
+    // Tabla y código de la instrucción en curso (lo fija el último decode*)
+    static MACHINE_STATE uint8_t profTable, profOpcode;
+    // T-estados y ciclos del host al empezar la instrucción en curso
+    static MACHINE_STATE uint32_t profStartTstates, profStartCycles;
+#endif // Z80_CORE_VARIANT
+    // Empieza a medir una instrucción
+    static inline void profileStart(void);
+    // Acumula lo medido en la entrada de la instrucción en curso
+    static inline void profileSample(void);
+#endif
+#if defined(Z80_BLOCK_CACHE) && !defined(Z80_CORE_VARIANT)
+    /* Caché de bloques (en el host, o solo la ROM con ROM_PREDECODE): cada
+     * bloque básico se traduce una vez a una lista de BlockOp, con los
+     * operandos inmediatos ya leídos y un manejador por instrucción
+     * (blockRun<tipo, variante>). Se ejecuta desde executeUntil y vuelve al
+     * intérprete al acabar el bloque.
+     */
+#ifndef BLOCK_POOL_SIZE
+#define BLOCK_POOL_SIZE   32768
+#endif
+    // Solo las direcciones por debajo tienen entrada en blockIndex; el resto
+    // va siempre al intérprete (la máquina puede limitarlo p. ej. a la ROM)
+#ifndef BLOCK_CACHE_LIMIT
+#define BLOCK_CACHE_LIMIT 0x10000
+#endif
+#if BLOCK_POOL_SIZE < 0x8000
+    typedef int16_t BlockEntry;
+#else
+    typedef int32_t BlockEntry;
+#endif
+    struct BlockOp;
+    typedef void (*BlockHandler)(const BlockOp& op);
+    struct BlockOp {
+        BlockHandler run;           // manejador de la instrucción
+        uint8_t* reg;               // registro de 8 bits destino (o único)
+        union {
+            uint8_t* src;           // registro de 8 bits origen
+            RegisterPair* pair;     // o par de registros
+        };
+        uint16_t next;              // PC durante la instrucción
+        uint16_t nn;                // operando inmediato o destino del salto
+        uint8_t tstates;            // T-estados de M1 y operandos
+        uint8_t flags;              // BLOCK_BUS, BLOCK_LAST
+        uint8_t opCode;             // para el manejador genérico
+    };
+    enum BlockKind {
+        BLOCK_NOP, BLOCK_LD_R_R, BLOCK_LD_R_N, BLOCK_LD_RR_NN, BLOCK_LD_R_HL,
+        BLOCK_LD_HL_R, BLOCK_INC_R, BLOCK_DEC_R, BLOCK_INC_RR, BLOCK_DEC_RR,
+        BLOCK_ADD_HL_RR, BLOCK_ALU_R, BLOCK_ALU_N, BLOCK_ALU_HL, BLOCK_JR,
+        BLOCK_JR_CC, BLOCK_DJNZ, BLOCK_JP, BLOCK_JP_CC, BLOCK_CALL,
+        BLOCK_CALL_CC, BLOCK_RET, BLOCK_RET_CC, BLOCK_PUSH, BLOCK_PUSH_AF,
+        BLOCK_POP, BLOCK_POP_AF, BLOCK_RST, BLOCK_GENERIC
+    };
+    // Flags de BlockOp: pasa por Z80Ops (hay que poner el reloj al día
+    // antes) y última instrucción del bloque
+    const static uint8_t BLOCK_BUS = 0x01;
+    const static uint8_t BLOCK_LAST = 0x02;
+    // Valores de blockIndex que no son un bloque
+    const static int32_t BLOCK_UNKNOWN = -1;
+    const static int32_t BLOCK_NEVER = -2;
+    static MACHINE_STATE bool blockCacheEnabled;
+    // Instrucciones traducidas y primera instrucción del bloque de cada PC
+    static MACHINE_STATE BlockOp* blockPool;
+    static MACHINE_STATE uint32_t blockPoolUsed;
+    static MACHINE_STATE BlockEntry* blockIndex;
+    // Páginas de 256 bytes con código traducido
+    static MACHINE_STATE uint8_t blockCodePage[256];
+    // Invalidaciones de cada página desde el último flushBlocks
+    static MACHINE_STATE uint8_t blockPageInvalidations[256];
+    // Cambia con cada invalidación, para salir del bloque en curso
+    static MACHINE_STATE uint32_t blockGeneration;
+    static bool runBlock(uint32_t deadline);
+    static int32_t translateBlock(uint16_t address);
+    static uint8_t translateOp(uint16_t address, BlockOp& op);
+    template <int KIND, int SUB> static void blockRun(const BlockOp& op);
+    template <int CC> static inline bool blockCondition(void);
+    template <int ALU> static inline void blockAlu(uint8_t value);
 #endif
     static void copyToRegister(uint8_t opCode, uint8_t value);
 
@@ -280,8 +445,8 @@ public:
 
     // Acceso a registros de 16 bits
     // Access to registers pairs
-    static uint16_t getRegAF(void) { return (regA << 8) | (carryFlag ? sz5h3pnFlags | CARRY_MASK : sz5h3pnFlags); }
-    static void setRegAF(uint16_t word) { regA = word >> 8; sz5h3pnFlags = word & 0xfe; carryFlag = (word & CARRY_MASK) != 0; }
+    static uint16_t getRegAF(void) { syncFlags(); return (regA << 8) | (carryFlag ? sz5h3pnFlags | CARRY_MASK : sz5h3pnFlags); }
+    static void setRegAF(uint16_t word) { syncFlags(); regA = word >> 8; sz5h3pnFlags = word & 0xfe; carryFlag = (word & CARRY_MASK) != 0; }
 
     static uint16_t getRegAFx(void) { return REG_AFx; }
     static void setRegAFx(uint16_t word) { REG_AFx = word; }
@@ -331,36 +496,51 @@ public:
 
     // Acceso a los flags uno a uno
     // Access to single flags from F register
-    static bool isCarryFlag(void) { return carryFlag; }
-    static void setCarryFlag(bool state) { carryFlag = state; }
+    static bool isCarryFlag(void) {
+#ifdef Z80_LAZY_FLAGS
+        if (lazyFlags >= LAZY_AND) return lazyRes > 0xff;
+#endif
+        return carryFlag;
+    }
+    static void setCarryFlag(bool state) { syncFlags(); carryFlag = state; }
 
-    static bool isAddSubFlag(void) { return (sz5h3pnFlags & ADDSUB_MASK) != 0; }
+    static bool isAddSubFlag(void) { syncFlags(); return (sz5h3pnFlags & ADDSUB_MASK) != 0; }
     static void setAddSubFlag(bool state);
 
-    static bool isParOverFlag(void) { return (sz5h3pnFlags & PARITY_MASK) != 0; }
+    static bool isParOverFlag(void) { syncFlags(); return (sz5h3pnFlags & PARITY_MASK) != 0; }
     static void setParOverFlag(bool state);
 
     /* Undocumented flag */
-    static bool isBit3Flag(void) { return (sz5h3pnFlags & BIT3_MASK) != 0; }
+    static bool isBit3Flag(void) { syncFlags(); return (sz5h3pnFlags & BIT3_MASK) != 0; }
     static void setBit3Fag(bool state);
 
-    static bool isHalfCarryFlag(void) { return (sz5h3pnFlags & HALFCARRY_MASK) != 0; }
+    static bool isHalfCarryFlag(void) { syncFlags(); return (sz5h3pnFlags & HALFCARRY_MASK) != 0; }
     static void setHalfCarryFlag(bool state);
 
     /* Undocumented flag */
-    static bool isBit5Flag(void) { return (sz5h3pnFlags & BIT5_MASK) != 0; }
+    static bool isBit5Flag(void) { syncFlags(); return (sz5h3pnFlags & BIT5_MASK) != 0; }
     static void setBit5Flag(bool state);
 
-    static bool isZeroFlag(void) { return (sz5h3pnFlags & ZERO_MASK) != 0; }
+    static bool isZeroFlag(void) {
+#ifdef Z80_LAZY_FLAGS
+        if (lazyFlags != LAZY_NONE) return (lazyRes & 0xff) == 0;
+#endif
+        return (sz5h3pnFlags & ZERO_MASK) != 0;
+    }
     static void setZeroFlag(bool state);
 
-    static bool isSignFlag(void) { return sz5h3pnFlags >= SIGN_MASK; }
+    static bool isSignFlag(void) {
+#ifdef Z80_LAZY_FLAGS
+        if (lazyFlags != LAZY_NONE) return (lazyRes & SIGN_MASK) != 0;
+#endif
+        return sz5h3pnFlags >= SIGN_MASK;
+    }
     static void setSignFlag(bool state);
 
     // Acceso a los flags F
     // Access to F register
-    static uint8_t getFlags(void) { return carryFlag ? sz5h3pnFlags | CARRY_MASK : sz5h3pnFlags; }
-    static void setFlags(uint8_t regF) { sz5h3pnFlags = regF & 0xfe; carryFlag = (regF & CARRY_MASK) != 0; }
+    static uint8_t getFlags(void) { syncFlags(); return carryFlag ? sz5h3pnFlags | CARRY_MASK : sz5h3pnFlags; }
+    static void setFlags(uint8_t regF) { syncFlags(); sz5h3pnFlags = regF & 0xfe; carryFlag = (regF & CARRY_MASK) != 0; }
 
     // Acceso a los flip-flops de interrupción
     // Interrupt flip-flops
@@ -376,6 +556,11 @@ public:
     // /NMI is negative level triggered.
     static void triggerNMI(void) { activeNMI = true; }
 
+    // /INT stays active until the CPU accepts the interrupt
+    static bool isINT(void) { return activeINT; }
+    static void setINT(bool intr) { activeINT = intr; }
+    static void triggerINT(void) { activeINT = true; }
+
     //Acceso al modo de interrupción
     // Maskable interrupt mode
     static IntMode getIM(void) { return modeINT; }
@@ -384,6 +569,10 @@ public:
     static bool isHalted(void) { return halted; }
     static void setHalted(bool state) { halted = state; }
 
+    // Avanza 'count' ciclos M1 de un HALT sin ejecutarlos: mismo efecto en
+    // R y en los flags Q/EI que volver a decodificar el HALT 'count' veces
+    static void skipHalt(uint32_t count) { regR += count; flagQ = lastFlagQ = pendingEI = false; }
+
     // Reset requested by /RESET signal (not power-on)
     static void setPinReset(void) { pinReset = true; }
 
@@ -393,18 +582,63 @@ public:
     // Reset
     static void reset(void);
 
-    // Execute one instruction
-    static void execute(void);
+    // Execute one instruction. A DD/ED/FD prefix chain is followed while
+    // the machine clock is below 'deadline', else it returns in between
+    // with the prefix pending (the default, after every prefix)
+    static void execute(uint32_t deadline = 0);
+
+    // Execute instructions until the machine clock reaches 'deadline'
+    // (T-states in current frame) or the CPU enters a HALT
+    static void executeUntil(uint32_t deadline);
 
 #ifdef WITH_BREAKPOINT_SUPPORT
     static bool isBreakpoint(void) { return breakpointEnabled; }
     static void setBreakpoint(bool state) { breakpointEnabled = state; }
 #endif
 
+#ifdef INSTR_TRACE
+    static bool isTrace(void) { return traceEnabled; }
+    static void setTrace(bool state) { traceEnabled = state; }
+#endif
+
 #ifdef WITH_EXEC_DONE
     static void setExecDone(bool status) { execDone = status; }
 #endif
 
+#if defined(ROM_HLE) && !defined(Z80_CORE_VARIANT)
+    // Hand the instructions at 'address' (ROM, below 0x4000) to
+    // Z80Ops::romRoutine. Looked up per 256 byte page, so the callback also
+    // gets every other address of the page
+    static void setRomHook(uint16_t address) { romHookPage[(address >> 8) & 0x3f] = 1; }
+#endif
+
+#if defined(Z80_BLOCK_CACHE) && !defined(Z80_CORE_VARIANT)
+    // Run translated blocks in executeUntil (allocates the cache when first set)
+    static bool isBlockCache(void) { return blockCacheEnabled; }
+    static void setBlockCache(bool state);
+    // Machine memory writes must come through here: only a table lookup
+    // unless the written page holds translated code
+    static void codeWritten(uint16_t address) {
+        if (blockCodePage[address >> 8]) invalidateBlocks(address >> 8);
+    }
+    // Drop the translations of one 256 byte page, or all of them (after
+    // paging changes or memory loaded behind the core's back)
+    static void invalidateBlocks(uint8_t page);
+    static void flushBlocks(void);
+#endif
+
+#ifdef Z80_PROFILER
+    // Clear all profiler counters
+    static void profileReset(void);
+    // Dump non-zero counters as CSV: table,opcode,count,tstates,cycles
+    static void profileDump(FILE* out);
+#endif
+
+#ifdef Z80_TABLES_BENCHMARK
+    // Time flag table lookups from flash and from DRAM, print to stdout
+    static void benchmarkTables(void);
+#endif
+
 private:
     // Rota a la izquierda el valor del argumento
     static inline void rlc(uint8_t &oper8);
@@ -508,6 +742,9 @@ private:
     // OUTD
     static void outd(void);
 
+    // Repetición en bloque de LDIR/CPIR/INIR/OTIR/LDDR/CPDR/INDR/OTDR
+    static bool repeatBlock(uint8_t blockOpcode);
+
     // BIT n,r
     static inline void bitTest(uint8_t mask, uint8_t reg);
 
@@ -537,4 +774,8 @@ private:
     static void decodeED(uint8_t opCode);
 };
 
-#endif // Z80CPP_H
+#ifndef Z80_CORE_VARIANT
+typedef Z80 Z80State;
+#endif
+
+#endif // Z80CPP_CLASS_H / Z80CPP_VARIANT_H
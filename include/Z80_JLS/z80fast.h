@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// z80cpp - Z80 emulator core
+//
+// Copyright (c) 2017, 2018, 2019, 2020 jsanchezv - https://github.com/jsanchezv
+//
+// Heretic optimizations and minor adaptations
+// Copyright (c) 2021 dcrespo3d - https://github.com/dcrespo3d
+//
+
+// Fast core classes: Z80Fast (built in Z80_Fast.cpp) and its callbacks,
+// Z80OpsFast, to be defined by the machine next to Z80Ops.
+
+#ifndef Z80FAST_H
+#define Z80FAST_H
+
+#include "z80.h"
+
+#define Z80_CORE_VARIANT
+#define Z80 Z80Fast
+#define Z80Ops Z80OpsFast
+#include "z80.h"
+#undef Z80
+#undef Z80Ops
+#undef Z80_CORE_VARIANT
+
+#endif // Z80FAST_H
@@ -8,8 +8,14 @@
 // Copyright (c) 2021 dcrespo3d - https://github.com/dcrespo3d
 //
 
-#ifndef Z80OPERATIONS_H
+// Declared once more, under another name, for every core variant (see z80.h)
+#if (!defined(Z80_CORE_VARIANT) && !defined(Z80OPERATIONS_H)) \
+    || (defined(Z80_CORE_VARIANT) && !defined(Z80OPERATIONS_VARIANT_H))
+#ifdef Z80_CORE_VARIANT
+#define Z80OPERATIONS_VARIANT_H
+#else
 #define Z80OPERATIONS_H
+#endif
 
 #include "../hardconfig.h"
 
@@ -42,12 +48,37 @@ public:
     /* Clocks needed for processing INT and NMI */
     static void interruptHandlingTime(int32_t wstates);
 
-    /* Callback to know when the INT signal is active */
-    static bool isActiveINT(void);
+    /* Callback to read the machine clock (T-states in current frame) */
+    static uint32_t getTstates(void);
+
+    /* Callback to know if a repeated block instruction (LDIR, CPIR...) can
+       run its next iteration without going back to the machine loop */
+    static bool isRepeatAllowed(void);
 
     /* Add tStates and do ALU_video and audio buffer capture */
     static void addTstates(int32_t tstatestoadd, bool dovideo);
 
+#if defined(Z80_BLOCK_CACHE) && !defined(Z80_CORE_VARIANT)
+    /* Block cache: can code at 'address' run from translated blocks?
+       (plain memory, not contended, opcode fetch with no side effects) */
+    static bool isCacheable(uint16_t address);
+
+    /* Block cache: read a code byte, no T-states nor side effects */
+    static uint8_t peekCode(uint16_t address);
+#endif
+
+#if defined(ROM_HLE) && !defined(Z80_CORE_VARIANT)
+    /* ROM routine at 'address' (registered with Z80::setRomHook) done
+       natively up to an instruction boundary: registers and clock updated.
+       Must end on a jump or any other instruction leaving the flags alone */
+    static bool romRoutine(uint16_t address);
+#endif
+
+#ifdef INSTR_TRACE
+    /* Callback before every instruction while tracing is enabled */
+    static void traceInstruction(uint16_t address);
+#endif
+
 };
 
-#endif // Z80OPERATIONS_H
+#endif // Z80OPERATIONS_H / Z80OPERATIONS_VARIANT_H
@@ -237,6 +237,236 @@
 //#define TAPE_TRAPS
 ///////////////////////////////////////////////////////////////////////////////
 
+///////////////////////////////////////////////////////////////////////////////
+// ROM high level emulation
+//
+// define ROM_HLE to skip the CPU bound delay loops of the 48K ROM natively:
+// the BEEPER half period loop and the DJNZ delays of SAVE and LD-BYTES.
+// Registers, R, MEMPTR and T-states end exactly as if the loops had run, and
+// the OUTs to the beeper are still executed by the core, so sound, border
+// and timing don't change. The code is checked byte by byte before each
+// skip, so other ROMs or RAM paged at those addresses run as usual.
+
+// #define ROM_HLE
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Adaptive RAM bank placement (boards with PSRAM)
+//
+// define RAM_MIGRATION to move the busiest RAM banks into internal SRAM.
+// One of every RAM_MIGRATION_SAMPLE memory reads and writes (prime, so
+// loops don't fall in step with it) is counted for the bank it hits, and
+// every RAM_MIGRATION_FRAMES frames the busiest bank in PSRAM swaps places
+// with the idlest one in SRAM, if used at least twice as much. The number
+// of banks in SRAM, the budget, is what setup could allocate there.
+
+// #define RAM_MIGRATION
+#define RAM_MIGRATION_FRAMES 50
+#define RAM_MIGRATION_SAMPLE 61
+
+#if defined(RAM_MIGRATION) && !defined(BOARD_HAS_PSRAM)
+#undef RAM_MIGRATION
+#endif
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Compressed RAM bank store (boards without PSRAM)
+//
+// define BANK_STORE to run 128K machines without PSRAM. Banks 2 and 5, and
+// BANK_STORE_FRAMES more (3 to 6: the bank paged in at 0xC000, the shadow
+// screen and one being loaded or saved), are kept in SRAM. When port 0x7FFD
+// pages in a bank which isn't there, the least recently used one is RLE
+// compressed into a BANK_STORE_POOL bytes pool, reserved at startup, to
+// make room for it. Only if the pool is full it goes into the heap, and if
+// that fails too the emulator stops with an error rather than lose a bank.
+// ROM 1 gets allocated too.
+
+// #define BANK_STORE
+#define BANK_STORE_FRAMES 3
+#define BANK_STORE_POOL 0x6000
+
+#if defined(BANK_STORE) && defined(BOARD_HAS_PSRAM)
+#undef BANK_STORE
+#endif
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Z80 dispatch engine
+//
+// define Z80_THREADED_DISPATCH to decode instructions with computed-goto
+// threading (one label table per prefix: base, CB, ED, DD/FD, DDCB/FDCB)
+// instead of the classic switch statements. Both engines share the same
+// instruction bodies and produce exactly the same T-state counts.
+//
+// Off until measured on an ESP32: build with LOG_DEBUG_TIMING, once with
+// and once without it, and compare the "[CPU] ... MHz emulated" lines
+// (T-states per microsecond spent in CPU::loop, HALT skips included) on
+// the same program. On an x86 host (tools/z80test rom, g++ -O2) the two
+// are within run-to-run noise of each other, about 400-580 MHz.
+
+// #define Z80_THREADED_DISPATCH
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Fast Z80 core
+//
+// define Z80_FAST_CORE to build the Z80 core a second time (Z80Fast) with
+// cheaper timing callbacks: contention only on opcode fetches, and no
+// video update on every memory access; the renderer catches up at each of
+// its events (border lines, line start and end) drawing from memory as it
+// is then. Both cores share the registers and can be swapped between
+// frames. The core is chosen per snapshot from the main menu (F1).
+
+// #define Z80_FAST_CORE
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Z80 block cache (host builds, or ROM_PREDECODE below)
+//
+// define Z80_BLOCK_CACHE (usually on the compiler command line, e.g. for
+// tools/z80test) to let Z80::executeUntil run basic blocks translated once
+// into lists of pre-decoded instructions, each with its own handler. The
+// machine must provide Z80Ops::isCacheable() and Z80Ops::peekCode(), call
+// Z80::codeWritten() on memory writes, and Z80::flushBlocks() on paging
+// changes. Code that is contended, does I/O, uses DD/ED/FD prefixes or
+// enables interrupts still runs through the interpreter.
+
+// #define Z80_BLOCK_CACHE
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// ROM predecode cache
+//
+// define ROM_PREDECODE to use the block cache above on the device for the
+// ROM only: ROM routines are decoded once into handler, operands and
+// T-states per instruction and then dispatched from there. ROM is never
+// contended nor written, so the only invalidation is a flush when another
+// ROM (or +2A/+3 all-RAM mode) is paged in; plain bank switches keep it.
+// Takes ROM_PREDECODE_OPS * 20 bytes plus 32K of index from the heap.
+// Instructions in ROM_HLE pages still go to RomHLE, and GUEST_PROFILER or
+// MEM_HEATMAP turn it off, as they need every opcode fetch. Unused with
+// TAPE_TRAPS, which runs the precise core one instruction at a time.
+// Check it on the host with tools/z80test (rom mode, -DROM_PREDECODE).
+
+// #define ROM_PREDECODE
+#define ROM_PREDECODE_OPS 2048
+
+#ifdef ROM_PREDECODE
+#define Z80_BLOCK_CACHE
+#define BLOCK_CACHE_LIMIT 0x4000
+#define BLOCK_POOL_SIZE ROM_PREDECODE_OPS
+#endif
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Z80 lazy flags
+//
+// define Z80_LAZY_FLAGS to let 8 bit ALU instructions (ADD, ADC, SUB, SBC,
+// CP, AND, OR, XOR, INC, DEC) store just the operation and its operands.
+// F is only computed when it is read: conditional jumps test Z, C and S
+// straight from the stored result, anything else (PUSH AF, BIT, DAA, ...)
+// materializes the whole register first. Undocumented bits 3/5 and Q
+// behave exactly as with immediate flags.
+
+// #define Z80_LAZY_FLAGS
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Breakpoints and watchpoints
+//
+// define WITH_BREAKPOINT_SUPPORT to get exec breakpoints and memory read,
+// write and I/O port watchpoints, kept as per-address bitmaps (allocated
+// when first used) and managed through serial commands (send 'h' for
+// help). A hit stops the emulation at a serial prompt. With nothing armed
+// each memory or port access only tests one flag byte.
+
+// #define WITH_BREAKPOINT_SUPPORT
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Z80 flag tables placement
+//
+// The Z80 core flag tables (sz53/parity and a full DAA result table, 5KB)
+// are generated at compile time and, being const, live in flash and are
+// read through the flash cache, leaving that DRAM free.
+// define Z80_TABLES_IN_DRAM to place them in internal DRAM instead.
+// define Z80_TABLES_BENCHMARK to time lookups from the tables and from a
+// DRAM copy at startup and print both over Serial.
+
+// #define Z80_TABLES_IN_DRAM
+// #define Z80_TABLES_BENCHMARK
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Z80 opcode profiler
+//
+// define Z80_PROFILER to count executions, emulated T-states and host CPU
+// cycles for every opcode of every decoder table (base, CB, ED, DD, FD,
+// DDCB). F11 dumps the counters as CSV over Serial, F12 writes them to
+// DISK_PROFILE_FILE and clears them. Costs nothing when not defined.
+
+// #define Z80_PROFILER
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Guest PC hotspot sampler and code coverage
+//
+// define GUEST_PROFILER to sample the guest PC, together with the ROM/RAM
+// page it runs from, at the end of every frame into a histogram of
+// (1 << GUEST_PROFILER_BUCKET_BITS) byte buckets, and to keep a bitmap of
+// every address fetched as an opcode in every page. If GUEST_PROFILER_EVERY
+// is not 0, the PC is also sampled every that many opcode fetches.
+// F8 opens a menu to report over Serial or save to disk.
+
+// #define GUEST_PROFILER
+#define GUEST_PROFILER_BUCKET_BITS 5
+#define GUEST_PROFILER_EVERY 0
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Memory access heatmap
+//
+// define MEM_HEATMAP to count reads, writes and opcode fetches of every 256
+// byte block of each ROM and RAM page (a counter increment per access, so
+// it slows emulation down). Print Screen opens a menu to print it over
+// Serial as CSV or as a character map, which also marks the code blocks
+// written to (self-modifying code), or to see a bar chart per page.
+
+// #define MEM_HEATMAP
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Instruction trace
+//
+// define INSTR_TRACE to record PC, opcode bytes, paging state and T-state of
+// every instruction into a ring of INSTR_TRACE_BLOCKS blocks of 256 bytes,
+// delta encoded (3 to 4 bytes per instruction, about 70 per block).
+// Scroll Lock prints it over Serial, as does the debugger ('t' command and
+// every breakpoint or watchpoint hit, last INSTR_TRACE_DUMP_LAST entries).
+// Executing from INSTR_TRACE_CRASH_LO..HI (screen memory by default) is
+// taken as a crash and dumps it once. Nothing is recorded when undefined.
+
+// #define INSTR_TRACE
+#define INSTR_TRACE_BLOCKS 32
+#define INSTR_TRACE_DUMP_LAST 64
+#define INSTR_TRACE_CRASH_LO 0x4000
+#define INSTR_TRACE_CRASH_HI 0x5AFF
+///////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// Machine state storage
+//
+// All emulated machine state (Z80, Mem, Ports, CPU/ULA, AySound, Tape...)
+// is declared MACHINE_STATE (see Machine.h). On the ESP32 that is a plain
+// static: one machine, zero cost. Host builds running many machines in
+// parallel define MACHINE_PER_THREAD (on the compiler command line, never
+// here) to get one independent machine per thread, driven by the Machine
+// class in Machine.cpp (Z80, paging and keyboard only). tools/machinetest
+// runs several of them at once and checks they don't share any state.
+
+// #define MACHINE_PER_THREAD
+///////////////////////////////////////////////////////////////////////////////
+
 ///////////////////////////////////////////////////////////////////////////////
 // Snapshot loading behaviour
 //
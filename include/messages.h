@@ -30,6 +30,8 @@
 #ifndef ESPECTRUM_MESSAGES_h
 #define ESPECTRUM_MESSAGES_h
 
+#include "hardconfig.h"
+
 // General
 #define MSG_LOADING "Loading file"
 #define MSG_LOADING_SNA "Loading SNA file"
@@ -41,6 +43,17 @@
 #define MSG_FREE_HEAP_AFTER "Free heap after "
 #define MSG_Z80_RESET "Reseting Z80 CPU"
 #define MSG_EXEC_ON_CORE "Executing on core #"
+#define DBG_HELP \
+    "b|r|w|i|o <addr>   set exec breakpoint / read, write, in, out watchpoint\n"\
+    "d b|r|w|i|o <addr> delete, d * deletes all\n"\
+    "l                  list\n"\
+    "p                  break now\n"\
+    "s                  step one instruction\n"\
+    "c                  continue\n"\
+    "x                  registers\n"\
+    "m <addr> [len]     dump memory\n"\
+    "t [n]              last n traced instructions (INSTR_TRACE)\n"\
+    "(addr, len in hex, n in decimal)\n"
 #define ULA_ON "ULA ON"
 #define ULA_OFF "ULA OFF"
 
@@ -52,6 +65,7 @@
 #define ERROR_BOTTOM "  Sir Clive is smoking in the Rolls...  "
 #define ERR_READ_FILE "Cannot read file!"
 #define ERR_BANK_FAIL "Failed to allocate RAM bank"
+#define ERR_BANK_STORE_FULL "Out of memory for 128K RAM banks"
 #define ERR_FS_INT_FAIL "Cannot mount internal storage!"
 #define ERR_FS_EXT_FAIL "Cannot mount external storage!"
 #define ERR_DIR_OPEN "Cannot open directory!"
@@ -82,6 +96,9 @@
 #define OSD_PSNA_LOAD_ERR "ERROR Loading Persist Snapshot"
 #define OSD_PSNA_SAVED "Persist Snapshot Saved"
 
+#define OSD_GPROF_SAVED "Guest Profile Saved"
+#define OSD_GPROF_SAVE_ERR "ERROR Saving Guest Profile"
+
 #define OSD_TAPE_LOAD_ERR "ERROR Loading TAP file"
 #define OSD_TAPE_SELECT_ERR "Please select TAP file first"
 
@@ -104,7 +121,21 @@
     "Aspect Ratio...\n"\
     "Reset\n"\
     "About...\n"\
+    MENU_MAIN_CORE\
     "Return\n"
+#ifdef Z80_FAST_CORE
+#define MENU_MAIN_CORE "CPU Core...\n"
+#else
+#define MENU_MAIN_CORE ""
+#endif
+#define MENU_CORE_PRECISE \
+    "CPU Core\n"\
+    "Precise (current)\n"\
+    "Fast\n"
+#define MENU_CORE_FAST \
+    "CPU Core\n"\
+    "Precise\n"\
+    "Fast (current)\n"
 #define MENU_ASPECT_169 \
     "Aspect Ratio\n"\
     "16:9 (current)\n"\
@@ -130,6 +161,19 @@
     "Persist Save\n" MENU_PERSIST
 #define MENU_PERSIST_LOAD \
     "Persist Load\n" MENU_PERSIST    
+#define MENU_GUEST_PROF \
+    "Guest Profiler\n"\
+    "Report to Serial\n"\
+    "Save to disk\n"\
+    "Clear\n"\
+    "Cancel\n"
+#define MENU_MEM_HEATMAP \
+    "Memory Heatmap\n"\
+    "CSV to Serial\n"\
+    "Map to Serial\n"\
+    "Chart\n"\
+    "Clear\n"\
+    "Cancel\n"
 #define MENU_DEMO "Demo mode\nOFF\n 1 minute\n 3 minutes\n 5 minutes\n15 minutes\n30 minutes\n 1 hour\n"
 #define MENU_ARCH "Select Arch\n"
 #define MENU_ROMSET "Select Rom Set\n"
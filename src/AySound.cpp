@@ -37,29 +37,29 @@
 
 //static SoundGenerator _soundGenerator;
 
-SquareWaveformGenerator AySound::_channel[3];
+MACHINE_STATE SquareWaveformGenerator AySound::_channel[3];
 
 // Registers
-uint8_t AySound::finePitchChannelA = 0xFF;
-uint8_t AySound::coarsePitchChannelA = 0xFF;
-uint8_t AySound::finePitchChannelB = 0xFF;
-uint8_t AySound::coarsePitchChannelB = 0xFF;
-uint8_t AySound::finePitchChannelC = 0xFF;
-uint8_t AySound::coarsePitchChannelC = 0xFF;
-uint8_t AySound::noisePitch = 0xFF;
-uint8_t AySound::mixer = 0xFF;
-uint8_t AySound::volumeChannelA = 0xFF;
-uint8_t AySound::volumeChannelB = 0xFF;
-uint8_t AySound::volumeChannelC = 0xFF;
-uint8_t AySound::envelopeFineDuration = 0xFF;
-uint8_t AySound::envelopeCoarseDuration = 0xFF;
-uint8_t AySound::envelopeShape = 0xFF;
-uint8_t AySound::ioPortA = 0xFF;
+MACHINE_STATE uint8_t AySound::finePitchChannelA = 0xFF;
+MACHINE_STATE uint8_t AySound::coarsePitchChannelA = 0xFF;
+MACHINE_STATE uint8_t AySound::finePitchChannelB = 0xFF;
+MACHINE_STATE uint8_t AySound::coarsePitchChannelB = 0xFF;
+MACHINE_STATE uint8_t AySound::finePitchChannelC = 0xFF;
+MACHINE_STATE uint8_t AySound::coarsePitchChannelC = 0xFF;
+MACHINE_STATE uint8_t AySound::noisePitch = 0xFF;
+MACHINE_STATE uint8_t AySound::mixer = 0xFF;
+MACHINE_STATE uint8_t AySound::volumeChannelA = 0xFF;
+MACHINE_STATE uint8_t AySound::volumeChannelB = 0xFF;
+MACHINE_STATE uint8_t AySound::volumeChannelC = 0xFF;
+MACHINE_STATE uint8_t AySound::envelopeFineDuration = 0xFF;
+MACHINE_STATE uint8_t AySound::envelopeCoarseDuration = 0xFF;
+MACHINE_STATE uint8_t AySound::envelopeShape = 0xFF;
+MACHINE_STATE uint8_t AySound::ioPortA = 0xFF;
 
 // Status
-uint8_t AySound::selectedRegister = 0xFF;
-uint8_t AySound::channelVolume[3] = { 0xFF, 0xFF, 0xFF };
-uint16_t AySound::channelFrequency[3] = { 0xFFFF, 0xFFFF, 0xFFFF };
+MACHINE_STATE uint8_t AySound::selectedRegister = 0xFF;
+MACHINE_STATE uint8_t AySound::channelVolume[3] = { 0xFF, 0xFF, 0xFF };
+MACHINE_STATE uint16_t AySound::channelFrequency[3] = { 0xFFFF, 0xFFFF, 0xFFFF };
 
 const unsigned char volume[] = {
 	0, 8, 17, 25, 34, 42, 51, 59, 68, 76, 85, 93, 102, 110, 119, 127
@@ -0,0 +1,274 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef BANK_STORE
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+#include "BankStore.h"
+#include "Mem.h"
+#include "osd.h"
+#include "messages.h"
+
+MACHINE_STATE uint8_t* BankStore::packed[8];
+MACHINE_STATE uint16_t BankStore::packedSize[8];
+MACHINE_STATE bool BankStore::pinned[8];
+MACHINE_STATE uint32_t BankStore::lastUse[8];
+MACHINE_STATE uint32_t BankStore::useClock = 0;
+MACHINE_STATE uint8_t* BankStore::pool = NULL;
+MACHINE_STATE uint32_t BankStore::poolSize = 0;
+MACHINE_STATE uint32_t BankStore::poolUsed = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// RLE, PackBits style: 0x00-0x7F, that many plus 1 bytes follow as they
+// are; 0x80-0xFF, the next byte repeated that many minus 0x80 plus 3 times.
+// Free banks, mostly zeros, take a couple hundred bytes.
+//
+
+#define RLE_MAX_LITERAL 128
+#define RLE_MIN_RUN 3
+#define RLE_MAX_RUN (0x7F + RLE_MIN_RUN)
+
+// dst NULL only counts
+static uint32_t packLiterals(const uint8_t* src, uint32_t count, uint8_t* dst, uint32_t out)
+{
+    while (count > 0) {
+        uint32_t n = count > RLE_MAX_LITERAL ? RLE_MAX_LITERAL : count;
+        if (dst != NULL) {
+            dst[out] = n - 1;
+            memcpy(dst + out + 1, src, n);
+        }
+        out += n + 1;
+        src += n;
+        count -= n;
+    }
+    return out;
+}
+
+static uint32_t pack(const uint8_t* src, uint8_t* dst)
+{
+    uint32_t out = 0, literals = 0, i = 0;
+
+    while (i < MEM_PG_SZ) {
+        uint32_t run = 1;
+        while (i + run < MEM_PG_SZ && run < RLE_MAX_RUN && src[i + run] == src[i]) run++;
+
+        if (run < RLE_MIN_RUN) {
+            i += run;
+            continue;
+        }
+
+        out = packLiterals(src + literals, i - literals, dst, out);
+        if (dst != NULL) {
+            dst[out] = 0x80 + run - RLE_MIN_RUN;
+            dst[out + 1] = src[i];
+        }
+        out += 2;
+        i += run;
+        literals = i;
+    }
+
+    return packLiterals(src + literals, i - literals, dst, out);
+}
+
+static void unpack(const uint8_t* src, uint8_t* dst)
+{
+    uint8_t* end = dst + MEM_PG_SZ;
+
+    while (dst < end) {
+        uint8_t code = *src++;
+        if (code < 0x80) {
+            memcpy(dst, src, code + 1);
+            src += code + 1;
+            dst += code + 1;
+        } else {
+            memset(dst, *src++, code - 0x80 + RLE_MIN_RUN);
+            dst += code - 0x80 + RLE_MIN_RUN;
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+void BankStore::setup()
+{
+    static const uint8_t shared[] = { 0, 7, 1, 3, 4, 6 };
+    static_assert(BANK_STORE_FRAMES >= 3 && BANK_STORE_FRAMES <= sizeof(shared),
+        "BANK_STORE_FRAMES must be 3 to 6");
+
+    for (int bank = 0; bank < 8; bank++) {
+        packed[bank] = NULL;
+        packedSize[bank] = 0;
+        pinned[bank] = false;
+        lastUse[bank] = 0;
+    }
+
+    // bank 0 page comes from the 48K allocation
+    for (int i = 1; i < (int)sizeof(shared); i++) {
+        uint8_t* page = NULL;
+        if (i < BANK_STORE_FRAMES) {
+            page = (uint8_t*)calloc(1, MEM_PG_SZ);
+            if (page == NULL)
+                Serial.printf("ERROR: unable to allocate bank store page %d\n", i);
+        }
+        Mem::setRam(shared[i], page);
+    }
+
+    pool = (uint8_t*)malloc(BANK_STORE_POOL);
+    poolSize = pool != NULL ? BANK_STORE_POOL : 0;
+    poolUsed = 0;
+    if (pool == NULL)
+        Serial.printf("ERROR: unable to allocate bank store pool\n");
+
+    Serial.printf("Bank store: %d shared pages, %d bytes pool, free heap %d\n",
+        BANK_STORE_FRAMES, poolSize, ESP.getFreeHeap());
+}
+
+void BankStore::map()
+{
+    for (int bank = 0; bank < 8; bank++)
+        pinned[bank] = false;
+
+    fetch(Mem::bankLatch);
+    if (Mem::videoLatch) fetch(7);
+}
+
+uint8_t* BankStore::get(uint8_t bank)
+{
+    map();
+    return fetch(bank);
+}
+
+bool BankStore::inPool(const uint8_t* blob)
+{
+    return blob >= pool && blob < pool + poolSize;
+}
+
+// forget the compressed copy of bank, closing the gap it leaves in the pool
+void BankStore::release(uint8_t bank)
+{
+    uint8_t* blob = packed[bank];
+    if (blob == NULL) return;
+
+    if (inPool(blob)) {
+        uint32_t size = packedSize[bank];
+        memmove(blob, blob + size, pool + poolUsed - (blob + size));
+        poolUsed -= size;
+        for (int b = 0; b < 8; b++)
+            if (packed[b] > blob && inPool(packed[b])) packed[b] -= size;
+    } else {
+        free(blob);
+    }
+
+    packed[bank] = NULL;
+    packedSize[bank] = 0;
+}
+
+// compress bank into the pool, or if it doesn't fit and spill is set into
+// the heap. Its page is left to the caller
+bool BankStore::evict(uint8_t bank, bool spill)
+{
+    const uint8_t* page = Mem::ram[bank];
+    uint32_t size = pack(page, NULL);
+    uint8_t* blob;
+
+    if (size <= poolSize - poolUsed) {
+        blob = pool + poolUsed;
+        poolUsed += size;
+    } else if (spill && (blob = (uint8_t*)malloc(size)) != NULL) {
+        Serial.printf("Bank store pool full, RAM%d compressed into the heap\n", bank);
+    } else {
+        return false;
+    }
+
+    pack(page, blob);
+    packed[bank] = blob;
+    packedSize[bank] = size;
+    return true;
+}
+
+uint8_t* BankStore::fetch(uint8_t bank)
+{
+    lastUse[bank] = ++useClock;
+    pinned[bank] = true;
+
+    if (Mem::ram[bank] != NULL) return Mem::ram[bank];
+
+    // banks which may give their page up, least recently used first
+    uint8_t victims[8];
+    int count = 0;
+    for (int b = 0; b < 8; b++) {
+        if (b == 2 || b == 5 || pinned[b] || Mem::ram[b] == NULL) continue;
+        int i = count++;
+        while (i > 0 && lastUse[victims[i - 1]] > lastUse[b]) {
+            victims[i] = victims[i - 1];
+            i--;
+        }
+        victims[i] = b;
+    }
+    if (count == 0) {
+        // can't happen with BANK_STORE_FRAMES >= 3 (2 paged in, 1 got)
+        Serial.printf("ERROR: bank store pages all pinned, fetching RAM%d\n", bank);
+        return Mem::ram[Mem::bankLatch];
+    }
+
+    // the oldest one fitting in the pool, else the oldest one into the
+    // heap. With no memory left at all the machine stops: going on would
+    // mean losing a bank under the running program
+    int victim = -1;
+    for (int i = 0; i < count && victim < 0; i++)
+        if (evict(victims[i], false)) victim = victims[i];
+    if (victim < 0) {
+        victim = victims[0];
+        if (!evict(victim, true)) {
+            Serial.printf("ERROR: no memory to compress RAM%d, pool %d of %d bytes used\n",
+                victim, poolUsed, poolSize);
+            OSD::errorHalt(ERR_BANK_STORE_FULL);
+        }
+    }
+
+    uint8_t* page = Mem::ram[victim];
+    Mem::setRam(victim, NULL);
+
+    if (packed[bank] != NULL) {
+        unpack(packed[bank], page);
+        release(bank);
+    } else {
+        memset(page, 0, MEM_PG_SZ);
+    }
+    Mem::setRam(bank, page);
+
+    return page;
+}
+
+#endif // BANK_STORE
@@ -45,8 +45,37 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "Z80_JLS/z80.h"
-static bool createCalled = false;
-static bool interruptPending = false;
+
+#ifdef Z80_FAST_CORE
+#include "Z80_JLS/z80fast.h"
+#endif
+
+#ifdef GUEST_PROFILER
+#include "GuestProfiler.h"
+#endif
+
+#ifdef MEM_HEATMAP
+#include "MemHeatmap.h"
+#endif
+
+#ifdef WITH_BREAKPOINT_SUPPORT
+#include "Debugger.h"
+#endif
+
+#ifdef INSTR_TRACE
+#include "Trace.h"
+#endif
+
+#ifdef ROM_HLE
+#include "RomHLE.h"
+#endif
+
+#ifdef RAM_MIGRATION
+#include "RamPlacement.h"
+#endif
+
+static MACHINE_STATE bool createCalled = false;
+static MACHINE_STATE uint32_t statesInFrame = 69888;
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -69,17 +98,164 @@ uint32_t CPU::microsPerFrame()
 ///////////////////////////////////////////////////////////////////////////////
 
 #if (defined(LOG_DEBUG_TIMING) && defined(SHOW_FPS))
-uint32_t CPU::framecnt = 0;
+MACHINE_STATE uint32_t CPU::framecnt = 0;
 #endif
 
-uint32_t CPU::tstates = 0;
-uint64_t CPU::global_tstates = 0;
+MACHINE_STATE uint32_t CPU::tstates = 0;
+MACHINE_STATE uint64_t CPU::global_tstates = 0;
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Contention policies: which 16K slots the ULA contends on each machine,
+// given the current paging, and when. updateContentionFor<M>() is
+// instantiated once per policy and setupContention() picks one when the
+// machine changes, so the memory callbacks only look contendedSlot up
+// (ADDRESS_CONTENDED), and delayContention() a table built from M::timing.
+//
+
+// The ULA delays contended accesses during the first 128 T-states of each
+// of the 192 screen lines, with a pattern repeating every 8 T-states from
+// firstTstate, the first contended T-state of the frame.
+//
+// Renderer restriction: ALU_video draws every machine with the 48K layout,
+// 224 T-state lines (TSTATES_PER_LINE). Contention follows the real line
+// of each model, so on 128K, +2 and +2A/+3 (228 T-states) beam-timed
+// effects land up to 4 T-states a line away from where they are drawn.
+struct ContentionTiming {
+    uint16_t lineTstates;
+    uint32_t firstTstate;
+    uint16_t lines;
+    bool io;                // I/O contention (ULA port, contended high byte)
+    uint8_t pattern[8];
+};
+
+// 48K: 0x4000-0x7FFF
+struct Contention48K {
+    static inline uint8_t slot(uint8_t n) { return n == 1; }
+    static const ContentionTiming timing;
+};
+const ContentionTiming Contention48K::timing = { 224, 14335, 192, true, { 6, 5, 4, 3, 2, 1, 0, 0 } };
+
+// 128K / +2: 0x4000-0x7FFF, and 0xC000-0xFFFF when bank 1, 3, 5 or 7 is in
+struct Contention128K {
+    static inline uint8_t slot(uint8_t n) { return n == 1 || (n == 3 && (Mem::bankLatch & 1)); }
+    static const ContentionTiming timing;
+};
+const ContentionTiming Contention128K::timing = { 228, 14361, 192, true, { 6, 5, 4, 3, 2, 1, 0, 0 } };
+
+// +2A / +3: banks 4, 5, 6 and 7, wherever the special paging modes put
+// them. The gate array does not contend I/O.
+struct ContentionPlus3 {
+    static inline uint8_t slot(uint8_t n) {
+        if (Mem::modeSP3) return Mem::specialBanks[Mem::specialSP3][n] >= 4;
+        return n == 1 || (n == 3 && Mem::bankLatch >= 4);
+    }
+    static const ContentionTiming timing;
+};
+const ContentionTiming ContentionPlus3::timing = { 228, 14365, 192, false, { 1, 0, 7, 6, 5, 4, 3, 2 } };
+
+// Pentagon style clones: no contention at all. Picked for a "Pentagon"
+// arch, which Config doesn't offer yet.
+struct ContentionPentagon {
+    static inline uint8_t slot(uint8_t) { return 0; }
+    static const ContentionTiming timing;
+};
+const ContentionTiming ContentionPentagon::timing = { 224, 0, 0, false, { 0, 0, 0, 0, 0, 0, 0, 0 } };
+
+MACHINE_STATE uint8_t CPU::contendedSlot[4] = { 0, 1, 0, 0 };
+
+// Delays by T-state into a contended line, and the contended part of the
+// frame (from contFirst to contEnd)
+static MACHINE_STATE uint8_t contLine[228];
+static MACHINE_STATE uint16_t contLineTstates = 224;
+static MACHINE_STATE uint32_t contFirst = 14335;
+static MACHINE_STATE uint32_t contEnd = 14335 + 192 * 224;
+static MACHINE_STATE bool contIO = true;
+// Start of the line the last contended access fell in
+static MACHINE_STATE uint32_t contLineStart = 0;
+
+static void setupContentionTiming(const ContentionTiming& timing)
+{
+    for (int i = 0; i < 228; i++)
+        contLine[i] = i < 128 ? timing.pattern[i & 0x07] : 0;
+    contLineTstates = timing.lineTstates;
+    contFirst = timing.firstTstate;
+    contEnd = timing.firstTstate + timing.lines * timing.lineTstates;
+    contIO = timing.io;
+    contLineStart = contFirst;
+}
+
+template <class M> static void updateContentionFor()
+{
+    for (uint8_t n = 0; n < 4; n++)
+        CPU::contendedSlot[n] = M::slot(n);
+}
+
+static MACHINE_STATE void (*contentionUpdater)() = updateContentionFor<Contention48K>;
+
+template <class M> static void selectContention()
+{
+    contentionUpdater = updateContentionFor<M>;
+    setupContentionTiming(M::timing);
+}
+
+void CPU::setupContention()
+{
+    if (Config::getArch() == "48K")
+        selectContention<Contention48K>();
+    else if (Config::getArch() == "Pentagon")
+        selectContention<ContentionPentagon>();
+    else if (Mem::plus3Paging)
+        selectContention<ContentionPlus3>();
+    else
+        selectContention<Contention128K>();
+
+    updateContention();
+}
+
+void CPU::updateContention()
+{
+    contentionUpdater();
+}
+
+#ifdef Z80_FAST_CORE
+MACHINE_STATE uint8_t CPU::core = CPU_CORE_PRECISE;
+
+// Both cores share the Z80 registers, the switch is seen from next frame on
+void CPU::setCore(uint8_t newCore)
+{
+    if (newCore != core)
+        Serial.printf("CPU core: %s\n", newCore == CPU_CORE_FAST ? "fast" : "precise");
+    core = newCore;
+}
+
+static void fastRun();
+#endif
 
 void CPU::setup()
 {
     if (!createCalled)
     {
         Z80::create();
+        #ifdef Z80_TABLES_BENCHMARK
+        Z80::benchmarkTables();
+        #endif
+        #ifdef GUEST_PROFILER
+        GuestProfiler::setup();
+        #endif
+        #ifdef MEM_HEATMAP
+        MemHeatmap::setup();
+        #endif
+        #ifdef INSTR_TRACE
+        Trace::setup();
+        #endif
+        #ifdef ROM_HLE
+        RomHLE::setup();
+        #endif
+        #ifdef ROM_PREDECODE
+        Z80::setBlockCache(true);
+        Serial.printf("ROM predecode cache: %s\n", Z80::isBlockCache() ? "on" : "no memory, off");
+        #endif
         createCalled = true;
     }
 
@@ -91,16 +267,24 @@ void CPU::setup()
 void CPU::reset() {
 
     Z80::reset();
+    #ifdef ROM_PREDECODE
+    // ROMs may have been reloaded
+    Z80::flushBlocks();
+    #endif
     global_tstates = 0;
+    setupContention();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 
 void CPU::loop()
 {
-    uint32_t statesInFrame = statesPerFrame();
+    statesInFrame = statesPerFrame();
     tstates = 0;
 
+    // snapshot loaders may have paged memory in between frames
+    updateContention();
+
 	while (tstates < statesInFrame)
 	{
     
@@ -132,21 +316,61 @@ void CPU::loop()
             }
         #endif
 
-        // frame Tstates before instruction
-        uint32_t pre_tstates = tstates;
-    
-        Z80::execute();
+        if (Z80::isHalted() && !Z80::isNMI() && !(Z80::isINT() && Z80::isIFF1())
+            && !ADDRESS_CONTENDED(Z80::getRegPC())) {
+
+            // HALT fast-forward: no INT can be accepted before the frame
+            // ends, so skip the M1 refetches of the HALT in 4 T-state steps,
+            // stopping only where the video renderer has work to do.
+            // Steps land on the same instruction boundaries the core would
+            // produce, so drawing and frame overrun are exactly the same.
+            uint32_t haltCycles = 0;
+            while (tstates < statesInFrame) {
+                uint32_t target = ALU_video_nextEvent();
+                if (target > statesInFrame) target = statesInFrame;
+                uint32_t steps = target > tstates ? (target - tstates + 3) >> 2 : 1;
+                ALU_video(steps << 2);
+                haltCycles += steps;
+            }
+            Z80::skipHalt(haltCycles);
+
+        } else {
 
-        // increase global Tstates
-        global_tstates += (tstates - pre_tstates);
+            #ifdef Z80_FAST_CORE
+            if (core == CPU_CORE_FAST) {
+                fastRun();
+                continue;
+            }
+            #endif
+
+            #ifdef TAPE_TRAPS
+                // tape traps need a look at PC before every instruction
+                Z80::execute();
+            #else
+                // run until frame end; back here only when the CPU halts
+                Z80::executeUntil(statesInFrame);
+            #endif
+
+        }
 
 	}
 
+    // increase global Tstates
+    global_tstates += tstates;
+
     #if (defined(LOG_DEBUG_TIMING) && defined(SHOW_FPS))
     framecnt++;
     #endif
 
-    interruptPending = true;
+    #ifdef GUEST_PROFILER
+    GuestProfiler::sample();
+    #endif
+
+    #ifdef RAM_MIGRATION
+    RamPlacement::frameEnd();
+    #endif
+
+    Z80::triggerINT();
 
     // Flashing flag change
     if (halfsec) flashing ^= 0b10000000;
@@ -158,8 +382,9 @@ void CPU::loop()
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Delay Contention: for emulating CPU slowing due to sharing bus with ULA
-// NOTE: Only 48K spectrum contention implemented. This function must be called
-// only when dealing with affected memory (use ADDRESS_IN_LOW_RAM macro)
+// This function must be called only when dealing with affected memory (use
+// ADDRESS_CONTENDED macro). Timing comes from the machine's contention
+// policy (see setupContention).
 //
 // delay contention: emulates wait states introduced by the ULA (graphic chip)
 // whenever there is a memory access to contended memory (shared between ULA and CPU).
@@ -168,26 +393,22 @@ void CPU::loop()
 // if you only read from https://worldofspectrum.org/faq/reference/48kreference.htm#Contention
 // without reading the previous paragraphs about line timings, it may be confusing.
 //
-static unsigned char wait_states[8] = { 6, 5, 4, 3, 2, 1, 0, 0 }; // sequence of wait states
+// T-states only go forward inside a frame, so the line is followed from the
+// previous access instead of dividing: at most one step per line and frame.
+//
 static unsigned char IRAM_ATTR delayContention(unsigned int currentTstates)
 {
 
-    // delay states one t-state BEFORE the first pixel to be drawn
-    currentTstates++;
+    // border lines above and below the screen
+    if (currentTstates < contFirst || currentTstates >= contEnd) return 0;
 
-	// each line spans 224 t-states
-	unsigned short int line = currentTstates / 224; // int line
+    // new frame
+    if (currentTstates < contLineStart) contLineStart = contFirst;
 
-    // only the 192 lines between 64 and 255 have graphic data, the rest is border
-	if (line < 64 || line >= 256) return 0;
+    while (currentTstates - contLineStart >= contLineTstates)
+        contLineStart += contLineTstates;
 
-	// only the first 128 t-states of each line correspond to a graphic data transfer
-	// the remaining 96 t-states correspond to border
-	unsigned char halfpix = currentTstates % 224; // int halfpix
-
-	if (halfpix >= 128) return 0;
-
-    return(wait_states[halfpix & 0x07]);
+    return contLine[currentTstates - contLineStart];
 
 }
 
@@ -197,7 +418,7 @@ static unsigned char IRAM_ATTR delayContention(unsigned int currentTstates)
 static void ALUContentEarly( uint16_t port )
 {
 
-    if ( ( port & 49152 ) == 16384 )
+    if ( contIO && ADDRESS_CONTENDED(port) )
         Z80Ops::addTstates(delayContention(CPU::tstates) + 1,true);
     else
         Z80Ops::addTstates(1,true);
@@ -207,10 +428,12 @@ static void ALUContentEarly( uint16_t port )
 static void AluContentLate( uint16_t port )
 {
 
-  if( (port & 0x0001) == 0x00) {
+  if (!contIO) {
+        Z80Ops::addTstates(3,true);
+  } else if( (port & 0x0001) == 0x00) {
         Z80Ops::addTstates(delayContention(CPU::tstates) + 3,true);
   } else {
-    if ( (port & 49152) == 16384 ) {
+    if ( ADDRESS_CONTENDED(port) ) {
         Z80Ops::addTstates(delayContention(CPU::tstates) + 1,true);
         Z80Ops::addTstates(delayContention(CPU::tstates) + 1,true);
         Z80Ops::addTstates(delayContention(CPU::tstates) + 1,true);
@@ -225,28 +448,94 @@ static void AluContentLate( uint16_t port )
 
 /* Read opcode from RAM */
 uint8_t IRAM_ATTR Z80Ops::fetchOpcode(uint16_t address) {
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_EXEC>(address);
+    #endif
+
     // 3 clocks to fetch opcode from RAM and 1 execution clock
-    if (ADDRESS_IN_LOW_RAM(address))
+    if (ADDRESS_CONTENDED(address))
         addTstates(delayContention(CPU::tstates) + 4,true);
     else
         addTstates(4,true);
 
+    #ifdef GUEST_PROFILER
+    GuestProfiler::markExecuted(address);
+    #endif
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countFetch(address);
+    #endif
+
     return Mem::readbyte(address);
 }
 
+#ifdef INSTR_TRACE
+/* Record instruction about to run */
+void IRAM_ATTR Z80Ops::traceInstruction(uint16_t address) {
+    Trace::record(address);
+}
+#endif
+
+#ifdef ROM_HLE
+/* ROM loops done natively, never past the frame end (as isRepeatAllowed) */
+bool IRAM_ATTR Z80Ops::romRoutine(uint16_t address) {
+    return RomHLE::run(address, statesInFrame);
+}
+#endif
+
+#ifdef ROM_PREDECODE
+/* Only the ROM is translated: never contended nor written, so its
+   translations live until another ROM (or +3 RAM) is paged in */
+bool IRAM_ATTR Z80Ops::isCacheable(uint16_t address) {
+    #if defined(GUEST_PROFILER) || defined(MEM_HEATMAP)
+    // they count every opcode fetch
+    return false;
+    #else
+    return address < 0x4000 && !Mem::modeSP3;
+    #endif
+}
+
+uint8_t IRAM_ATTR Z80Ops::peekCode(uint16_t address) {
+    return Mem::readPage[address >> 14][address & 0x3fff];
+}
+#endif
+
+#if defined(ROM_HLE) || defined(Z80_FAST_CORE)
+// Same chunks as the HALT fast-forward in CPU::loop, so no line, border
+// segment or flash change is skipped
+void IRAM_ATTR CPU::skipTstates(uint32_t count)
+{
+    while (count > 0) {
+        uint32_t target = ALU_video_nextEvent();
+        uint32_t step = target > tstates ? target - tstates : 1;
+        if (step > count) step = count;
+        ALU_video(step);
+        count -= step;
+    }
+}
+#endif
+
 /* Read/Write byte from/to RAM */
 uint8_t IRAM_ATTR Z80Ops::peek8(uint16_t address) {
     // 3 clocks for read byte from RAM
-    if (ADDRESS_IN_LOW_RAM(address))
+    if (ADDRESS_CONTENDED(address))
         addTstates(delayContention(CPU::tstates) + 3,true);
     else
         addTstates(3,true);
 
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_READ>(address);
+    #endif
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countRead(address);
+    #endif
+
     return Mem::readbyte(address);
 }
 
 void IRAM_ATTR Z80Ops::poke8(uint16_t address, uint8_t value) {
-    if (ADDRESS_IN_LOW_RAM(address)) {
+    if (ADDRESS_CONTENDED(address)) {
         addTstates(delayContention(CPU::tstates) + 3,true);
 
         // #ifndef NO_VIDEO
@@ -272,6 +561,14 @@ void IRAM_ATTR Z80Ops::poke8(uint16_t address, uint8_t value) {
         #endif
 
     Mem::writebyte(address, value);
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countWrite(address);
+    #endif
+
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_WRITE>(address, value);
+    #endif
 }
 
 /* Read/Write word from/to RAM */
@@ -301,6 +598,10 @@ uint8_t IRAM_ATTR Z80Ops::inPort(uint16_t port) {
         addTstates(4,false); // I've changed this to CPU::tstates direct increment. All seems working OK. Investigate.
     #endif
 
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_IN>(port);
+    #endif
+
     uint8_t hiport = port >> 8;
     uint8_t loport = port & 0xFF;
     return Ports::input(loport, hiport);
@@ -320,6 +621,10 @@ void IRAM_ATTR Z80Ops::outPort(uint16_t port, uint8_t value) {
     uint8_t loport = port & 0xFF;
     Ports::output(loport, hiport, value);
 
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_OUT>(port, value);
+    #endif
+
     #ifdef BORDER_EFFECTS
         AluContentLate( port );    // Contended I/O
     #endif
@@ -330,7 +635,7 @@ void IRAM_ATTR Z80Ops::addressOnBus(uint16_t address, int32_t wstates){
 
     #ifdef BORDER_EFFECTS
         // Additional clocks to be added on some instructions
-        if (ADDRESS_IN_LOW_RAM(address)) {
+        if (ADDRESS_CONTENDED(address)) {
             for (int idx = 0; idx < wstates; idx++)
                 addTstates(delayContention(CPU::tstates) + 1,true);
         }
@@ -338,7 +643,7 @@ void IRAM_ATTR Z80Ops::addressOnBus(uint16_t address, int32_t wstates){
             addTstates(wstates,true); // I've changed this to CPU::tstates direct increment. All seems working OK. Investigate.
     #else
         // Additional clocks to be added on some instructions
-        if (ADDRESS_IN_LOW_RAM(address)) {
+        if (ADDRESS_CONTENDED(address)) {
             for (int idx = 0; idx < wstates; idx++)
                 addTstates(delayContention(CPU::tstates) + 1,false); // I've changed this to CPU::tstates direct increment. All seems working OK. Investigate.
         }
@@ -359,11 +664,15 @@ void IRAM_ATTR Z80Ops::interruptHandlingTime(int32_t wstates) {
 
 }
 
-/* Callback to know when the INT signal is active */
-bool IRAM_ATTR Z80Ops::isActiveINT(void) {
-    if (!interruptPending) return false;
-    interruptPending = false;
-    return true;
+/* Callback to read the machine clock (T-states in current frame) */
+uint32_t IRAM_ATTR Z80Ops::getTstates(void) {
+    return CPU::tstates;
+}
+
+/* Callback to know if a repeated block instruction can run its next iteration
+   inside the core: not past the frame end */
+bool IRAM_ATTR Z80Ops::isRepeatAllowed(void) {
+    return CPU::tstates < statesInFrame;
 }
 
 void IRAM_ATTR Z80Ops::addTstates(int32_t tstatestoadd, bool dovideo) {
@@ -375,6 +684,148 @@ void IRAM_ATTR Z80Ops::addTstates(int32_t tstatestoadd, bool dovideo) {
 
 }
 
+#ifdef Z80_FAST_CORE
+///////////////////////////////////////////////////////////////////////////////
+//
+// Fast core callbacks: time only goes into CPU::tstates, with contention on
+// opcode fetches from contended memory but not on data or I/O accesses.
+// The renderer is updated by fastRun() between batches of instructions.
+
+// End of the batch being run: block instructions repeated in bulk stop
+// there too, not at the frame end
+static MACHINE_STATE uint32_t fastDeadline = 0;
+
+uint8_t IRAM_ATTR Z80OpsFast::fetchOpcode(uint16_t address) {
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_EXEC>(address);
+    #endif
+
+    if (ADDRESS_CONTENDED(address))
+        CPU::tstates += delayContention(CPU::tstates) + 4;
+    else
+        CPU::tstates += 4;
+
+    #ifdef GUEST_PROFILER
+    GuestProfiler::markExecuted(address);
+    #endif
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countFetch(address);
+    #endif
+
+    return Mem::readbyte(address);
+}
+
+#ifdef INSTR_TRACE
+void IRAM_ATTR Z80OpsFast::traceInstruction(uint16_t address) {
+    Trace::record(address);
+}
+#endif
+
+uint8_t IRAM_ATTR Z80OpsFast::peek8(uint16_t address) {
+    CPU::tstates += 3;
+
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_READ>(address);
+    #endif
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countRead(address);
+    #endif
+
+    return Mem::readbyte(address);
+}
+
+void IRAM_ATTR Z80OpsFast::poke8(uint16_t address, uint8_t value) {
+    CPU::tstates += 3;
+
+    Mem::writebyte(address, value);
+
+    #ifdef MEM_HEATMAP
+    MemHeatmap::countWrite(address);
+    #endif
+
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_WRITE>(address, value);
+    #endif
+}
+
+uint16_t IRAM_ATTR Z80OpsFast::peek16(uint16_t address) {
+    uint8_t lsb = Z80OpsFast::peek8(address);
+    uint8_t msb = Z80OpsFast::peek8(address + 1);
+
+    return (msb << 8) | lsb;
+}
+
+void IRAM_ATTR Z80OpsFast::poke16(uint16_t address, RegisterPair word) {
+    Z80OpsFast::poke8(address, word.byte8.lo);
+    Z80OpsFast::poke8(address + 1, word.byte8.hi);
+}
+
+uint8_t IRAM_ATTR Z80OpsFast::inPort(uint16_t port) {
+    CPU::tstates += 4;
+
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_IN>(port);
+    #endif
+
+    return Ports::input(port & 0xFF, port >> 8);
+}
+
+void IRAM_ATTR Z80OpsFast::outPort(uint16_t port, uint8_t value) {
+    CPU::tstates += 4;
+
+    Ports::output(port & 0xFF, port >> 8, value);
+
+    #ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::check<BP_OUT>(port, value);
+    #endif
+}
+
+void IRAM_ATTR Z80OpsFast::addressOnBus(uint16_t address, int32_t wstates) {
+    CPU::tstates += wstates;
+}
+
+void IRAM_ATTR Z80OpsFast::interruptHandlingTime(int32_t wstates) {
+    CPU::tstates += wstates;
+}
+
+uint32_t IRAM_ATTR Z80OpsFast::getTstates(void) {
+    return CPU::tstates;
+}
+
+bool IRAM_ATTR Z80OpsFast::isRepeatAllowed(void) {
+    return CPU::tstates < fastDeadline;
+}
+
+void IRAM_ATTR Z80OpsFast::addTstates(int32_t tstatestoadd, bool dovideo) {
+    CPU::tstates += tstatestoadd;
+}
+
+// Runs the fast core up to the next point where the renderer has work to
+// do (or one instruction with tape traps), then hands ALU_video the elapsed
+// time: lines are drawn from memory as it is then. The last instruction
+// may go past that point, so the time is still given in the steps
+// ALU_video draws.
+static void IRAM_ATTR fastRun()
+{
+    uint32_t start = CPU::tstates;
+
+    fastDeadline = ALU_video_nextEvent();
+    if (fastDeadline > statesInFrame) fastDeadline = statesInFrame;
+
+    #ifdef TAPE_TRAPS
+        Z80Fast::execute();
+    #else
+        Z80Fast::executeUntil(fastDeadline);
+    #endif
+
+    uint32_t elapsed = CPU::tstates - start;
+    CPU::tstates = start;
+    CPU::skipTstates(elapsed);
+}
+#endif // Z80_FAST_CORE
+
 ///////////////////////////////////////////////////////////////////////////////
 //  VIDEO EMULATION
 ///////////////////////////////////////////////////////////////////////////////
@@ -384,9 +835,9 @@ static word spectrum_colors[NUM_SPECTRUM_COLORS] = {
     BRI_BLACK, BRI_BLUE, BRI_RED, BRI_MAGENTA, BRI_GREEN, BRI_CYAN, BRI_YELLOW, BRI_WHITE,
 };
 
-static word specfast_colors[128]; // Array for faster color calc in ALU_video
+static MACHINE_STATE word specfast_colors[128]; // Array for faster color calc in ALU_video
 
-static unsigned int lastBorder[312]= { 0 };
+static MACHINE_STATE unsigned int lastBorder[312]= { 0 };
 
 #define TSTATES_PER_LINE 224
 
@@ -433,7 +884,7 @@ void precalcULASWAP() {
 }
 
 // Precalc border 32 bits values
-static unsigned int border32[8];
+static MACHINE_STATE unsigned int border32[8];
 void precalcborder32()
 {
     for (int i = 0; i < 8; i++) {
@@ -475,14 +926,14 @@ void ALU_video_reset() {
 ///////////////////////////////////////////////////////////////////////////////
 //  VIDEO DRAW FUNCTION
 ///////////////////////////////////////////////////////////////////////////////
-static unsigned int bmpOffset;  // offset for bitmap in graphic memory
-static unsigned int attOffset;  // offset for attrib in graphic memory
-static unsigned int att, bmp;   // attribute and bitmap
-static unsigned int palette[2]; //0 backcolor 1 Forecolor
-static unsigned int a0,a1,a2,a3;
+static MACHINE_STATE unsigned int bmpOffset;  // offset for bitmap in graphic memory
+static MACHINE_STATE unsigned int attOffset;  // offset for attrib in graphic memory
+static MACHINE_STATE unsigned int att, bmp;   // attribute and bitmap
+static MACHINE_STATE unsigned int palette[2]; //0 backcolor 1 Forecolor
+static MACHINE_STATE unsigned int a0,a1,a2,a3;
 
-static uint8_t* grmem;
-static uint32_t* lineptr32;
+static MACHINE_STATE uint8_t* grmem;
+static MACHINE_STATE uint32_t* lineptr32;
 
 // DrawStatus values
 #define TOPBORDER_BLANK 0
@@ -501,13 +952,13 @@ static uint32_t* lineptr32;
 ///////////////////////////////////////////////////////////////////////////////
 // ALU_video -> Fast Border
 ///////////////////////////////////////////////////////////////////////////////
-static unsigned char DrawStatus=BLANK;
-static unsigned int tstateDraw; // Drawing start point (in Tstates)
-static unsigned int linedraw_cnt;
-static unsigned int mainscrline_cnt;
-static unsigned int coldraw_cnt;
-static unsigned int ALU_video_rest;
-static unsigned int brd;
+static MACHINE_STATE unsigned char DrawStatus=BLANK;
+static MACHINE_STATE unsigned int tstateDraw; // Drawing start point (in Tstates)
+static MACHINE_STATE unsigned int linedraw_cnt;
+static MACHINE_STATE unsigned int mainscrline_cnt;
+static MACHINE_STATE unsigned int coldraw_cnt;
+static MACHINE_STATE unsigned int ALU_video_rest;
+static MACHINE_STATE unsigned int brd;
 
 static void IRAM_ATTR ALU_video(unsigned int statestoadd) {
 
@@ -724,6 +1175,35 @@ static void IRAM_ATTR ALU_video(unsigned int statestoadd) {
 
 #endif
 
+}
+
+// Next T-state at which ALU_video() has something to do, if time advanced
+// only through 4 T-state steps with no memory or border changes (CPU halted).
+// Calling ALU_video() once for all the steps up to it draws the same as
+// calling it for every step.
+static uint32_t IRAM_ATTR ALU_video_nextEvent() {
+
+#ifndef NO_VIDEO
+
+    switch (DrawStatus) {
+        case TOPBORDER:
+        case LEFTBORDER:
+        case LINEDRAW_SYNC:
+        case BOTTOMBORDER:
+            return tstateDraw + 1;
+        case LINEDRAW:
+            // columns drawn only depend on time elapsed since line start
+            return tstateDraw + 128;
+        case RIGHTBORDER:
+            return CPU::tstates;
+        case BLANK:
+            if (CPU::tstates < TSTATES_PER_LINE) return CPU::tstates;
+    }
+
+#endif
+
+    return 0xFFFFFFFF;
+
 }
 #endif
 
@@ -733,12 +1213,12 @@ static void IRAM_ATTR ALU_video(unsigned int statestoadd) {
 // only for 4:3 (320x240)
 // Works almost perfect with Bordertrix demo but it is slow
 ///////////////////////////////////////////////////////////////////////////////
-static unsigned char DrawStatus=BLANK;
-static unsigned int tstateDraw; // Drawing start point (in Tstates)
-static unsigned int linedraw_cnt;
-static unsigned int coldraw_cnt;
-static unsigned int ALU_video_rest;
-static unsigned int brd;
+static MACHINE_STATE unsigned char DrawStatus=BLANK;
+static MACHINE_STATE unsigned int tstateDraw; // Drawing start point (in Tstates)
+static MACHINE_STATE unsigned int linedraw_cnt;
+static MACHINE_STATE unsigned int coldraw_cnt;
+static MACHINE_STATE unsigned int ALU_video_rest;
+static MACHINE_STATE unsigned int brd;
 
 static void IRAM_ATTR ALU_video(unsigned int statestoadd) {
 
@@ -1003,5 +1483,36 @@ static void IRAM_ATTR ALU_video(unsigned int statestoadd) {
 
 #endif
 
+}
+
+// Next T-state at which ALU_video() has something to do, if time advanced
+// only through 4 T-state steps with no memory or border changes (CPU halted).
+// While drawing, every 4 T-state step draws exactly one column, so the
+// event is the end of the current segment.
+static uint32_t IRAM_ATTR ALU_video_nextEvent() {
+
+#ifndef NO_VIDEO
+
+    switch (DrawStatus) {
+        case TOPBORDER_BLANK:
+        case MAINSCREEN_BLANK:
+        case BOTTOMBORDER_BLANK:
+            return tstateDraw + 1;
+        case TOPBORDER:
+        case RIGHTBORDER:
+        case BOTTOMBORDER:
+            return CPU::tstates + ((40 - coldraw_cnt) << 2);
+        case LEFTBORDER:
+            return CPU::tstates + ((4 - coldraw_cnt) << 2);
+        case LINEDRAW:
+            return CPU::tstates + ((36 - coldraw_cnt) << 2);
+        case BLANK:
+            if (CPU::tstates < TSTATES_PER_LINE) return CPU::tstates;
+    }
+
+#endif
+
+    return 0xFFFFFFFF;
+
 }
 #endif
\ No newline at end of file
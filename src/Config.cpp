@@ -32,6 +32,7 @@
 #include "PS2Kbd.h"
 #include "FileUtils.h"
 #include "messages.h"
+#include "CPU.h"
 
 #ifdef USE_INT_FLASH
 // using internal storage (spi flash)
@@ -48,15 +49,18 @@
 static SPIClass customSPI;
 #endif
 
-String   Config::arch = "128K";
-String   Config::ram_file = NO_RAM_FILE;
-String   Config::romSet = "SINCLAIR";
+MACHINE_STATE String   Config::arch = "128K";
+MACHINE_STATE String   Config::ram_file = NO_RAM_FILE;
+MACHINE_STATE String   Config::romSet = "SINCLAIR";
 String   Config::sna_file_list; // list of file names
 String   Config::sna_name_list; // list of names (without ext, '_' -> ' ')
 String   Config::tap_file_list; // list of file names
 String   Config::tap_name_list; // list of names (without ext, '_' -> ' ')
 bool     Config::slog_on = true;
 bool     Config::aspect_16_9 = false;
+#ifdef Z80_FAST_CORE
+String   Config::fast_core_list; // snapshots using the fast core
+#endif
 
 // Read config from FS
 void Config::load() {
@@ -90,6 +94,12 @@ void Config::load() {
             } else if (line.startsWith("asp169:")) {
                 aspect_16_9 = (line.substring(line.lastIndexOf(':') + 1) == "true");
                 Serial.printf("  + asp169: '%s'\n", (aspect_16_9 ? "true" : "false"));
+#ifdef Z80_FAST_CORE
+            } else if (line.startsWith("fastcore:")) {
+                String filename = line.substring(line.indexOf(':') + 1);
+                fast_core_list += filename + "\n";
+                Serial.printf("  + fastcore: '%s'\n", filename.c_str());
+#endif
             }
             line = "";
         } else {
@@ -147,6 +157,16 @@ void Config::save() {
     // Serial logging
     Serial.printf("  + asp169:%s\n", (aspect_16_9 ? "true" : "false"));
     f.printf("asp169:%s\n", (aspect_16_9 ? "true" : "false"));
+#ifdef Z80_FAST_CORE
+    // Snapshots using the fast core
+    int start = 0, end;
+    while ((end = fast_core_list.indexOf('\n', start)) >= 0) {
+        String filename = fast_core_list.substring(start, end);
+        Serial.printf("  + fastcore:%s\n", filename.c_str());
+        f.printf("fastcore:%s\n", filename.c_str());
+        start = end + 1;
+    }
+#endif
 
     f.close();
     vTaskDelay(5);
@@ -158,6 +178,26 @@ void Config::save() {
     // loadSnapshotLists();
 }
 
+#ifdef Z80_FAST_CORE
+bool Config::isFastCore(String filename)
+{
+    return ("\n" + fast_core_list).indexOf("\n" + filename + "\n") >= 0;
+}
+
+void Config::setFastCore(String filename, bool fast)
+{
+    if (fast == isFastCore(filename)) return;
+
+    if (fast) {
+        fast_core_list += filename + "\n";
+    } else {
+        String list = "\n" + fast_core_list;
+        list.replace("\n" + filename + "\n", "\n");
+        fast_core_list = list.substring(1);
+    }
+}
+#endif
+
 void Config::requestMachine(String newArch, String newRomSet, bool force)
 {
     if (!force && newArch == arch) {
@@ -168,4 +208,5 @@ void Config::requestMachine(String newArch, String newRomSet, bool force)
     arch = newArch;
     romSet = newRomSet;
     FileUtils::loadRom(arch, romSet);
+    CPU::setupContention();
 }
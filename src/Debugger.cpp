@@ -0,0 +1,277 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef WITH_BREAKPOINT_SUPPORT
+
+#include <Arduino.h>
+#include "Debugger.h"
+#include "Mem.h"
+#include "messages.h"
+#include "Z80_JLS/z80.h"
+
+#ifdef INSTR_TRACE
+#include "Trace.h"
+#endif
+
+#define DBG_LINE_LEN 64
+
+MACHINE_STATE uint8_t Debugger::armed = 0;
+MACHINE_STATE uint8_t* Debugger::bitmap[BP_KINDS] = { NULL };
+MACHINE_STATE uint16_t Debugger::count[BP_KINDS] = { 0 };
+
+static MACHINE_STATE char lineBuf[DBG_LINE_LEN];
+static MACHINE_STATE uint8_t lineLen = 0;
+
+static const char kindLetter[BP_KINDS + 1] = "brwio";
+static const char* const kindName[BP_KINDS] = { "exec", "read", "write", "in", "out" };
+
+static void printRegs()
+{
+    Serial.printf("AF=%04X BC=%04X DE=%04X HL=%04X IX=%04X IY=%04X\n",
+        Z80::getRegAF(), Z80::getRegBC(), Z80::getRegDE(), Z80::getRegHL(),
+        Z80::getRegIX(), Z80::getRegIY());
+    Serial.printf("AF'=%04X BC'=%04X DE'=%04X HL'=%04X\n",
+        Z80::getRegAFx(), Z80::getRegBCx(), Z80::getRegDEx(), Z80::getRegHLx());
+    Serial.printf("PC=%04X SP=%04X I=%02X R=%02X IM%u IFF1=%u%s\n",
+        Z80::getRegPC(), Z80::getRegSP(), Z80::getRegI(), Z80::getRegR(),
+        Z80::getIM(), Z80::isIFF1(), Z80::isHalted() ? " HALT" : "");
+}
+
+static void dumpMem(uint16_t addr, uint16_t len)
+{
+    for (uint16_t i = 0; i < len; i++) {
+        if ((i & 0x0f) == 0) Serial.printf("%04X:", (uint16_t)(addr + i));
+        Serial.printf(" %02X", Mem::readbyte(addr + i));
+        if ((i & 0x0f) == 0x0f || i == len - 1) Serial.printf("\n");
+    }
+}
+
+bool Debugger::set(uint8_t kind, uint16_t addr)
+{
+    uint8_t idx = __builtin_ctz(kind);
+
+    if (bitmap[idx] == NULL) {
+        bitmap[idx] = (uint8_t*)calloc(1, 0x10000 >> 3);
+        if (bitmap[idx] == NULL) {
+            Serial.printf("Debugger: out of memory\n");
+            return false;
+        }
+    }
+
+    if (!(bitmap[idx][addr >> 3] & (1 << (addr & 7)))) {
+        bitmap[idx][addr >> 3] |= 1 << (addr & 7);
+        count[idx]++;
+    }
+
+    updateArmed();
+    return true;
+}
+
+void Debugger::clear(uint8_t kind, uint16_t addr)
+{
+    uint8_t idx = __builtin_ctz(kind);
+
+    if (bitmap[idx] == NULL || !(bitmap[idx][addr >> 3] & (1 << (addr & 7))))
+        return;
+
+    bitmap[idx][addr >> 3] &= ~(1 << (addr & 7));
+    if (--count[idx] == 0) {
+        free(bitmap[idx]);
+        bitmap[idx] = NULL;
+    }
+
+    updateArmed();
+}
+
+void Debugger::clearAll()
+{
+    for (uint8_t idx = 0; idx < BP_KINDS; idx++) {
+        free(bitmap[idx]);
+        bitmap[idx] = NULL;
+        count[idx] = 0;
+    }
+
+    updateArmed();
+}
+
+void Debugger::updateArmed()
+{
+    armed &= BP_STEP;
+    for (uint8_t idx = 0; idx < BP_KINDS; idx++)
+        if (count[idx]) armed |= 1 << idx;
+
+    // no LDIR & co. bulk loops while anything is armed
+    Z80::setBreakpoint(armed != 0);
+}
+
+void Debugger::list(uint8_t kind)
+{
+    uint8_t idx = __builtin_ctz(kind);
+
+    if (bitmap[idx] == NULL) return;
+
+    Serial.printf("%s:", kindName[idx]);
+    for (uint32_t addr = 0; addr < 0x10000; addr++)
+        if (bitmap[idx][addr >> 3] & (1 << (addr & 7)))
+            Serial.printf(" %04X", addr);
+    Serial.printf("\n");
+}
+
+void Debugger::hit(uint8_t kind, uint16_t addr, uint8_t value)
+{
+    if (kind == BP_EXEC && (armed & BP_STEP)) {
+        armed &= ~BP_STEP;
+        updateArmed();
+    } else {
+        uint8_t* bits = bitmap[__builtin_ctz(kind)];
+        if (bits == NULL || !(bits[addr >> 3] & (1 << (addr & 7))))
+            return;
+    }
+
+    switch (kind) {
+    case BP_EXEC:
+        Serial.printf("Break at %04X\n", addr);
+        break;
+    case BP_READ:
+        Serial.printf("Watch read %04X=%02X\n", addr, Mem::readbyte(addr));
+        break;
+    case BP_WRITE:
+        Serial.printf("Watch write %04X=%02X\n", addr, value);
+        break;
+    case BP_IN:
+        Serial.printf("Watch in %04X\n", addr);
+        break;
+    case BP_OUT:
+        Serial.printf("Watch out %04X=%02X\n", addr, value);
+        break;
+    }
+    printRegs();
+
+    #ifdef INSTR_TRACE
+    Trace::dump(INSTR_TRACE_DUMP_LAST);
+    #endif
+
+    prompt();
+}
+
+// Stops the emulation until a command resumes it
+void Debugger::prompt()
+{
+    Serial.printf("> ");
+    for (;;) {
+        if (readLine()) {
+            if (command(lineBuf)) return;
+            Serial.printf("> ");
+        } else {
+            vTaskDelay(10);
+        }
+    }
+}
+
+void Debugger::pollSerial()
+{
+    while (readLine()) {
+        command(lineBuf);
+    }
+}
+
+// Collects serial input, true when a whole line is in lineBuf
+bool Debugger::readLine()
+{
+    while (Serial.available()) {
+        char c = Serial.read();
+        if (c == '\r' || c == '\n') {
+            if (lineLen == 0) continue;
+            lineBuf[lineLen] = 0;
+            lineLen = 0;
+            return true;
+        }
+        if (lineLen < DBG_LINE_LEN - 1) lineBuf[lineLen++] = c;
+    }
+    return false;
+}
+
+// Runs a command line, true if emulation should go on
+bool Debugger::command(const char* line)
+{
+    char cmd = line[0];
+    const char* arg = line + 1;
+    while (*arg == ' ') arg++;
+
+    const char* kind = strchr(kindLetter, cmd);
+    if (kind != NULL && *arg) {
+        set(1 << (kind - kindLetter), strtoul(arg, NULL, 16));
+        return false;
+    }
+
+    switch (cmd) {
+    case 'd':
+        if (*arg == '*') {
+            clearAll();
+        } else if (*arg && (kind = strchr(kindLetter, *arg)) != NULL) {
+            clear(1 << (kind - kindLetter), strtoul(arg + 1, NULL, 16));
+        } else {
+            Serial.printf("%s", DBG_HELP);
+        }
+        return false;
+    case 'l':
+        for (uint8_t idx = 0; idx < BP_KINDS; idx++) list(1 << idx);
+        return false;
+    case 'x':
+        printRegs();
+        return false;
+    #ifdef INSTR_TRACE
+    case 't':
+        Trace::dump(strtoul(arg, NULL, 10));
+        return false;
+    #endif
+    case 'm': {
+        char* end;
+        uint16_t addr = strtoul(arg, &end, 16);
+        uint16_t len = strtoul(end, NULL, 16);
+        dumpMem(addr, len ? len : 0x10);
+        return false;
+    }
+    case 'p':
+    case 's':
+        // break at the next opcode fetch
+        armed |= BP_STEP;
+        updateArmed();
+        return true;
+    case 'c':
+        return true;
+    default:
+        Serial.printf("%s", DBG_HELP);
+        return false;
+    }
+}
+
+#endif // WITH_BREAKPOINT_SUPPORT
@@ -57,6 +57,18 @@
 
 #include "Z80_JLS/z80.h"
 
+#ifdef WITH_BREAKPOINT_SUPPORT
+#include "Debugger.h"
+#endif
+
+#ifdef RAM_MIGRATION
+#include "RamPlacement.h"
+#endif
+
+#ifdef BANK_STORE
+#include "BankStore.h"
+#endif
+
 #include "fabgl.h"
 
 
@@ -70,22 +82,22 @@ void setup_cpuspeed();
 
 // SETUP *************************************
 // ESPectrum graphics variables
-VGA ESPectrum::vga;
-byte ESPectrum::borderColor = 7;
+MACHINE_STATE VGA ESPectrum::vga;
+MACHINE_STATE byte ESPectrum::borderColor = 7;
 
 // Audio variables
-unsigned char ESPectrum::audioBuffer[2][ESP_AUDIO_SAMPLES];
-unsigned char ESPectrum::overSamplebuf[ESP_AUDIO_OVERSAMPLES];
+MACHINE_STATE unsigned char ESPectrum::audioBuffer[2][ESP_AUDIO_SAMPLES];
+MACHINE_STATE unsigned char ESPectrum::overSamplebuf[ESP_AUDIO_OVERSAMPLES];
 signed char ESPectrum::aud_volume = -8;
-int ESPectrum::buffertofill=1;
-int ESPectrum::buffertoplay=0;
-uint32_t ESPectrum::audbufcnt = 0;
-int ESPectrum::lastaudioBit = 0;
+MACHINE_STATE int ESPectrum::buffertofill=1;
+MACHINE_STATE int ESPectrum::buffertoplay=0;
+MACHINE_STATE uint32_t ESPectrum::audbufcnt = 0;
+MACHINE_STATE int ESPectrum::lastaudioBit = 0;
 static QueueHandle_t audioTaskQueue;
 static TaskHandle_t audioTaskHandle;
 static uint8_t *param;
 //int ESPectrum::ESPoffset = 0; // Testing
-int ESPectrum::samplesPerFrame = 546; // 48k value
+MACHINE_STATE int ESPectrum::samplesPerFrame = 546; // 48k value
 
 bool isLittleEndian()
 {
@@ -203,6 +215,9 @@ void ESPectrum::setup()
 
 #else
     Mem::rom0 = (byte *)malloc(16384);
+#ifdef BANK_STORE
+    Mem::rom1 = (byte *)malloc(16384);
+#endif
 
     Mem::ram0 = (byte *)malloc(16384);
     Mem::ram2 = (byte *)malloc(16384);
@@ -223,6 +238,17 @@ void ESPectrum::setup()
     Mem::ram[6] = Mem::ram6;
     Mem::ram[7] = Mem::ram7;
 
+#ifdef BANK_STORE
+    BankStore::setup();
+#endif
+
+    Mem::updatePaging();
+    Mem::setAllDirty();
+
+#ifdef RAM_MIGRATION
+    RamPlacement::setup();
+#endif
+
     Serial.printf("Free heap after allocating emulated ram: %d\n", ESP.getFreeHeap());
 
     // Init tape
@@ -313,7 +339,8 @@ void ESPectrum::reset()
     
     Mem::modeSP3 = 0;
     Mem::romSP3 = 0;
-    Mem::romInUse = 0;
+    Mem::specialSP3 = 0;
+    Mem::selectRom(0);
 
     Tape::tapeFileName = "none";
     Tape::tapeStatus = TAPE_STOPPED;
@@ -557,6 +584,15 @@ void ESPectrum::audioFrameEnd() {
 static double totalseconds=0;
 #endif
 
+#ifdef LOG_DEBUG_TIMING
+// named in the emulated MHz line, to tell the builds apart
+#ifdef Z80_THREADED_DISPATCH
+#define Z80_DISPATCH_NAME "threaded"
+#else
+#define Z80_DISPATCH_NAME "switch"
+#endif
+#endif
+
 void ESPectrum::loop() {
 
 #if defined(LOG_DEBUG_TIMING) || defined(VIDEO_FRAME_TIMING)
@@ -569,13 +605,25 @@ void ESPectrum::loop() {
     
     OSD::do_OSD();
 
+#ifdef WITH_BREAKPOINT_SUPPORT
+    Debugger::pollSerial();
+#endif
+
     param = (uint8_t *) audioBuffer[buffertoplay];
     xQueueSend(audioTaskQueue, &param, portMAX_DELAY);
 
     audioFrameStart();
 
+#ifdef LOG_DEBUG_TIMING
+    uint32_t ts_cpu = micros();
+#endif
+
     CPU::loop();    
 
+#ifdef LOG_DEBUG_TIMING
+    uint32_t cpuelapsed = micros() - ts_cpu;
+#endif
+
     audioFrameEnd();
 
     // Swap audio buffers
@@ -599,18 +647,30 @@ void ESPectrum::loop() {
     static int ctr = 0;
     static int ctrcount = 0;
     static uint32_t sumelapsed;
+    // Z80 time only: T-states per microsecond of CPU::loop is emulated MHz
+    static uint64_t sumcputstates;
+    static uint64_t sumcpuelapsed;
     #ifdef SHOW_FPS
         totalseconds += elapsed;
     #endif
     if (ctr == 0) {
         ctr = 10;
         sumelapsed+=elapsed;
+        sumcputstates += CPU::tstates;
+        sumcpuelapsed += cpuelapsed;
         ctrcount++;
         if ((ctrcount & 0x000F) == 0) {
             Serial.printf("========================================\n");
             Serial.printf("[CPU] elapsed: %u; idle: %d\n", elapsed, idle);
             Serial.printf("[Audio] Volume: %d\n", aud_volume);
             Serial.printf("[CPU] average: %u; Samples taken: %u\n", sumelapsed / ctrcount, ctrcount);
+            Serial.printf("[CPU] %s core, %s dispatch: %.2f MHz emulated\n",
+            #ifdef Z80_FAST_CORE
+                CPU::core == CPU_CORE_FAST ? "fast" : "precise",
+            #else
+                "precise",
+            #endif
+                Z80_DISPATCH_NAME, (double) sumcputstates / sumcpuelapsed);
             //Serial.printf("[Delay offset] %d\n", ESPoffset);  // For testing
             //Serial.printf("[Beeper samples taken] %u\n", audbufcnt);  
             #ifdef SHOW_FPS
@@ -108,6 +108,19 @@
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// copy a whole RAM bank into another. A Mem::bank() pointer only lasts until
+// the next call (BANK_STORE), so it goes through a small buffer
+static void copyBank(uint8_t dst, uint8_t src)
+{
+    uint8_t chunk[0x100];
+    for (uint16_t offset = 0; offset < MEM_PG_SZ; offset += sizeof(chunk)) {
+        memcpy(chunk, Mem::bank(src) + offset, sizeof(chunk));
+        memcpy(Mem::bank(dst) + offset, chunk, sizeof(chunk));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 bool FileSNA::load(String sna_fn)
 {
     File file;
@@ -137,7 +150,7 @@ bool FileSNA::load(String sna_fn)
     Mem::pagingLock = 1;
     Mem::videoLatch = 0;
     Mem::romLatch = 0;
-    Mem::romInUse = 0;
+    Mem::selectRom(0);
 
     // Read in the registers
     Z80_SET_I(readByteFile(file));
@@ -167,9 +180,9 @@ bool FileSNA::load(String sna_fn)
     ESPectrum::borderColor = readByteFile(file);
 
     // read 48K memory
-    readBlockFile(file, Mem::ram5, 0x4000);
-    readBlockFile(file, Mem::ram2, 0x4000);
-    readBlockFile(file, Mem::ram0, 0x4000);
+    readBlockFile(file, Mem::bank(5), 0x4000);
+    readBlockFile(file, Mem::bank(2), 0x4000);
+    readBlockFile(file, Mem::bank(0), 0x4000);
 
     if (sna_size == SNA_48K_SIZE)
     {
@@ -192,14 +205,14 @@ bool FileSNA::load(String sna_fn)
         uint8_t tmp_latch = tmp_port & 0x07;
 
         // copy what was read into page 0 to correct page
-        memcpy(Mem::ram[tmp_latch], Mem::ram[0], 0x4000);
+        if (tmp_latch != 0) copyBank(tmp_latch, 0);
 
         uint8_t tr_dos = readByteFile(file);     // unused
         
         // read remaining pages
         for (int page = 0; page < 8; page++) {
             if (page != tmp_latch && page != 2 && page != 5) {
-                readBlockFile(file, Mem::ram[page], 0x4000);
+                readBlockFile(file, Mem::bank(page), 0x4000);
             }
         }
 
@@ -208,11 +221,16 @@ bool FileSNA::load(String sna_fn)
         Mem::romLatch = bitRead(tmp_port, 4);
         Mem::pagingLock = bitRead(tmp_port, 5);
         Mem::bankLatch = tmp_latch;
-        Mem::romInUse = Mem::romLatch;
+        Mem::selectRom(Mem::romLatch);
 
     }
     file.close();
 
+    // RAM written behind the dirty map's back (and, with BANK_STORE, maybe
+    // the paged in banks compressed out to make room for the others)
+    Mem::updatePaging();
+    Mem::setAllDirty();
+
     // just architecturey things
     if (Config::getArch() == "128K")
     {
@@ -220,9 +238,9 @@ bool FileSNA::load(String sna_fn)
         {
             #ifdef SNAPSHOT_LOAD_FORCE_ARCH
                 Config::requestMachine("48K", "SINCLAIR", true);
-                Mem::romInUse = 0;
+                Mem::selectRom(0);
             #else
-                Mem::romInUse = 1;
+                Mem::selectRom(1);
             #endif
         }
     }
@@ -231,7 +249,7 @@ bool FileSNA::load(String sna_fn)
         if (snapshotArch == "128K")
         {
             Config::requestMachine("128K", "SINCLAIR", true);
-            Mem::romInUse = 1;
+            Mem::selectRom(1);
         }
     }
 
@@ -253,7 +271,8 @@ bool FileSNA::isPersistAvailable(String filename)
 static bool writeMemPage(uint8_t page, File file, bool blockMode)
 {
     page = page & 0x07;
-    uint8_t* buffer = Mem::ram[page];
+    uint8_t* buffer = Mem::bank(page);
+    bool result = true;
 
     Serial.printf("writing page %d in [%s] mode\n", page, blockMode ? "block" : "byte");
 
@@ -262,7 +281,7 @@ static bool writeMemPage(uint8_t page, File file, bool blockMode)
         uint16_t bytesWritten = file.write(buffer, MEM_PG_SZ);
         if (bytesWritten != MEM_PG_SZ) {
             Serial.printf("error writing page %d: %d of %d bytes written\n", page, bytesWritten, MEM_PG_SZ);
-            return false;
+            result = false;
         }
     }
     else {
@@ -270,11 +289,16 @@ static bool writeMemPage(uint8_t page, File file, bool blockMode)
             uint8_t b = buffer[offset];
             if (1 != file.write(b)) {
                 Serial.printf("error writing byte from page %d at offset %d\n", page, offset);
-                return false;
+                result = false;
+                break;
             }
         }
     }
-    return true;
+
+    // with BANK_STORE, getting the page may have compressed a paged in one
+    Mem::updatePaging();
+
+    return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -406,8 +430,8 @@ bool FileSNA::save(String sna_file, bool blockMode) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-static uint8_t* quick_sna_buffer = NULL;
-static uint32_t quick_sna_size   = 0;
+static MACHINE_STATE uint8_t* quick_sna_buffer = NULL;
+static MACHINE_STATE uint32_t quick_sna_size   = 0;
 
 bool FileSNA::isQuickAvailable()
 {
@@ -505,7 +529,7 @@ bool FileSNA::saveToMem(uint8_t* dstBuffer, uint32_t size)
 
     for (uint8_t ipage = 0; ipage < 3; ipage++) {
         uint8_t page = pages[ipage];
-        writeBlockMem(Mem::ram[page], snaptr, MEM_PG_SZ);
+        writeBlockMem(Mem::bank(page), snaptr, MEM_PG_SZ);
     }
 
     if (Config::getArch() == "48K")
@@ -529,11 +553,14 @@ bool FileSNA::saveToMem(uint8_t* dstBuffer, uint32_t size)
         // write remaining ram pages
         for (int page = 0; page < 8; page++) {
             if (page != Mem::bankLatch && page != 2 && page != 5) {
-                writeBlockMem(Mem::ram[page], snaptr, MEM_PG_SZ);
+                writeBlockMem(Mem::bank(page), snaptr, MEM_PG_SZ);
             }
         }
     }
 
+    // with BANK_STORE, getting the pages may have compressed paged in ones
+    Mem::updatePaging();
+
     return true;
 }
 
@@ -567,7 +594,7 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
     Mem::pagingLock = 1;
     Mem::videoLatch = 0;
     Mem::romLatch = 0;
-    Mem::romInUse = 0;
+    Mem::selectRom(0);
 
     Z80_SET_I(readByteMem(snaptr));
 
@@ -596,9 +623,9 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
     ESPectrum::borderColor = readByteMem(snaptr);
 
     // read 48K memory
-    readBlockMem(snaptr, Mem::ram[5], MEM_PG_SZ);
-    readBlockMem(snaptr, Mem::ram[2], MEM_PG_SZ);
-    readBlockMem(snaptr, Mem::ram[0], MEM_PG_SZ);
+    readBlockMem(snaptr, Mem::bank(5), MEM_PG_SZ);
+    readBlockMem(snaptr, Mem::bank(2), MEM_PG_SZ);
+    readBlockMem(snaptr, Mem::bank(0), MEM_PG_SZ);
 
     if (size == SNA_48K_SIZE)
     {
@@ -621,14 +648,14 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
         uint8_t tmp_latch = tmp_port & 0x07;
 
         // copy what was read into page 0 to correct page
-        memcpy(Mem::ram[tmp_latch], Mem::ram[0], 0x4000);
+        if (tmp_latch != 0) copyBank(tmp_latch, 0);
 
         uint8_t tr_dos = readByteMem(snaptr);     // unused
         
         // read remaining pages
         for (int page = 0; page < 8; page++) {
             if (page != tmp_latch && page != 2 && page != 5) {
-                readBlockMem(snaptr, Mem::ram[page], 0x4000);
+                readBlockMem(snaptr, Mem::bank(page), 0x4000);
             }
         }
 
@@ -637,9 +664,14 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
         Mem::romLatch = bitRead(tmp_port, 4);
         Mem::pagingLock = bitRead(tmp_port, 5);
         Mem::bankLatch = tmp_latch;
-        Mem::romInUse = Mem::romLatch;
+        Mem::selectRom(Mem::romLatch);
     }
 
+    // RAM written behind the dirty map's back (and, with BANK_STORE, maybe
+    // the paged in banks compressed out to make room for the others)
+    Mem::updatePaging();
+    Mem::setAllDirty();
+
     // just architecturey things
     if (Config::getArch() == "128K")
     {
@@ -647,9 +679,9 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
         {
             #ifdef SNAPSHOT_LOAD_FORCE_ARCH
                 Config::requestMachine("48K", "SINCLAIR", true);
-                Mem::romInUse = 0;
+                Mem::selectRom(0);
             #else
-                Mem::romInUse = 1;
+                Mem::selectRom(1);
             #endif
         }
     }
@@ -658,7 +690,7 @@ bool FileSNA::loadFromMem(uint8_t* srcBuffer, uint32_t size)
         if (snapshotArch == "128K")
         {
             Config::requestMachine("128K", "SINCLAIR", true);
-            Mem::romInUse = 1;
+            Mem::selectRom(1);
         }
     }
 
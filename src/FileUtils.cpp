@@ -260,6 +260,13 @@ void FileUtils::loadRom(String arch, String romset) {
         rom_f.close();
     }
 
+    // the +2A/+3 memory controller comes with their four ROMs
+#ifdef BOARD_HAS_PSRAM
+    Mem::plus3Paging = (arch == "128K" && n_roms == 4);
+#else
+    Mem::plus3Paging = false;
+#endif
+
     KB_INT_START;
 }
 
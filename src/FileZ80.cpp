@@ -168,7 +168,7 @@ bool FileZ80::load(String sna_fn)
 
         // latches for 48K
         Mem::romLatch = 0;
-        Mem::romInUse = 0;
+        Mem::selectRom(0);
         Mem::bankLatch = 0;
         Mem::pagingLock = 1;
         Mem::videoLatch = 0;
@@ -233,7 +233,7 @@ bool FileZ80::load(String sna_fn)
 
         if (fileArch == "48K") {
             Mem::romLatch = 0;
-            Mem::romInUse = 0;
+            Mem::selectRom(0);
             Mem::bankLatch = 0;
             Mem::pagingLock = 1;
             Mem::videoLatch = 0;
@@ -261,7 +261,7 @@ bool FileZ80::load(String sna_fn)
             // great success!!!
         }
         else if (fileArch == "128K") {
-            Mem::romInUse = 1;
+            Mem::selectRom(1);
 
             // paging register
             uint8_t b35 = header[35];
@@ -269,11 +269,13 @@ bool FileZ80::load(String sna_fn)
             Mem::romLatch = bitRead(b35, 4);
             Mem::videoLatch = bitRead(b35, 3);
             Mem::bankLatch = b35 & 0x07;
+            Mem::updatePaging();
 
+            // RAM pages (3 to 10) from Mem::bank(), when loaded
             uint8_t* pages[12] = {
                 Mem::rom0, Mem::rom2, Mem::rom1,
-                Mem::ram0, Mem::ram1, Mem::ram2, Mem::ram3,
-                Mem::ram4, Mem::ram5, Mem::ram6, Mem::ram7,
+                NULL, NULL, NULL, NULL,
+                NULL, NULL, NULL, NULL,
                 Mem::rom3 };
 
             const char* pagenames[12] = { "rom0", "IDP", "rom1",
@@ -292,7 +294,7 @@ bool FileZ80::load(String sna_fn)
                 Serial.printf("compressed data length: %d\n", compDataLen);
                 Serial.printf("page: %s\n", pagenames[hdr2]);
 #endif
-                uint8_t* memPage = pages[hdr2];
+                uint8_t* memPage = (hdr2 >= 3 && hdr2 <= 10) ? Mem::bank(hdr2 - 3) : pages[hdr2];
 
                 loadCompressedMemPage(f, compDataLen, memPage, 0x4000);
                 dataOffset += compDataLen;
@@ -302,6 +304,11 @@ bool FileZ80::load(String sna_fn)
         }
     }
 
+    // RAM written behind the dirty map's back (and, with BANK_STORE, maybe
+    // the paged in banks compressed out to make room for the others)
+    Mem::updatePaging();
+    Mem::setAllDirty();
+
     // just architecturey things
     if (Config::getArch() == "128K")
     {
@@ -309,9 +316,9 @@ bool FileZ80::load(String sna_fn)
         {
 #ifdef SNAPSHOT_LOAD_FORCE_ARCH
             Config::requestMachine("48K", "SINCLAIR", true);
-            Mem::romInUse = 0;
+            Mem::selectRom(0);
 #else
-            Mem::romInUse = 1;
+            Mem::selectRom(1);
 #endif
         }
     }
@@ -320,7 +327,7 @@ bool FileZ80::load(String sna_fn)
         if (fileArch == "128K")
         {
             Config::requestMachine("128K", "SINCLAIR", true);
-            Mem::romInUse = 1;
+            Mem::selectRom(1);
         }
     }
 
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef GUEST_PROFILER
+
+#include "GuestProfiler.h"
+#include "FileUtils.h"
+#include "PS2Kbd.h"
+#include "Z80_JLS/z80.h"
+#include <FS.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_INT_FLASH
+// using internal storage (spi flash)
+#include <SPIFFS.h>
+// set The Filesystem to SPIFFS
+#define THE_FS SPIFFS
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef USE_SD_CARD
+// using external storage (SD card)
+#include <SD.h>
+// set The Filesystem to SD
+#define THE_FS SD
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define GPROF_TOP_COUNT 16
+
+MACHINE_STATE uint32_t* GuestProfiler::hotspots = NULL;
+MACHINE_STATE uint8_t* GuestProfiler::coverage = NULL;
+MACHINE_STATE uint32_t GuestProfiler::samples = 0;
+#if GUEST_PROFILER_EVERY > 0
+MACHINE_STATE uint32_t GuestProfiler::countdown = GUEST_PROFILER_EVERY;
+#endif
+
+static const char* pageName(uint8_t page)
+{
+    static const char* names[GPROF_PAGES] = {
+        "ROM0", "ROM1", "ROM2", "ROM3",
+        "RAM0", "RAM1", "RAM2", "RAM3", "RAM4", "RAM5", "RAM6", "RAM7"
+    };
+    return names[page];
+}
+
+void GuestProfiler::setup()
+{
+    if (coverage != NULL) return;
+
+    size_t histSize = GPROF_PAGES * GPROF_BUCKETS_PER_PAGE * sizeof(uint32_t);
+    size_t covSize = GPROF_PAGES * GPROF_COVERAGE_PAGE_SZ;
+
+#ifdef BOARD_HAS_PSRAM
+    hotspots = (uint32_t*)ps_calloc(1, histSize);
+    uint8_t* cov = (uint8_t*)ps_calloc(1, covSize);
+#else
+    hotspots = (uint32_t*)calloc(1, histSize);
+    uint8_t* cov = (uint8_t*)calloc(1, covSize);
+#endif
+
+    if (hotspots == NULL || cov == NULL) {
+        Serial.printf("GuestProfiler: cannot allocate %u bytes, disabled\n", histSize + covSize);
+        free(hotspots);
+        free(cov);
+        hotspots = NULL;
+        return;
+    }
+
+    // markExecuted() only checks coverage, so set it last
+    coverage = cov;
+    Serial.printf("GuestProfiler: allocated %u bytes\n", histSize + covSize);
+}
+
+void GuestProfiler::clear()
+{
+    if (coverage == NULL) return;
+
+    memset(hotspots, 0, GPROF_PAGES * GPROF_BUCKETS_PER_PAGE * sizeof(uint32_t));
+    memset(coverage, 0, GPROF_PAGES * GPROF_COVERAGE_PAGE_SZ);
+    samples = 0;
+}
+
+void GuestProfiler::sample()
+{
+    if (coverage == NULL) return;
+
+    sampleAt(Z80::getRegPC());
+}
+
+void GuestProfiler::printReport()
+{
+    if (coverage == NULL) return;
+
+    // pick the top buckets, keeping them sorted by count
+    uint32_t top[GPROF_TOP_COUNT];
+    uint16_t ntop = 0;
+    for (uint32_t i = 0; i < GPROF_PAGES * GPROF_BUCKETS_PER_PAGE; i++) {
+        uint32_t count = hotspots[i];
+        if (count == 0) continue;
+        if (ntop == GPROF_TOP_COUNT && count <= hotspots[top[ntop - 1]]) continue;
+        uint16_t j = (ntop < GPROF_TOP_COUNT) ? ntop++ : ntop - 1;
+        while (j > 0 && hotspots[top[j - 1]] < count) {
+            top[j] = top[j - 1];
+            j--;
+        }
+        top[j] = i;
+    }
+
+    Serial.printf("Guest PC hotspots (%u samples)\n", samples);
+    for (uint16_t i = 0; i < ntop; i++) {
+        uint8_t page = top[i] / GPROF_BUCKETS_PER_PAGE;
+        uint16_t start = (top[i] % GPROF_BUCKETS_PER_PAGE) << GUEST_PROFILER_BUCKET_BITS;
+        uint32_t count = hotspots[top[i]];
+        Serial.printf("%2u %s %04X-%04X %8u %5.1f%%\n", i + 1, pageName(page),
+            start, start + (1 << GUEST_PROFILER_BUCKET_BITS) - 1,
+            count, 100.0f * count / samples);
+    }
+
+    Serial.printf("Code coverage (executed bytes)\n");
+    for (uint8_t page = 0; page < GPROF_PAGES; page++) {
+        const uint8_t* bits = coverage + page * GPROF_COVERAGE_PAGE_SZ;
+        uint32_t executed = 0;
+        for (uint16_t i = 0; i < GPROF_COVERAGE_PAGE_SZ; i++)
+            executed += __builtin_popcount(bits[i]);
+        if (executed)
+            Serial.printf("%s %5u %5.1f%%\n", pageName(page), executed, 100.0f * executed / MEM_PG_SZ);
+    }
+}
+
+bool GuestProfiler::save()
+{
+    if (coverage == NULL) return false;
+
+    KB_INT_STOP;
+
+    File file = THE_FS.open(DISK_HOTSPOTS_FILE, FILE_WRITE);
+    if (!file) {
+        Serial.printf("GuestProfiler::save: failed to open %s for writing\n", DISK_HOTSPOTS_FILE);
+        KB_INT_START;
+        return false;
+    }
+    file.printf("page,address,count\n");
+    for (uint32_t i = 0; i < GPROF_PAGES * GPROF_BUCKETS_PER_PAGE; i++) {
+        if (hotspots[i] == 0) continue;
+        file.printf("%s,%04X,%u\n", pageName(i / GPROF_BUCKETS_PER_PAGE),
+            (i % GPROF_BUCKETS_PER_PAGE) << GUEST_PROFILER_BUCKET_BITS, hotspots[i]);
+    }
+    file.close();
+
+    // one bitmap per page, in page order (ROM0..3, RAM0..7), bit n of byte
+    // i set if page offset i * 8 + n was fetched as an opcode
+    file = THE_FS.open(DISK_COVERAGE_FILE, FILE_WRITE);
+    if (!file) {
+        Serial.printf("GuestProfiler::save: failed to open %s for writing\n", DISK_COVERAGE_FILE);
+        KB_INT_START;
+        return false;
+    }
+    size_t covSize = GPROF_PAGES * GPROF_COVERAGE_PAGE_SZ;
+    bool ok = (file.write(coverage, covSize) == covSize);
+    file.close();
+
+    KB_INT_START;
+    return ok;
+}
+
+#endif // GUEST_PROFILER
@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "Machine.h"
+
+#ifdef MACHINE_PER_THREAD
+
+#include "Mem.h"
+#include "Z80_JLS/z80.h"
+#include "Z80_JLS/z80operations.h"
+
+#define MACHINE_48K_FRAME  69888
+#define MACHINE_128K_FRAME 70908
+
+static MACHINE_STATE uint32_t tstates;
+static MACHINE_STATE uint32_t frameTstates = MACHINE_48K_FRAME;
+static MACHINE_STATE bool paging128;
+static MACHINE_STATE uint8_t keyRows[8];
+
+void Machine::attachMemory(uint8_t* const rom[4], uint8_t* const ram[8], bool is128K)
+{
+    for (int i = 0; i < 4; i++)
+        Mem::rom[i] = rom[i];
+    Mem::rom0 = rom[0];
+    Mem::rom1 = rom[1];
+    Mem::rom2 = rom[2];
+    Mem::rom3 = rom[3];
+
+    for (int bank = 0; bank < 8; bank++)
+        Mem::setRam(bank, ram[bank]);
+
+    paging128 = is128K;
+    frameTstates = is128K ? MACHINE_128K_FRAME : MACHINE_48K_FRAME;
+}
+
+// as ESPectrum::reset, without the video, sound and tape
+void Machine::reset()
+{
+    Mem::bankLatch = 0;
+    Mem::videoLatch = 0;
+    Mem::romLatch = 0;
+    Mem::pagingLock = paging128 ? 0 : 1;
+    Mem::modeSP3 = 0;
+    Mem::romSP3 = 0;
+    Mem::specialSP3 = 0;
+    Mem::selectRom(0);
+    Mem::setAllDirty();
+
+    Z80::create();
+    for (int row = 0; row < 8; row++)
+        keyRows[row] = 0;
+    tstates = 0;
+}
+
+uint32_t Machine::runFrame()
+{
+    tstates = 0;
+    while (tstates < frameTstates) {
+        Z80::executeUntil(frameTstates);
+        if (Z80::isHalted() && tstates < frameTstates) {
+            uint32_t steps = (frameTstates - tstates + 3) >> 2;
+            Z80::skipHalt(steps);
+            tstates += steps << 2;
+        }
+    }
+    Z80::triggerINT();
+    return tstates;
+}
+
+void Machine::setKeys(uint8_t row, uint8_t keys)
+{
+    keyRows[row & 7] = keys;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Z80Ops for the host machine: no contention, ROM written to romSink
+
+uint8_t Z80Ops::fetchOpcode(uint16_t address) {
+    tstates += 4;
+    return Mem::readbyte(address);
+}
+
+uint8_t Z80Ops::peek8(uint16_t address) {
+    tstates += 3;
+    return Mem::readbyte(address);
+}
+
+void Z80Ops::poke8(uint16_t address, uint8_t value) {
+    tstates += 3;
+    Mem::writebyte(address, value);
+}
+
+uint16_t Z80Ops::peek16(uint16_t address) {
+    uint8_t lsb = peek8(address);
+    uint8_t msb = peek8(address + 1);
+    return (msb << 8) | lsb;
+}
+
+void Z80Ops::poke16(uint16_t address, RegisterPair word) {
+    poke8(address, word.byte8.lo);
+    poke8(address + 1, word.byte8.hi);
+}
+
+// ULA: keyboard half rows selected by the high byte, EAR low
+uint8_t Z80Ops::inPort(uint16_t port) {
+    tstates += 4;
+    if (port & 0x01)
+        return 0xff;
+    uint8_t data = 0xbf;
+    for (int row = 0; row < 8; row++)
+        if (!(port & (0x100 << row)))
+            data &= ~keyRows[row];
+    return data;
+}
+
+// 128K memory control (7FFD), decoded as Ports::output does
+void Z80Ops::outPort(uint16_t port, uint8_t value) {
+    tstates += 4;
+    if (paging128 && (port & 0xC002) == 0x4000 && !Mem::pagingLock) {
+        Mem::pagingLock = (value >> 5) & 1;
+        Mem::romLatch = (value >> 4) & 1;
+        Mem::videoLatch = (value >> 3) & 1;
+        Mem::bankLatch = value & 0x7;
+        Mem::selectRom(Mem::romLatch);
+    }
+}
+
+void Z80Ops::addressOnBus(uint16_t /*address*/, int32_t wstates) {
+    tstates += wstates;
+}
+
+void Z80Ops::interruptHandlingTime(int32_t wstates) {
+    tstates += wstates;
+}
+
+uint32_t Z80Ops::getTstates(void) {
+    return tstates;
+}
+
+bool Z80Ops::isRepeatAllowed(void) {
+    return tstates < frameTstates;
+}
+
+void Z80Ops::addTstates(int32_t tstatestoadd, bool /*dovideo*/) {
+    tstates += tstatestoadd;
+}
+
+#ifdef Z80_BLOCK_CACHE
+// ROM only, as on the device (Mem::updatePaging flushes on ROM changes)
+bool Z80Ops::isCacheable(uint16_t address) {
+    #ifdef ROM_PREDECODE
+    return address < 0x4000 && !Mem::modeSP3;
+    #else
+    (void) address;
+    return false;
+    #endif
+}
+
+uint8_t Z80Ops::peekCode(uint16_t address) {
+    return Mem::readPage[address >> 14][address & 0x3fff];
+}
+#endif
+
+#ifdef ROM_HLE
+// no RomHLE on the host: everything runs on the core
+bool Z80Ops::romRoutine(uint16_t /*address*/) {
+    return false;
+}
+#endif
+
+#ifdef INSTR_TRACE
+void Z80Ops::traceInstruction(uint16_t /*address*/) {
+}
+#endif
+
+#endif // MACHINE_PER_THREAD
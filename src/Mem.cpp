@@ -29,28 +29,136 @@
 
 #include "Mem.h"
 #include <stddef.h>
+#include <string.h>
 
-uint8_t* Mem::rom0 = NULL;
-uint8_t* Mem::rom1 = NULL;
-uint8_t* Mem::rom2 = NULL;
-uint8_t* Mem::rom3 = NULL;
-uint8_t* Mem::rom[4];
-
-uint8_t* Mem::ram0 = NULL;
-uint8_t* Mem::ram1 = NULL;
-uint8_t* Mem::ram2 = NULL;
-uint8_t* Mem::ram3 = NULL;
-uint8_t* Mem::ram4 = NULL;
-uint8_t* Mem::ram5 = NULL;
-uint8_t* Mem::ram6 = NULL;
-uint8_t* Mem::ram7 = NULL;
-uint8_t* Mem::ram[8];
-
-volatile uint8_t Mem::bankLatch = 0;
-volatile uint8_t Mem::videoLatch = 0;
-volatile uint8_t Mem::romLatch = 0;
-volatile uint8_t Mem::pagingLock = 0;
-uint8_t Mem::modeSP3 = 0;
-uint8_t Mem::romSP3 = 0;
-uint8_t Mem::romInUse = 0;
+#ifdef RAM_MIGRATION
+#include "RamPlacement.h"
+#endif
 
+#ifdef BANK_STORE
+#include "BankStore.h"
+#endif
+
+#ifdef ROM_PREDECODE
+#include "Z80_JLS/z80.h"
+#endif
+
+MACHINE_STATE uint8_t* Mem::rom0 = NULL;
+MACHINE_STATE uint8_t* Mem::rom1 = NULL;
+MACHINE_STATE uint8_t* Mem::rom2 = NULL;
+MACHINE_STATE uint8_t* Mem::rom3 = NULL;
+MACHINE_STATE uint8_t* Mem::rom[4];
+
+MACHINE_STATE uint8_t* Mem::ram0 = NULL;
+MACHINE_STATE uint8_t* Mem::ram1 = NULL;
+MACHINE_STATE uint8_t* Mem::ram2 = NULL;
+MACHINE_STATE uint8_t* Mem::ram3 = NULL;
+MACHINE_STATE uint8_t* Mem::ram4 = NULL;
+MACHINE_STATE uint8_t* Mem::ram5 = NULL;
+MACHINE_STATE uint8_t* Mem::ram6 = NULL;
+MACHINE_STATE uint8_t* Mem::ram7 = NULL;
+MACHINE_STATE uint8_t* Mem::ram[8];
+
+MACHINE_STATE volatile uint8_t Mem::bankLatch = 0;
+MACHINE_STATE volatile uint8_t Mem::videoLatch = 0;
+MACHINE_STATE volatile uint8_t Mem::romLatch = 0;
+MACHINE_STATE volatile uint8_t Mem::pagingLock = 0;
+MACHINE_STATE uint8_t Mem::modeSP3 = 0;
+MACHINE_STATE uint8_t Mem::romSP3 = 0;
+MACHINE_STATE uint8_t Mem::specialSP3 = 0;
+MACHINE_STATE bool Mem::plus3Paging = false;
+MACHINE_STATE uint8_t Mem::romInUse = 0;
+MACHINE_STATE uint8_t* Mem::readPage[4];
+MACHINE_STATE uint8_t* Mem::writePage[4];
+MACHINE_STATE uint16_t Mem::writeMask[4] = { 0, 0x3fff, 0x3fff, 0x3fff };
+MACHINE_STATE uint8_t Mem::romSink;
+MACHINE_STATE uint8_t Mem::dirty[9 * MEM_DIRTY_BLOCKS];
+MACHINE_STATE uint8_t* Mem::writeDirty[4];
+#ifdef RAM_MIGRATION
+MACHINE_STATE uint8_t Mem::accessSample = RAM_MIGRATION_SAMPLE;
+#endif
+
+// 0-1-2-3, 4-5-6-7, 4-5-6-3 and 4-7-6-3
+const uint8_t Mem::specialBanks[4][4] = {
+    { 0, 1, 2, 3 },
+    { 4, 5, 6, 7 },
+    { 4, 5, 6, 3 },
+    { 4, 7, 6, 3 },
+};
+
+void Mem::updatePaging()
+{
+    #ifdef BANK_STORE
+    BankStore::map();
+    #endif
+
+    #ifdef ROM_PREDECODE
+    // the ROM translations only go with a change of page 0, not on every
+    // bank switch
+    const uint8_t* page0 = readPage[0];
+    #endif
+
+    if (modeSP3) {
+        for (int slot = 0; slot < 4; slot++) {
+            uint8_t bank = specialBanks[specialSP3][slot];
+            readPage[slot] = writePage[slot] = ram[bank];
+            writeMask[slot] = 0x3fff;
+            writeDirty[slot] = dirty + bank * MEM_DIRTY_BLOCKS;
+        }
+    } else {
+        readPage[0] = rom[romInUse];
+        readPage[1] = ram5;
+        readPage[2] = ram2;
+        readPage[3] = ram[bankLatch];
+        writePage[0] = &romSink;
+        writePage[1] = ram5;
+        writePage[2] = ram2;
+        writePage[3] = ram[bankLatch];
+        writeMask[0] = 0;
+        writeDirty[0] = dirty + 8 * MEM_DIRTY_BLOCKS;
+        writeDirty[1] = dirty + 5 * MEM_DIRTY_BLOCKS;
+        writeDirty[2] = dirty + 2 * MEM_DIRTY_BLOCKS;
+        writeDirty[3] = dirty + bankLatch * MEM_DIRTY_BLOCKS;
+    }
+
+    #ifdef ROM_PREDECODE
+    if (readPage[0] != page0)
+        Z80::flushBlocks();
+    #endif
+}
+
+void Mem::setRam(uint8_t bank, uint8_t* page)
+{
+    uint8_t** alias[8] = {
+        &ram0, &ram1, &ram2, &ram3,
+        &ram4, &ram5, &ram6, &ram7,
+    };
+    ram[bank] = *alias[bank] = page;
+}
+
+uint8_t* Mem::bank(uint8_t n)
+{
+    #ifdef BANK_STORE
+    return BankStore::get(n);
+    #else
+    return ram[n];
+    #endif
+}
+
+bool Mem::isBankDirty(uint8_t bank)
+{
+    const uint8_t* blocks = dirty + bank * MEM_DIRTY_BLOCKS;
+    for (int i = 0; i < MEM_DIRTY_BLOCKS; i++)
+        if (blocks[i]) return true;
+    return false;
+}
+
+void Mem::clearDirty(uint8_t bank)
+{
+    memset(dirty + bank * MEM_DIRTY_BLOCKS, 0, MEM_DIRTY_BLOCKS);
+}
+
+void Mem::setAllDirty()
+{
+    memset(dirty, 1, 8 * MEM_DIRTY_BLOCKS);
+}
@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef MEM_HEATMAP
+
+#include "MemHeatmap.h"
+#include "ESPectrum.h"
+#include "osd.h"
+#include "PS2Kbd.h"
+#include "Wiimote2Keys.h"
+
+#define HEAT_COUNTERS (HEAT_PAGES * HEAT_BLOCKS_PER_PAGE * HEAT_KINDS)
+
+// printMap() levels, each one about 8 times more accesses
+static const char heatLevels[] = " .:-=+*#%@";
+#define HEAT_LEVELS (sizeof(heatLevels) - 1)
+
+// drawChart() label width, in characters
+#define HEAT_LABEL_COLS 5
+
+MACHINE_STATE uint32_t* MemHeatmap::counts = NULL;
+
+static const char* pageName(uint8_t page)
+{
+    static const char* names[HEAT_PAGES] = {
+        "ROM0", "ROM1", "ROM2", "ROM3",
+        "RAM0", "RAM1", "RAM2", "RAM3", "RAM4", "RAM5", "RAM6", "RAM7"
+    };
+    return names[page];
+}
+
+void MemHeatmap::setup()
+{
+    if (counts != NULL) return;
+
+    size_t size = HEAT_COUNTERS * sizeof(uint32_t);
+
+#ifdef BOARD_HAS_PSRAM
+    counts = (uint32_t*)ps_calloc(1, size);
+#else
+    counts = (uint32_t*)calloc(1, size);
+#endif
+
+    if (counts == NULL)
+        Serial.printf("MemHeatmap: cannot allocate %u bytes, disabled\n", size);
+    else
+        Serial.printf("MemHeatmap: allocated %u bytes\n", size);
+}
+
+void MemHeatmap::clear()
+{
+    if (counts == NULL) return;
+
+    memset(counts, 0, HEAT_COUNTERS * sizeof(uint32_t));
+}
+
+uint32_t MemHeatmap::pageTotal(uint8_t page, uint8_t kind)
+{
+    const uint32_t* c = counts + page * HEAT_BLOCKS_PER_PAGE * HEAT_KINDS;
+    uint32_t total = 0;
+    for (int block = 0; block < HEAT_BLOCKS_PER_PAGE; block++)
+        total += c[block * HEAT_KINDS + kind];
+    return total;
+}
+
+void MemHeatmap::printCSV()
+{
+    if (counts == NULL) return;
+
+    Serial.printf("page,address,reads,writes,fetches\n");
+    for (uint32_t block = 0; block < HEAT_PAGES * HEAT_BLOCKS_PER_PAGE; block++) {
+        const uint32_t* c = counts + block * HEAT_KINDS;
+        if (c[HEAT_READ] == 0 && c[HEAT_WRITE] == 0 && c[HEAT_FETCH] == 0) continue;
+        Serial.printf("%s,%04X,%u,%u,%u\n", pageName(block / HEAT_BLOCKS_PER_PAGE),
+            (block % HEAT_BLOCKS_PER_PAGE) * MEM_DIRTY_BLOCK_SZ,
+            c[HEAT_READ], c[HEAT_WRITE], c[HEAT_FETCH]);
+    }
+}
+
+void MemHeatmap::printMap()
+{
+    if (counts == NULL) return;
+
+    char line[HEAT_BLOCKS_PER_PAGE + 1];
+    line[HEAT_BLOCKS_PER_PAGE] = '\0';
+
+    Serial.printf("Memory accesses per 256 bytes, '%s' (none to most)\n", heatLevels);
+    for (uint8_t page = 0; page < HEAT_PAGES; page++) {
+        const uint32_t* c = counts + page * HEAT_BLOCKS_PER_PAGE * HEAT_KINDS;
+        for (int block = 0; block < HEAT_BLOCKS_PER_PAGE; block++) {
+            const uint32_t* b = c + block * HEAT_KINDS;
+            uint32_t total = b[HEAT_READ] + b[HEAT_WRITE] + b[HEAT_FETCH];
+            uint8_t level = 0;
+            if (total) {
+                level = 1 + (31 - __builtin_clz(total)) / 3;
+                if (level >= HEAT_LEVELS) level = HEAT_LEVELS - 1;
+            }
+            line[block] = heatLevels[level];
+        }
+        Serial.printf("%s |%s|\n", pageName(page), line);
+    }
+
+    // what breaks predecoded code: 'W' code written, 'x' code only
+    Serial.printf("Code blocks, W: also written (self-modifying), x: only fetched\n");
+    for (uint8_t page = 0; page < HEAT_PAGES; page++) {
+        const uint32_t* c = counts + page * HEAT_BLOCKS_PER_PAGE * HEAT_KINDS;
+        bool code = false;
+        for (int block = 0; block < HEAT_BLOCKS_PER_PAGE; block++) {
+            const uint32_t* b = c + block * HEAT_KINDS;
+            line[block] = b[HEAT_FETCH] == 0 ? ' ' : b[HEAT_WRITE] ? 'W' : 'x';
+            code |= b[HEAT_FETCH] != 0;
+        }
+        if (code)
+            Serial.printf("%s |%s|\n", pageName(page), line);
+    }
+}
+
+void MemHeatmap::drawChart()
+{
+    if (counts == NULL) return;
+
+    VGA& vga = ESPectrum::vga;
+
+    static const uint8_t kinds[HEAT_KINDS] = { HEAT_FETCH, HEAT_READ, HEAT_WRITE };
+    static const uint8_t colors[HEAT_KINDS] = { 4, 5, 2 };
+    static const char* legend[HEAT_KINDS] = { "FETCH ", "READ ", "WRITE" };
+
+    uint32_t totals[HEAT_PAGES][HEAT_KINDS];
+    uint32_t most = 1;
+    for (uint8_t page = 0; page < HEAT_PAGES; page++) {
+        uint32_t sum = 0;
+        for (uint8_t k = 0; k < HEAT_KINDS; k++)
+            sum += totals[page][k] = pageTotal(page, kinds[k]);
+        if (sum > most) most = sum;
+    }
+
+    OSD::drawOSD();
+    vga.setTextColor(OSD::zxColor(7, 0), OSD::zxColor(1, 0));
+    OSD::osdAt(1, 0);
+    vga.print("Memory accesses per page");
+
+    unsigned short width = (OSD::osdMaxCols() - HEAT_LABEL_COLS) * OSD_FONT_W;
+    for (uint8_t page = 0; page < HEAT_PAGES; page++) {
+        OSD::osdAt(3 + page, 0);
+        vga.print(pageName(page));
+
+        unsigned short x = OSD::osdInsideX() + HEAT_LABEL_COLS * OSD_FONT_W;
+        unsigned short y = OSD::osdInsideY() + (3 + page) * OSD_FONT_H + 1;
+        for (uint8_t k = 0; k < HEAT_KINDS; k++) {
+            unsigned short w = (uint64_t)totals[page][k] * width / most;
+            if (w == 0) continue;
+            vga.fillRect(x, y, w, OSD_FONT_H - 2, OSD::zxColor(colors[k], 1));
+            x += w;
+        }
+    }
+
+    OSD::osdAt(16, HEAT_LABEL_COLS);
+    for (uint8_t k = 0; k < HEAT_KINDS; k++) {
+        vga.setTextColor(OSD::zxColor(colors[k], 1), OSD::zxColor(1, 0));
+        vga.print(legend[k]);
+    }
+
+    while (!PS2Keyboard::checkAndCleanKey(KEY_ESC) &&
+           !PS2Keyboard::checkAndCleanKey(KEY_ENTER)) {
+        vTaskDelay(5);
+        updateWiimote2KeysOSD();
+    }
+}
+
+#endif // MEM_HEATMAP
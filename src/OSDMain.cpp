@@ -41,6 +41,19 @@
 #include "Mem.h"
 #include "Tape.h"
 #include "pwm_audio.h"
+#include "Z80_JLS/z80.h"
+
+#ifdef GUEST_PROFILER
+#include "GuestProfiler.h"
+#endif
+
+#ifdef MEM_HEATMAP
+#include "MemHeatmap.h"
+#endif
+
+#ifdef INSTR_TRACE
+#include "Trace.h"
+#endif
 
 #define MENU_REDRAW true
 #define MENU_UPDATE false
@@ -228,6 +241,64 @@ void OSD::do_OSD() {
                 pwm_audio_set_volume(ESPectrum::aud_volume);
         }
     }    
+#ifdef Z80_PROFILER
+    else if (PS2Keyboard::checkAndCleanKey(KEY_F11)) {
+        // Opcode profile over Serial
+        Z80::profileDump(stdout);
+    }
+    else if (PS2Keyboard::checkAndCleanKey(KEY_F12)) {
+        // Opcode profile to SPIFFS, then start a new one
+        FILE* f = fopen("/spiffs" DISK_PROFILE_FILE, "w");
+        if (f != NULL) {
+            Z80::profileDump(f);
+            fclose(f);
+            Serial.printf("Profile saved to %s\n", DISK_PROFILE_FILE);
+        }
+        Z80::profileReset();
+    }
+#endif
+#ifdef GUEST_PROFILER
+    else if (PS2Keyboard::checkAndCleanKey(KEY_F8)) {
+        // Guest PC hotspots and code coverage
+        byte opt = menuRun(MENU_GUEST_PROF);
+        if (opt == 1) {
+            GuestProfiler::printReport();
+        }
+        else if (opt == 2) {
+            if (GuestProfiler::save())
+                osdCenteredMsg(OSD_GPROF_SAVED, LEVEL_INFO);
+            else
+                osdCenteredMsg(OSD_GPROF_SAVE_ERR, LEVEL_WARN);
+        }
+        else if (opt == 3) {
+            GuestProfiler::clear();
+        }
+    }
+#endif
+#ifdef MEM_HEATMAP
+    else if (PS2Keyboard::checkAndCleanKey(KEY_PRINT_SCREEN)) {
+        // Memory access heatmap
+        byte opt = menuRun(MENU_MEM_HEATMAP);
+        if (opt == 1) {
+            MemHeatmap::printCSV();
+        }
+        else if (opt == 2) {
+            MemHeatmap::printMap();
+        }
+        else if (opt == 3) {
+            MemHeatmap::drawChart();
+        }
+        else if (opt == 4) {
+            MemHeatmap::clear();
+        }
+    }
+#endif
+#ifdef INSTR_TRACE
+    else if (PS2Keyboard::checkAndCleanKey(KEY_SCROLL_LOCK)) {
+        // Instruction trace over Serial
+        Trace::dump();
+    }
+#endif
 /*  // Testing code
     else if (PS2Keyboard::checkAndCleanKey(KEY_F11)) {
         ESPectrum::ESPoffset-=50;
@@ -346,6 +417,22 @@ void OSD::do_OSD() {
                 updateWiimote2KeysOSD();
             }
         }
+#ifdef Z80_FAST_CORE
+        else if (opt == 11) {
+            // CPU core, remembered for the current snapshot
+            byte opt2;
+            if (CPU::core == CPU_CORE_FAST)
+                opt2 = menuRun(MENU_CORE_FAST);
+            else
+                opt2 = menuRun(MENU_CORE_PRECISE);
+            if (opt2 > 0) {
+                bool fast = (opt2 == 2);
+                CPU::setCore(fast ? CPU_CORE_FAST : CPU_CORE_PRECISE);
+                Config::setFastCore(Config::ram_file, fast);
+                Config::save();
+            }
+        }
+#endif
         
         AySound::enable();
         // Exit
@@ -471,6 +558,9 @@ void OSD::changeSnapshot(String filename)
         Serial.printf("Loading Z80: %s\n", filename.c_str());
         FileZ80::load((String)DISK_SNA_DIR + "/" + filename);
     }
+#ifdef Z80_FAST_CORE
+    CPU::setCore(Config::isFastCore(filename) ? CPU_CORE_FAST : CPU_CORE_PRECISE);
+#endif
     osdCenteredMsg(MSG_SAVE_CONFIG, LEVEL_WARN);
     Config::ram_file = filename;
     Config::save();
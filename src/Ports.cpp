@@ -39,10 +39,10 @@
 #include <Arduino.h>
 
 // Ports
-volatile uint8_t Ports::base[128];
-volatile uint8_t Ports::wii[128];
+MACHINE_STATE volatile uint8_t Ports::base[128];
+MACHINE_STATE volatile uint8_t Ports::wii[128];
 
-static uint8_t port_data = 0;
+static MACHINE_STATE uint8_t port_data = 0;
 
 #ifdef ZX_KEYB_PRESENT
 const int psKR[] = {AD8, AD9, AD10, AD11, AD12, AD13, AD14, AD15};
@@ -198,7 +198,7 @@ uint8_t Ports::input(uint8_t portLow, uint8_t portHigh)
     return data;
 }
 
-int Audiobit, Tapebit;
+MACHINE_STATE int Audiobit, Tapebit;
 
 void Ports::output(uint8_t portLow, uint8_t portHigh, uint8_t data) {
     // Serial.printf("%02X,%02X:%02X|", portHigh, portLow, data);
@@ -248,18 +248,21 @@ void Ports::output(uint8_t portLow, uint8_t portHigh, uint8_t data) {
                 Mem::romLatch = bitRead(data, 4);
                 Mem::videoLatch = bitRead(data, 3);
                 Mem::bankLatch = data & 0x7;
-                bitWrite(Mem::romInUse, 1, Mem::romSP3);
-                bitWrite(Mem::romInUse, 0, Mem::romLatch);
+                Mem::selectRom((Mem::romSP3 << 1) | Mem::romLatch);
+                CPU::updateContention();
             }
         }
         
-        // +2A / +3 Secondary Memory Control
-        if ((portHigh & 0xF0) == 0x01)
+        // +2A / +3 Secondary Memory Control (0x1FFD), locked along with 0x7FFD
+        if ((portHigh & 0xF0) == 0x10 && Mem::plus3Paging)
         {
-            Mem::modeSP3 = bitRead(data, 0);
-            Mem::romSP3 = bitRead(data, 2);
-            bitWrite(Mem::romInUse, 1, Mem::romSP3);
-            bitWrite(Mem::romInUse, 0, Mem::romLatch);
+            if (!Mem::pagingLock) {
+                Mem::modeSP3 = bitRead(data, 0);
+                Mem::specialSP3 = (data >> 1) & 0x03;
+                Mem::romSP3 = bitRead(data, 2);
+                Mem::selectRom((Mem::romSP3 << 1) | Mem::romLatch);
+                CPU::updateContention();
+            }
         }
 
     }
@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef RAM_MIGRATION
+
+#include <Arduino.h>
+#include <string.h>
+#include "soc/soc_memory_layout.h"
+#include "RamPlacement.h"
+#include "Mem.h"
+
+MACHINE_STATE uint32_t RamPlacement::use[8];
+MACHINE_STATE uint32_t RamPlacement::score[8];
+MACHINE_STATE bool RamPlacement::inSram[8];
+MACHINE_STATE uint16_t RamPlacement::frames = 0;
+
+// RAM bank in each slot, from its dirty map row (8 for ROM)
+static uint8_t slotBank(uint8_t slot)
+{
+    return (Mem::writeDirty[slot] - Mem::dirty) / MEM_DIRTY_BLOCKS;
+}
+
+void RamPlacement::setup()
+{
+    for (int bank = 0; bank < 8; bank++) {
+        inSram[bank] = Mem::ram[bank] != NULL && !esp_ptr_external_ram(Mem::ram[bank]);
+        use[bank] = score[bank] = 0;
+    }
+    frames = 0;
+}
+
+void IRAM_ATTR RamPlacement::sample(uint8_t slot)
+{
+    Mem::accessSample = RAM_MIGRATION_SAMPLE;
+
+    uint8_t bank = slotBank(slot);
+    if (bank < 8) use[bank]++;
+}
+
+void RamPlacement::frameEnd()
+{
+    // about the last 8 frames
+    for (int bank = 0; bank < 8; bank++) {
+        score[bank] = score[bank] - (score[bank] >> 3) + use[bank];
+        use[bank] = 0;
+    }
+
+    if (++frames < RAM_MIGRATION_FRAMES) return;
+    frames = 0;
+
+    int hot = -1, cold = -1;
+    for (int bank = 0; bank < 8; bank++) {
+        if (Mem::ram[bank] == NULL) continue;
+        if (inSram[bank]) {
+            if (cold < 0 || score[bank] < score[cold]) cold = bank;
+        } else {
+            if (hot < 0 || score[bank] > score[hot]) hot = bank;
+        }
+    }
+
+    if (hot < 0 || cold < 0) return;
+    if (score[hot] <= 2 * score[cold]) return;
+
+    swapBanks(hot, cold);
+}
+
+// exchange contents and pages, so the banks keep their data at new places
+void RamPlacement::swapBanks(uint8_t toSram, uint8_t toPsram)
+{
+    uint8_t* sramPage = Mem::ram[toPsram];
+    uint8_t* psramPage = Mem::ram[toSram];
+
+    uint8_t tmp[256];
+    for (int offset = 0; offset < MEM_PG_SZ; offset += sizeof(tmp)) {
+        memcpy(tmp, sramPage + offset, sizeof(tmp));
+        memcpy(sramPage + offset, psramPage + offset, sizeof(tmp));
+        memcpy(psramPage + offset, tmp, sizeof(tmp));
+    }
+
+    Mem::setRam(toSram, sramPage);
+    Mem::setRam(toPsram, psramPage);
+    inSram[toSram] = true;
+    inSram[toPsram] = false;
+
+    Mem::updatePaging();
+
+    Serial.printf("RAM%d moved into SRAM, RAM%d into PSRAM\n", toSram, toPsram);
+}
+
+#endif // RAM_MIGRATION
@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef ROM_HLE
+
+#include <Arduino.h>
+#include "RomHLE.h"
+#include "CPU.h"
+#include "Mem.h"
+#include "Z80_JLS/z80.h"
+
+// BEEPER (03B5) half period, from BE-H&L-LP:
+//   03D6 DEC C / JR NZ,03D6 / LD C,3F / DEC B / JP NZ,03D6
+// then the edge is written by the OUT (FE),A at 03E1 (not emulated here,
+// so the beeper samples are taken exactly as without ROM_HLE)
+#define BEEPER_LOOP 0x03D6
+#define BEEPER_EXIT 0x03DF
+static const uint8_t beeperLoop[] = { 0x0D, 0x20, 0xFD, 0x0E, 0x3F, 0x05, 0xC2, 0xD6, 0x03 };
+
+// DJNZ $ delays: SA-LEADER, SA-SYNC-1, SA-SYNC-2, SA-BIT-2, SA-BIT-1,
+// SA-DELAY and LD-WAIT
+static const uint16_t djnzDelays[] = { 0x04D8, 0x04EA, 0x04F2, 0x0514, 0x051A, 0x053C, 0x0574 };
+static const uint8_t djnzSelf[] = { 0x10, 0xFE };
+
+// F after DEC r left 'value' in r (carry is kept)
+static uint8_t decFlags(uint8_t value, uint8_t flags)
+{
+    return (flags & 0x01) | 0x02 | (value & 0xa8) | (value ? 0 : 0x40)
+        | ((value & 0x0f) == 0x0f ? 0x10 : 0) | (value == 0x7f ? 0x04 : 0);
+}
+
+// R counts M1 cycles in its low 7 bits
+static void addRegR(uint32_t fetches)
+{
+    uint8_t r = Z80::getRegR();
+    Z80::setRegR((r & 0x80) | ((r + fetches) & 0x7f));
+}
+
+void RomHLE::setup()
+{
+    Z80::setRomHook(BEEPER_LOOP);
+    for (uint16_t site : djnzDelays)
+        Z80::setRomHook(site);
+}
+
+bool IRAM_ATTR RomHLE::run(uint16_t pc, uint32_t deadline)
+{
+    // an INT would be accepted after the next instruction
+    if (Z80::isIFF1() && Z80::isINT()) return false;
+
+    if (CPU::tstates >= deadline) return false;
+
+    if (pc == BEEPER_LOOP)
+        return beeperDelay(deadline);
+
+    for (uint16_t site : djnzDelays)
+        if (pc == site)
+            return djnzDelay(pc, deadline);
+
+    return false;
+}
+
+// Code at pc must be the one expected (other ROMs, paged RAM) and must be
+// fetched without contention, so every pass takes the same time
+bool IRAM_ATTR RomHLE::matches(uint16_t pc, const uint8_t* code, uint8_t len)
+{
+    if (ADDRESS_CONTENDED(pc)) return false;
+
+    for (int i = 0; i < len; i++)
+        if (Mem::readbyte(pc + i) != code[i]) return false;
+
+    return true;
+}
+
+// Inner pass, back to 03D6: DEC C (4), JR NZ taken (12).
+// Last inner pass, on to 03D6 or 03DF: DEC C (4), JR NZ not taken (7),
+// LD C,3F (7), DEC B (4), JP NZ (10).
+// Both end on a jump that leaves MEMPTR at 03D6. The time is given to the
+// machine at the end, through CPU::skipTstates so the renderer still gets
+// it in the steps it draws.
+bool IRAM_ATTR RomHLE::beeperDelay(uint32_t deadline)
+{
+    if (!matches(BEEPER_LOOP, beeperLoop, sizeof(beeperLoop))) return false;
+
+    uint8_t b = Z80::getRegB();
+    uint8_t c = Z80::getRegC();
+    uint8_t flags = Z80::getRegAF() & 0xff;
+    uint16_t pc = BEEPER_LOOP;
+    uint32_t left = deadline - CPU::tstates;
+    uint32_t used = 0;
+    uint32_t fetches = 0;
+
+    // every pass must end before the deadline, as the interpreter stops
+    // on the first instruction that reaches it
+    for (;;) {
+        if (c != 1) {
+            uint32_t passes = (uint8_t)(c - 1);
+            uint32_t room = (left - used - 1) >> 4;
+            if (passes > room) passes = room;
+            if (passes == 0) break;
+            c -= passes;
+            used += passes << 4;
+            fetches += passes << 1;
+            flags = decFlags(c, flags);
+            if (c != 1) break;
+        }
+        if (left - used <= 32) break;
+        b--;
+        c = 0x3f;
+        used += 32;
+        fetches += 5;
+        flags = decFlags(b, flags);
+        if (b == 0) {
+            pc = BEEPER_EXIT;
+            break;
+        }
+    }
+
+    if (used == 0) return false;
+
+    Z80::setRegBC((b << 8) | c);
+    Z80::setRegAF((Z80::getRegA() << 8) | flags);
+    Z80::setMemPtr(BEEPER_LOOP);
+    Z80::setRegPC(pc);
+    addRegR(fetches);
+    CPU::skipTstates(used);
+
+    return true;
+}
+
+// Taken DJNZ: M1 (4), IR on the bus (1), offset (3), PC on the bus (5).
+// The last one, not taken (8), is left to the interpreter.
+bool IRAM_ATTR RomHLE::djnzDelay(uint16_t pc, uint32_t deadline)
+{
+    if (ADDRESS_CONTENDED(Z80::getRegI() << 8)) return false;
+
+    if (!matches(pc, djnzSelf, sizeof(djnzSelf))) return false;
+
+    uint8_t b = Z80::getRegB();
+    uint32_t passes = (uint8_t)(b - 1);
+    uint32_t room = (deadline - CPU::tstates - 1) / 13;
+    if (passes > room) passes = room;
+    if (passes == 0) return false;
+
+    Z80::setRegB(b - passes);
+    Z80::setMemPtr(pc);
+    addRegR(passes);
+    CPU::skipTstates(passes * 13);
+
+    return true;
+}
+
+#endif // ROM_HLE
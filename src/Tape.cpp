@@ -4,23 +4,23 @@
 #include "Tape.h"
 #include "Ports.h"
 
-String Tape::tapeFileName = "none";
-byte Tape::tapeStatus = TAPE_STOPPED;
-byte Tape::SaveStatus = SAVE_STOPPED;
-uint8_t Tape::romLoading = false;
+MACHINE_STATE String Tape::tapeFileName = "none";
+MACHINE_STATE byte Tape::tapeStatus = TAPE_STOPPED;
+MACHINE_STATE byte Tape::SaveStatus = SAVE_STOPPED;
+MACHINE_STATE uint8_t Tape::romLoading = false;
 
-static uint8_t tapePhase;
-static uint64_t tapeStart;
-static uint32_t tapePulseCount;
-static uint16_t tapeBitPulseLen;   
-static uint8_t tapeBitPulseCount;     
-static uint32_t tapebufByteCount;
-static uint16_t tapeHdrPulses;
-static uint32_t tapeBlockLen;
-static size_t tapeFileSize;   
-static uint8_t* tape;
-static uint8_t tapeEarBit;
-static uint8_t tapeBitMask;    
+static MACHINE_STATE uint8_t tapePhase;
+static MACHINE_STATE uint64_t tapeStart;
+static MACHINE_STATE uint32_t tapePulseCount;
+static MACHINE_STATE uint16_t tapeBitPulseLen;   
+static MACHINE_STATE uint8_t tapeBitPulseCount;     
+static MACHINE_STATE uint32_t tapebufByteCount;
+static MACHINE_STATE uint16_t tapeHdrPulses;
+static MACHINE_STATE uint32_t tapeBlockLen;
+static MACHINE_STATE size_t tapeFileSize;   
+static MACHINE_STATE uint8_t* tape;
+static MACHINE_STATE uint8_t tapeEarBit;
+static MACHINE_STATE uint8_t tapeBitMask;    
 
 void Tape::Init()
 {
@@ -67,26 +67,26 @@ void Tape::TAP_Play()
         tapeHdrPulses=TAPE_HDR_LONG;
         tapeBlockLen=(tape[0] | (tape[1] <<8)) + 2;
         tapebufByteCount=2;
-        tapeStart=CPU::global_tstates;
+        tapeStart=CPU::getGlobalTstates();
         Tape::tapeStatus=TAPE_LOADING;
         break;
     case TAPE_LOADING:
         Tape::tapeStatus=TAPE_PAUSED;
         break;
     case TAPE_PAUSED:
-        tapeStart=CPU::global_tstates;        
+        tapeStart=CPU::getGlobalTstates();        
         Tape::tapeStatus=TAPE_LOADING;
     }
 }
 
 uint8_t Tape::TAP_Read()
 {
-    uint64_t tapeCurrent = CPU::global_tstates - tapeStart;
+    uint64_t tapeCurrent = CPU::getGlobalTstates() - tapeStart;
     
     switch (tapePhase) {
     case TAPE_PHASE_SYNC:
         if (tapeCurrent > TAPE_SYNC_LEN) {
-            tapeStart=CPU::global_tstates;
+            tapeStart=CPU::getGlobalTstates();
             tapeEarBit ^= 1;
             tapePulseCount++;
             if (tapePulseCount>tapeHdrPulses) {
@@ -97,14 +97,14 @@ uint8_t Tape::TAP_Read()
         break;
     case TAPE_PHASE_SYNC1:
         if (tapeCurrent > TAPE_SYNC1_LEN) {
-            tapeStart=CPU::global_tstates;
+            tapeStart=CPU::getGlobalTstates();
             tapeEarBit ^= 1;
             tapePhase=TAPE_PHASE_SYNC2;
         }
         break;
     case TAPE_PHASE_SYNC2:
         if (tapeCurrent > TAPE_SYNC2_LEN) {
-            tapeStart=CPU::global_tstates;
+            tapeStart=CPU::getGlobalTstates();
             tapeEarBit ^= 1;
             if (tape[tapebufByteCount] & tapeBitMask) tapeBitPulseLen=TAPE_BIT1_PULSELEN; else tapeBitPulseLen=TAPE_BIT0_PULSELEN;            
             tapePhase=TAPE_PHASE_DATA;
@@ -112,7 +112,7 @@ uint8_t Tape::TAP_Read()
         break;
     case TAPE_PHASE_DATA:
         if (tapeCurrent > tapeBitPulseLen) {
-            tapeStart=CPU::global_tstates;
+            tapeStart=CPU::getGlobalTstates();
             tapeEarBit ^= 1;
             tapeBitPulseCount++;
             if (tapeBitPulseCount==2) {
@@ -133,7 +133,7 @@ uint8_t Tape::TAP_Read()
     case TAPE_PHASE_PAUSE:
         if (tapebufByteCount < tapeFileSize) {
             if (tapeCurrent > TAPE_BLK_PAUSELEN) {
-                tapeStart=CPU::global_tstates;
+                tapeStart=CPU::getGlobalTstates();
                 tapePulseCount=0;
                 tapePhase=TAPE_PHASE_SYNC;
                 tapeBlockLen+=(tape[tapebufByteCount] | tape[tapebufByteCount + 1] <<8)+ 2;
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+#include "hardconfig.h"
+
+#ifdef INSTR_TRACE
+
+#include <Arduino.h>
+#include "Trace.h"
+#include "CPU.h"
+#include "Mem.h"
+#include "Z80_JLS/z80.h"
+
+#define TRACE_RING_SZ (INSTR_TRACE_BLOCKS * TRACE_BLOCK_SZ)
+
+MACHINE_STATE uint8_t* Trace::ring = NULL;
+MACHINE_STATE uint8_t Trace::block = 0;
+MACHINE_STATE uint8_t Trace::filled = 0;
+MACHINE_STATE uint16_t Trace::pos = 0;
+MACHINE_STATE uint16_t Trace::lastPC = 0;
+MACHINE_STATE uint8_t Trace::lastBank = 0;
+MACHINE_STATE uint32_t Trace::lastTstates = 0;
+MACHINE_STATE bool Trace::crashed = false;
+
+void Trace::setup()
+{
+    if (ring != NULL) return;
+
+    // internal RAM: record() writes here on every instruction
+    ring = (uint8_t*)calloc(1, TRACE_RING_SZ);
+    if (ring == NULL) {
+        Serial.printf("Trace: cannot allocate %u bytes, disabled\n", TRACE_RING_SZ);
+        return;
+    }
+
+    Serial.printf("Trace: allocated %u bytes\n", TRACE_RING_SZ);
+    clear();
+    Z80::setTrace(true);
+}
+
+void Trace::clear()
+{
+    if (ring == NULL) return;
+
+    lastPC = 0;
+    lastBank = bankState();
+    lastTstates = CPU::getGlobalTstates();
+    crashed = false;
+
+    filled = 0;
+    block = INSTR_TRACE_BLOCKS - 1;
+    newBlock();
+}
+
+// paged memory state: bank (0-2), screen (3), rom (4-5), +3 special mode (6), paging locked (7)
+uint8_t Trace::bankState()
+{
+    return Mem::bankLatch | (Mem::videoLatch << 3) | (Mem::romInUse << 4)
+         | (Mem::modeSP3 << 6) | (Mem::pagingLock << 7);
+}
+
+void Trace::newBlock()
+{
+    block = (block + 1) % INSTR_TRACE_BLOCKS;
+    if (filled < INSTR_TRACE_BLOCKS) filled++;
+
+    uint8_t* p = ring + block * TRACE_BLOCK_SZ;
+    *p++ = lastPC;
+    *p++ = lastPC >> 8;
+    *p++ = lastBank;
+    *p++ = lastTstates;
+    *p++ = lastTstates >> 8;
+    *p++ = lastTstates >> 16;
+    *p++ = lastTstates >> 24;
+    *p = 0;
+
+    pos = block * TRACE_BLOCK_SZ + TRACE_KEYFRAME_SZ;
+}
+
+void IRAM_ATTR Trace::record(uint16_t pc)
+{
+    // room for a record and the end of block mark
+    if (pos + TRACE_RECORD_MAX >= (block + 1) * TRACE_BLOCK_SZ)
+        newBlock();
+
+    uint8_t* p = ring + pos;
+    uint8_t* hdr = p++;
+    uint8_t flags = TRACE_REC;
+
+    uint16_t step = pc - lastPC;
+    if (step >= 1 && step <= 6) {
+        flags |= step << TRACE_PC_SHIFT;
+    } else if ((uint16_t)(step + 0x80) < 0x100) {
+        flags |= TRACE_PC_REL8 << TRACE_PC_SHIFT;
+        *p++ = step;
+    } else {
+        flags |= TRACE_PC_ABS << TRACE_PC_SHIFT;
+        *p++ = pc;
+        *p++ = pc >> 8;
+    }
+    lastPC = pc;
+
+    uint8_t bank = bankState();
+    if (bank != lastBank) {
+        flags |= TRACE_BANK;
+        *p++ = bank;
+        lastBank = bank;
+    }
+
+    // T-states since the previous record, 7 bits per byte, low first
+    uint32_t tstates = CPU::getGlobalTstates();
+    uint32_t delta = tstates - lastTstates;
+    while (delta >= 0x80) {
+        *p++ = delta | 0x80;
+        delta >>= 7;
+    }
+    *p++ = delta;
+    lastTstates = tstates;
+
+    // opcode bytes, operands are not kept
+    uint8_t opcode = Mem::readbyte(pc);
+    *p++ = opcode;
+    if (opcode == 0xCB || opcode == 0xED || (opcode | 0x20) == 0xFD) {
+        uint8_t opcode2 = Mem::readbyte(pc + 1);
+        *p++ = opcode2;
+        if ((opcode | 0x20) == 0xFD && opcode2 == 0xCB) {
+            *p++ = Mem::readbyte(pc + 2);
+            *p++ = Mem::readbyte(pc + 3);
+            flags |= 2;
+        } else {
+            flags |= 1;
+        }
+    }
+
+    *hdr = flags;
+    *p = 0;
+    pos = p - ring;
+
+    if (pc >= INSTR_TRACE_CRASH_LO && pc <= INSTR_TRACE_CRASH_HI && !crashed) {
+        crashed = true;
+        Serial.printf("Trace: execution at %04X\n", pc);
+        dump(INSTR_TRACE_DUMP_LAST);
+    }
+}
+
+// Decodes the ring from the oldest block on, printing records past the
+// first skip ones. Returns the number of records.
+uint32_t Trace::walk(uint32_t skip)
+{
+    uint32_t count = 0;
+
+    for (uint8_t i = 0; i < filled; i++) {
+        uint8_t b = (block + INSTR_TRACE_BLOCKS + 1 - filled + i) % INSTR_TRACE_BLOCKS;
+        uint8_t* p = ring + b * TRACE_BLOCK_SZ;
+
+        uint16_t pc = p[0] | (p[1] << 8);
+        uint8_t bank = p[2];
+        uint32_t tstates = p[3] | (p[4] << 8) | (p[5] << 16) | ((uint32_t)p[6] << 24);
+        p += TRACE_KEYFRAME_SZ;
+
+        while (*p & TRACE_REC) {
+            uint8_t flags = *p++;
+
+            uint8_t pcMode = (flags & TRACE_PC_MASK) >> TRACE_PC_SHIFT;
+            if (pcMode == TRACE_PC_ABS) {
+                pc = p[0] | (p[1] << 8);
+                p += 2;
+            } else if (pcMode == TRACE_PC_REL8) {
+                pc += (int8_t)*p++;
+            } else {
+                pc += pcMode;
+            }
+
+            if (flags & TRACE_BANK) bank = *p++;
+
+            uint32_t delta = 0;
+            uint8_t shift = 0;
+            do {
+                delta |= (uint32_t)(*p & 0x7f) << shift;
+                shift += 7;
+            } while (*p++ & 0x80);
+            tstates += delta;
+
+            uint8_t len = (flags & TRACE_OPLEN) == 2 ? 4 : (flags & TRACE_OPLEN) + 1;
+            if (count++ >= skip) {
+                Serial.printf("%10u %04X %02X ", tstates, pc, bank);
+                for (uint8_t j = 0; j < len; j++) Serial.printf(" %02X", p[j]);
+                Serial.printf("\n");
+            }
+            p += len;
+        }
+    }
+
+    return count;
+}
+
+void Trace::dump(uint32_t n)
+{
+    if (ring == NULL) return;
+
+    uint32_t count = walk(UINT32_MAX);
+    uint32_t skip = (n == 0 || n >= count) ? 0 : count - n;
+
+    Serial.printf("Trace: last %u of %u instructions\n", count - skip, count);
+    Serial.printf("   tstates PC   BK  opcode\n");
+    walk(skip);
+}
+
+#endif // INSTR_TRACE
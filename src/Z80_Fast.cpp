@@ -0,0 +1,27 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// z80cpp - Z80 emulator core
+//
+// Copyright (c) 2017, 2018, 2019, 2020 jsanchezv - https://github.com/jsanchezv
+//
+// Heretic optimizations and minor adaptations
+// Copyright (c) 2021 dcrespo3d - https://github.com/dcrespo3d
+//
+
+// Fast core: the JLS core built a second time as Z80Fast, calling Z80OpsFast
+// (see CPU.cpp) instead of Z80Ops. Registers are shared with Z80, so the
+// machine can switch cores between any two frames.
+
+#include "hardconfig.h"
+
+#ifdef Z80_FAST_CORE
+
+#include "Z80_JLS/z80.h"
+
+#define Z80_CORE_VARIANT
+#define Z80 Z80Fast
+#define Z80Ops Z80OpsFast
+
+#include "Z80_JLS.cpp"
+
+#endif // Z80_FAST_CORE
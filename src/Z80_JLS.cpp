@@ -17,82 +17,161 @@
 
 #include "hardconfig.h"
 #include "Z80_JLS/z80.h"
+#include <stdio.h>
+#include <string.h>
+#ifdef Z80_BLOCK_CACHE
+#include <stdlib.h>
+#endif
 
 #pragma GCC optimize ("O3")
 
-///////////////////////////////////////////////////////////////////////////////
-// miembros estáticos
+// Threaded dispatch: every decoder jumps straight from a per-prefix table of
+// label addresses into its case body, skipping the switch bounds check and
+// jump. Case bodies are shared by both dispatch engines.
+#ifdef Z80_THREADED_DISPATCH
+#define OPLABEL(op) op_##op:
+#else
+#define OPLABEL(op)
+#endif
 
-uint8_t Z80::opCode;
-uint8_t Z80::prefixOpcode = { 0x00 };
-bool Z80::execDone;
-uint8_t Z80::regA;
-uint8_t Z80::sz5h3pnFlags;
-bool Z80::carryFlag;
-RegisterPair Z80::regBC, Z80::regBCx, Z80::regDE, Z80::regDEx, Z80::regHL, Z80::regHLx;
-bool Z80::flagQ;
-bool Z80::lastFlagQ;
-RegisterPair Z80::regAFx;
-RegisterPair Z80::regPC;
-RegisterPair Z80::regIX;
-RegisterPair Z80::regIY;
-RegisterPair Z80::regSP;
-uint8_t Z80::regI;
-uint8_t Z80::regR;
-bool Z80::regRbit7;
-bool Z80::ffIFF1 = false;
-bool Z80::ffIFF2 = false;
-bool Z80::pendingEI = false;
-bool Z80::activeNMI = false;
-Z80::IntMode Z80::modeINT = Z80::IntMode::IM0;
-bool Z80::halted = false;
-bool Z80::pinReset = false;
-RegisterPair Z80::memptr;
-uint8_t Z80::sz53n_addTable[256];
-uint8_t Z80::sz53pn_addTable[256];
-uint8_t Z80::sz53n_subTable[256];
-uint8_t Z80::sz53pn_subTable[256];
+// Profiler: note which decoder table and opcode the current instruction
+// belongs to. Nested decoders (CB, DDCB) overwrite the outer one.
+#ifdef Z80_PROFILER
+#define PROFILE_OPCODE(table, op) { profTable = (table); profOpcode = (op); }
+#else
+#define PROFILE_OPCODE(table, op)
+#endif
 
 ///////////////////////////////////////////////////////////////////////////////
+// miembros estáticos
+// (las variantes del núcleo usan los de Z80State, ver z80.h)
+
+#ifndef Z80_CORE_VARIANT
+MACHINE_STATE uint8_t Z80::opCode;
+MACHINE_STATE uint8_t Z80::prefixOpcode = { 0x00 };
+MACHINE_STATE bool Z80::execDone;
+MACHINE_STATE uint8_t Z80::regA;
+MACHINE_STATE uint8_t Z80::sz5h3pnFlags;
+MACHINE_STATE bool Z80::carryFlag;
+#ifdef Z80_LAZY_FLAGS
+MACHINE_STATE uint8_t Z80::lazyFlags = Z80::LAZY_NONE;
+MACHINE_STATE uint8_t Z80::lazyOper1;
+MACHINE_STATE uint8_t Z80::lazyOper2;
+MACHINE_STATE uint16_t Z80::lazyRes;
+#endif
+MACHINE_STATE RegisterPair Z80::regBC, Z80::regBCx, Z80::regDE, Z80::regDEx, Z80::regHL, Z80::regHLx;
+MACHINE_STATE bool Z80::flagQ;
+MACHINE_STATE bool Z80::lastFlagQ;
+MACHINE_STATE RegisterPair Z80::regAFx;
+MACHINE_STATE RegisterPair Z80::regPC;
+MACHINE_STATE RegisterPair Z80::regIX;
+MACHINE_STATE RegisterPair Z80::regIY;
+MACHINE_STATE RegisterPair Z80::regSP;
+MACHINE_STATE uint8_t Z80::regI;
+MACHINE_STATE uint8_t Z80::regR;
+MACHINE_STATE bool Z80::regRbit7;
+MACHINE_STATE bool Z80::ffIFF1 = false;
+MACHINE_STATE bool Z80::ffIFF2 = false;
+MACHINE_STATE bool Z80::pendingEI = false;
+MACHINE_STATE bool Z80::activeNMI = false;
+MACHINE_STATE bool Z80::activeINT = false;
+MACHINE_STATE Z80::IntMode Z80::modeINT = Z80::IntMode::IM0;
+MACHINE_STATE bool Z80::halted = false;
+MACHINE_STATE bool Z80::pinReset = false;
+MACHINE_STATE RegisterPair Z80::memptr;
+#ifdef WITH_BREAKPOINT_SUPPORT
+MACHINE_STATE bool Z80::breakpointEnabled = false;
+#endif
+#ifdef INSTR_TRACE
+MACHINE_STATE bool Z80::traceEnabled = false;
+#endif
+#ifdef ROM_HLE
+MACHINE_STATE uint8_t Z80::romHookPage[64];
+#endif
+#ifdef Z80_BLOCK_CACHE
+MACHINE_STATE bool Z80::blockCacheEnabled = false;
+MACHINE_STATE Z80::BlockOp* Z80::blockPool = NULL;
+MACHINE_STATE uint32_t Z80::blockPoolUsed = 0;
+MACHINE_STATE Z80::BlockEntry* Z80::blockIndex = NULL;
+MACHINE_STATE uint8_t Z80::blockCodePage[256];
+MACHINE_STATE uint8_t Z80::blockPageInvalidations[256];
+MACHINE_STATE uint32_t Z80::blockGeneration = 0;
+#endif
 
-// Constructor de la clase
-void Z80::create() {
+// Paridad par (PARITY_MASK) o impar (0) de los 8 bits bajos
+constexpr uint8_t Z80::parity(uint32_t value) {
+    return (value & 0xff) == 0 ? PARITY_MASK
+        : (parity((value & 0xff) >> 1) ^ ((value & 0x01) ? PARITY_MASK : 0));
+}
 
-    bool evenBits;
+// SIGN, ZERO y los bits 3 y 5 del resultado, ADDSUB a 0
+constexpr uint8_t Z80::sz53n(uint32_t value) {
+    return (value & (SIGN_MASK | FLAG_53_MASK)) | ((value & 0xff) == 0 ? ZERO_MASK : 0);
+}
 
-    for (uint32_t idx = 0; idx < 256; idx++) {
-		sz53n_addTable[idx] = 0;
-		sz53pn_addTable[idx] = 0;
-		sz53n_subTable[idx] = 0;
-		sz53pn_subTable[idx] = 0;
+// Corrección que DAA suma o resta al acumulador
+constexpr uint8_t Z80::daaAdjust(uint32_t idx) {
+    return (((idx & 0x200) || (idx & 0x0f) > 0x09) ? 0x06 : 0)
+        | (((idx & 0x100) || (idx & 0xff) > 0x99) ? 0x60 : 0);
+}
 
-		if (idx > 0x7f) {
-            sz53n_addTable[idx] |= SIGN_MASK;
-        }
+constexpr uint8_t Z80::daaResult(uint32_t idx) {
+    return ((idx & 0x400) ? idx - daaAdjust(idx) : idx + daaAdjust(idx)) & 0xff;
+}
 
-        evenBits = true;
-        for (uint8_t mask = 0x01; mask != 0; mask <<= 1) {
-            if ((idx & mask) != 0) {
-                evenBits = !evenBits;
-            }
-        }
+// Lo mismo que hace daa() con add/sub: halfcarry de la corrección,
+// sz53pn del resultado, ADDSUB sin tocar y carry si A > 0x99 o ya estaba
+constexpr uint16_t Z80::daaEntry(uint32_t idx) {
+    return (daaResult(idx) << 8)
+        | ((idx & 0x400)
+            ? ((idx & 0x0f) < (daaAdjust(idx) & 0x0f) ? HALFCARRY_MASK : 0)
+            : ((idx & 0x0f) + (daaAdjust(idx) & 0x0f) > 0x0f ? HALFCARRY_MASK : 0))
+        | sz53n(daaResult(idx)) | parity(daaResult(idx))
+        | ((idx & 0x400) ? ADDSUB_MASK : 0)
+        | (((idx & 0x100) || (idx & 0xff) > 0x99) ? CARRY_MASK : 0);
+}
 
-        sz53n_addTable[idx] |= (idx & FLAG_53_MASK);
-        sz53n_subTable[idx] = sz53n_addTable[idx] | ADDSUB_MASK;
+// Inicializadores de n a n + N - 1 para las tablas
+#define TABLE4(f, n) f(n), f((n) + 1), f((n) + 2), f((n) + 3)
+#define TABLE16(f, n) TABLE4(f, n), TABLE4(f, (n) + 4), TABLE4(f, (n) + 8), TABLE4(f, (n) + 12)
+#define TABLE64(f, n) TABLE16(f, n), TABLE16(f, (n) + 16), TABLE16(f, (n) + 32), TABLE16(f, (n) + 48)
+#define TABLE256(f, n) TABLE64(f, n), TABLE64(f, (n) + 64), TABLE64(f, (n) + 128), TABLE64(f, (n) + 192)
+#define TABLE1024(f, n) TABLE256(f, n), TABLE256(f, (n) + 256), TABLE256(f, (n) + 512), TABLE256(f, (n) + 768)
+#define TABLE2048(f, n) TABLE1024(f, n), TABLE1024(f, (n) + 1024)
+
+#define SZ53N_ADD(n) sz53n(n)
+#define SZ53PN_ADD(n) (sz53n(n) | parity(n))
+#define SZ53N_SUB(n) (sz53n(n) | ADDSUB_MASK)
+#define SZ53PN_SUB(n) (sz53n(n) | parity(n) | ADDSUB_MASK)
+#define DAA_ENTRY(n) daaEntry(n)
+
+#if defined(Z80_TABLES_IN_DRAM) && defined(ESP32)
+#include <esp_attr.h>
+#define TABLE_ATTR DRAM_ATTR
+#else
+#define TABLE_ATTR
+#endif
 
-        if (evenBits) {
-            sz53pn_addTable[idx] = sz53n_addTable[idx] | PARITY_MASK;
-            sz53pn_subTable[idx] = sz53n_subTable[idx] | PARITY_MASK;
-        } else {
-            sz53pn_addTable[idx] = sz53n_addTable[idx];
-            sz53pn_subTable[idx] = sz53n_subTable[idx];
-        }
-    }
+TABLE_ATTR const uint8_t Z80::sz53n_addTable[256] = { TABLE256(SZ53N_ADD, 0) };
+TABLE_ATTR const uint8_t Z80::sz53pn_addTable[256] = { TABLE256(SZ53PN_ADD, 0) };
+TABLE_ATTR const uint8_t Z80::sz53n_subTable[256] = { TABLE256(SZ53N_SUB, 0) };
+TABLE_ATTR const uint8_t Z80::sz53pn_subTable[256] = { TABLE256(SZ53PN_SUB, 0) };
+TABLE_ATTR const uint16_t Z80::daaTable[2048] = { TABLE2048(DAA_ENTRY, 0) };
+#ifdef Z80_PROFILER
+MACHINE_STATE uint32_t Z80::profCount[PROF_TABLES][256];
+MACHINE_STATE uint64_t Z80::profTstates[PROF_TABLES][256];
+MACHINE_STATE uint64_t Z80::profCycles[PROF_TABLES][256];
+MACHINE_STATE uint8_t Z80::profTable;
+MACHINE_STATE uint8_t Z80::profOpcode;
+MACHINE_STATE uint32_t Z80::profStartTstates;
+MACHINE_STATE uint32_t Z80::profStartCycles;
+#endif
+#endif // Z80_CORE_VARIANT
 
-    sz53n_addTable[0] |= ZERO_MASK;
-    sz53pn_addTable[0] |= ZERO_MASK;
-    sz53n_subTable[0] |= ZERO_MASK;
-    sz53pn_subTable[0] |= ZERO_MASK;
+///////////////////////////////////////////////////////////////////////////////
+
+// Constructor de la clase
+void Z80::create() {
 
     execDone = false;
     reset();
@@ -113,6 +192,7 @@ RegisterPair Z80::getPairIR(void) {
 }
 
 void Z80::setAddSubFlag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= ADDSUB_MASK;
     } else {
@@ -121,6 +201,7 @@ void Z80::setAddSubFlag(bool state) {
 }
 
 void Z80::setParOverFlag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= PARITY_MASK;
     } else {
@@ -129,6 +210,7 @@ void Z80::setParOverFlag(bool state) {
 }
 
 void Z80::setBit3Fag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= BIT3_MASK;
     } else {
@@ -137,6 +219,7 @@ void Z80::setBit3Fag(bool state) {
 }
 
 void Z80::setHalfCarryFlag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= HALFCARRY_MASK;
     } else {
@@ -145,6 +228,7 @@ void Z80::setHalfCarryFlag(bool state) {
 }
 
 void Z80::setBit5Flag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= BIT5_MASK;
     } else {
@@ -153,6 +237,7 @@ void Z80::setBit5Flag(bool state) {
 }
 
 void Z80::setZeroFlag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= ZERO_MASK;
     } else {
@@ -161,6 +246,7 @@ void Z80::setZeroFlag(bool state) {
 }
 
 void Z80::setSignFlag(bool state) {
+    syncFlags();
     if (state) {
         sz5h3pnFlags |= SIGN_MASK;
     } else {
@@ -210,6 +296,7 @@ void Z80::reset(void) {
     ffIFF2 = false;
     pendingEI = false;
     activeNMI = false;
+    activeINT = false;
     halted = false;
     setIM(IntMode::IM0);
     lastFlagQ = false;
@@ -219,6 +306,7 @@ void Z80::reset(void) {
 // Rota a la izquierda el valor del argumento
 // El bit 0 y el flag C toman el valor del bit 7 antes de la operación
 void Z80::rlc(uint8_t &oper8) {
+    syncFlags();
     carryFlag = (oper8 > 0x7f);
     oper8 <<= 1;
     if (carryFlag) {
@@ -231,6 +319,7 @@ void Z80::rlc(uint8_t &oper8) {
 // El bit 7 va al carry flag
 // El bit 0 toma el valor del flag C antes de la operación
 void Z80::rl(uint8_t &oper8) {
+    syncFlags();
     bool carry = carryFlag;
     carryFlag = (oper8 > 0x7f);
     oper8 <<= 1;
@@ -245,6 +334,7 @@ void Z80::rl(uint8_t &oper8) {
 // El bit 7 va al carry flag
 // El bit 0 toma el valor 0
 void Z80::sla(uint8_t &oper8) {
+    syncFlags();
     carryFlag = (oper8 > 0x7f);
     oper8 <<= 1;
     sz5h3pnFlags = sz53pn_addTable[oper8];
@@ -256,6 +346,7 @@ void Z80::sla(uint8_t &oper8) {
 // El bit 0 toma el valor 1
 // Instrucción indocumentada
 void Z80::sll(uint8_t &oper8) {
+    syncFlags();
     carryFlag = (oper8 > 0x7f);
     oper8 <<= 1;
     oper8 |= CARRY_MASK;
@@ -266,6 +357,7 @@ void Z80::sll(uint8_t &oper8) {
 // Rota a la derecha el valor del argumento
 // El bit 7 y el flag C toman el valor del bit 0 antes de la operación
 void Z80::rrc(uint8_t &oper8) {
+    syncFlags();
     carryFlag = (oper8 & CARRY_MASK) != 0;
     oper8 >>= 1;
     if (carryFlag) {
@@ -279,6 +371,7 @@ void Z80::rrc(uint8_t &oper8) {
 // El bit 0 va al carry flag
 // El bit 7 toma el valor del flag C antes de la operación
 void Z80::rr(uint8_t &oper8) {
+    syncFlags();
     bool carry = carryFlag;
     carryFlag = (oper8 & CARRY_MASK) != 0;
     oper8 >>= 1;
@@ -293,6 +386,7 @@ void Z80::rr(uint8_t &oper8) {
 // El bit 0 pasa al carry.
 // El bit 7 conserva el valor que tenga
 void Z80::sra(uint8_t &oper8) {
+    syncFlags();
     uint8_t sign = oper8 & SIGN_MASK;
     carryFlag = (oper8 & CARRY_MASK) != 0;
     oper8 = (oper8 >> 1) | sign;
@@ -304,6 +398,7 @@ void Z80::sra(uint8_t &oper8) {
 // El bit 0 pasa al carry.
 // El bit 7 toma el valor 0
 void Z80::srl(uint8_t &oper8) {
+    syncFlags();
     carryFlag = (oper8 & CARRY_MASK) != 0;
     oper8 >>= 1;
     sz5h3pnFlags = sz53pn_addTable[oper8];
@@ -334,6 +429,14 @@ void Z80::srl(uint8_t &oper8) {
 void Z80::inc8(uint8_t &oper8) {
     oper8++;
 
+#ifdef Z80_LAZY_FLAGS
+    // INC no toca el carry: se fija antes de perder la operación anterior
+    if (lazyFlags >= LAZY_AND) {
+        carryFlag = lazyRes > 0xff;
+    }
+    lazyRes = oper8;
+    lazyFlags = LAZY_INC;
+#else
     sz5h3pnFlags = sz53n_addTable[oper8];
 
     if ((oper8 & 0x0f) == 0) {
@@ -343,6 +446,7 @@ void Z80::inc8(uint8_t &oper8) {
     if (oper8 == 0x80) {
         sz5h3pnFlags |= OVERFLOW_MASK;
     }
+#endif
 
     flagQ = true;
     return;
@@ -352,6 +456,13 @@ void Z80::inc8(uint8_t &oper8) {
 void Z80::dec8(uint8_t &oper8) {
     oper8--;
 
+#ifdef Z80_LAZY_FLAGS
+    if (lazyFlags >= LAZY_AND) {
+        carryFlag = lazyRes > 0xff;
+    }
+    lazyRes = oper8;
+    lazyFlags = LAZY_DEC;
+#else
     sz5h3pnFlags = sz53n_subTable[oper8];
 
     if ((oper8 & 0x0f) == 0x0f) {
@@ -361,6 +472,7 @@ void Z80::dec8(uint8_t &oper8) {
     if (oper8 == 0x7f) {
         sz5h3pnFlags |= OVERFLOW_MASK;
     }
+#endif
 
     flagQ = true;
     return;
@@ -368,6 +480,13 @@ void Z80::dec8(uint8_t &oper8) {
 
 // Suma de 8 bits afectando a los flags
 void Z80::add(uint8_t oper8) {
+#ifdef Z80_LAZY_FLAGS
+    lazyOper1 = regA;
+    lazyOper2 = oper8;
+    lazyRes = regA + oper8;
+    lazyFlags = LAZY_ADD;
+    regA = lazyRes;
+#else
     uint16_t res = regA + oper8;
 
     carryFlag = res > 0xff;
@@ -386,11 +505,19 @@ void Z80::add(uint8_t oper8) {
     }
 
     regA = res;
+#endif
     flagQ = true;
 }
 
 // Suma con acarreo de 8 bits
 void Z80::adc(uint8_t oper8) {
+#ifdef Z80_LAZY_FLAGS
+    lazyRes = regA + oper8 + isCarryFlag();
+    lazyOper1 = regA;
+    lazyOper2 = oper8;
+    lazyFlags = LAZY_ADD;
+    regA = lazyRes;
+#else
     uint16_t res = regA + oper8;
 
     if (carryFlag) {
@@ -410,11 +537,13 @@ void Z80::adc(uint8_t oper8) {
     }
 
     regA = res;
+#endif
     flagQ = true;
 }
 
 // Suma dos operandos de 16 bits sin carry afectando a los flags
 void Z80::add16(RegisterPair &reg16, uint16_t oper16) {
+    syncFlags();
     uint32_t tmp = oper16 + reg16.word;
 
     REG_WZ = reg16.word + 1;
@@ -432,6 +561,7 @@ void Z80::add16(RegisterPair &reg16, uint16_t oper16) {
 
 // Suma con acarreo de 16 bits
 void Z80::adc16(uint16_t reg16) {
+    syncFlags();
     uint16_t tmpHL = REG_HL;
     REG_WZ = REG_HL + 1;
 
@@ -462,6 +592,13 @@ void Z80::adc16(uint16_t reg16) {
 
 // Resta de 8 bits
 void Z80::sub(uint8_t oper8) {
+#ifdef Z80_LAZY_FLAGS
+    lazyOper1 = regA;
+    lazyOper2 = oper8;
+    lazyRes = regA - oper8;
+    lazyFlags = LAZY_SUB;
+    regA = lazyRes;
+#else
     int16_t res = regA - oper8;
 
     carryFlag = res < 0;
@@ -480,11 +617,19 @@ void Z80::sub(uint8_t oper8) {
     }
 
     regA = res;
+#endif
     flagQ = true;
 }
 
 // Resta con acarreo de 8 bits
 void Z80::sbc(uint8_t oper8) {
+#ifdef Z80_LAZY_FLAGS
+    lazyRes = regA - oper8 - isCarryFlag();
+    lazyOper1 = regA;
+    lazyOper2 = oper8;
+    lazyFlags = LAZY_SUB;
+    regA = lazyRes;
+#else
     int16_t res = regA - oper8;
 
     if (carryFlag) {
@@ -504,11 +649,13 @@ void Z80::sbc(uint8_t oper8) {
     }
 
     regA = res;
+#endif
     flagQ = true;
 }
 
 // Resta con acarreo de 16 bits
 void Z80::sbc16(uint16_t reg16) {
+    syncFlags();
     uint16_t tmpHL = REG_HL;
     REG_WZ = REG_HL + 1;
 
@@ -539,24 +686,39 @@ void Z80::sbc16(uint16_t reg16) {
 // Operación AND lógica
 void Z80::and_(uint8_t oper8) {
     regA &= oper8;
+#ifdef Z80_LAZY_FLAGS
+    lazyRes = regA;
+    lazyFlags = LAZY_AND;
+#else
     carryFlag = false;
     sz5h3pnFlags = sz53pn_addTable[regA] | HALFCARRY_MASK;
+#endif
     flagQ = true;
 }
 
 // Operación XOR lógica
 void Z80::xor_(uint8_t oper8) {
     regA ^= oper8;
+#ifdef Z80_LAZY_FLAGS
+    lazyRes = regA;
+    lazyFlags = LAZY_OR;
+#else
     carryFlag = false;
     sz5h3pnFlags = sz53pn_addTable[regA];
+#endif
     flagQ = true;
 }
 
 // Operación OR lógica
 void Z80::or_(uint8_t oper8) {
     regA |= oper8;
+#ifdef Z80_LAZY_FLAGS
+    lazyRes = regA;
+    lazyFlags = LAZY_OR;
+#else
     carryFlag = false;
     sz5h3pnFlags = sz53pn_addTable[regA];
+#endif
     flagQ = true;
 }
 
@@ -565,6 +727,12 @@ void Z80::or_(uint8_t oper8) {
 // Los flags SIGN y ZERO se calculan a partir del resultado
 // Los flags 3 y 5 se copian desde el operando (sigh!)
 void Z80::cp(uint8_t oper8) {
+#ifdef Z80_LAZY_FLAGS
+    lazyOper1 = regA;
+    lazyOper2 = oper8;
+    lazyRes = regA - oper8;
+    lazyFlags = LAZY_CP;
+#else
     int16_t res = regA - oper8;
 
     carryFlag = res < 0;
@@ -581,37 +749,85 @@ void Z80::cp(uint8_t oper8) {
     if (((regA ^ oper8) & (regA ^ res)) > 0x7f) {
         sz5h3pnFlags |= OVERFLOW_MASK;
     }
+#endif
 
     flagQ = true;
 }
 
-// DAA
-void Z80::daa(void) {
-    uint8_t suma = 0;
-    bool carry = carryFlag;
-
-    if ((sz5h3pnFlags & HALFCARRY_MASK) != 0 || (regA & 0x0f) > 0x09) {
-        suma = 6;
-    }
-
-    if (carry || (regA > 0x99)) {
-        suma |= 0x60;
+#ifdef Z80_LAZY_FLAGS
+// Calcula sz5h3pnFlags y carryFlag a partir de la última operación diferida.
+// Mismos resultados que las versiones inmediatas de inc8/dec8/add/adc/sub/
+// sbc/cp/and_/or_/xor_, incluidos los bits 3 y 5.
+void Z80::materializeFlags(void) {
+    uint8_t res = lazyRes;
+
+    switch (lazyFlags) {
+        case LAZY_INC:
+            sz5h3pnFlags = sz53n_addTable[res];
+            if ((res & 0x0f) == 0) {
+                sz5h3pnFlags |= HALFCARRY_MASK;
+            }
+            if (res == 0x80) {
+                sz5h3pnFlags |= OVERFLOW_MASK;
+            }
+            break;
+        case LAZY_DEC:
+            sz5h3pnFlags = sz53n_subTable[res];
+            if ((res & 0x0f) == 0x0f) {
+                sz5h3pnFlags |= HALFCARRY_MASK;
+            }
+            if (res == 0x7f) {
+                sz5h3pnFlags |= OVERFLOW_MASK;
+            }
+            break;
+        case LAZY_AND:
+            carryFlag = false;
+            sz5h3pnFlags = sz53pn_addTable[res] | HALFCARRY_MASK;
+            break;
+        case LAZY_OR:
+            carryFlag = false;
+            sz5h3pnFlags = sz53pn_addTable[res];
+            break;
+        case LAZY_ADD:
+            carryFlag = lazyRes > 0xff;
+            sz5h3pnFlags = sz53n_addTable[res]
+                    | ((lazyOper1 ^ lazyOper2 ^ res) & HALFCARRY_MASK);
+            if (((lazyOper1 ^ ~lazyOper2) & (lazyOper1 ^ res)) > 0x7f) {
+                sz5h3pnFlags |= OVERFLOW_MASK;
+            }
+            break;
+        case LAZY_SUB:
+            carryFlag = lazyRes > 0xff;
+            sz5h3pnFlags = sz53n_subTable[res]
+                    | ((lazyOper1 ^ lazyOper2 ^ res) & HALFCARRY_MASK);
+            if (((lazyOper1 ^ lazyOper2) & (lazyOper1 ^ res)) > 0x7f) {
+                sz5h3pnFlags |= OVERFLOW_MASK;
+            }
+            break;
+        case LAZY_CP:
+            carryFlag = lazyRes > 0xff;
+            sz5h3pnFlags = (sz53n_addTable[lazyOper2] & FLAG_53_MASK)
+                    | (sz53n_subTable[res] & FLAG_SZHN_MASK)
+                    | ((lazyOper1 ^ lazyOper2 ^ res) & HALFCARRY_MASK);
+            if (((lazyOper1 ^ lazyOper2) & (lazyOper1 ^ res)) > 0x7f) {
+                sz5h3pnFlags |= OVERFLOW_MASK;
+            }
+            break;
     }
 
-    if (regA > 0x99) {
-        carry = true;
-    }
+    lazyFlags = LAZY_NONE;
+}
+#endif
 
-    if ((sz5h3pnFlags & ADDSUB_MASK) != 0) {
-        sub(suma);
-        sz5h3pnFlags = (sz5h3pnFlags & HALFCARRY_MASK) | sz53pn_subTable[regA];
-    } else {
-        add(suma);
-        sz5h3pnFlags = (sz5h3pnFlags & HALFCARRY_MASK) | sz53pn_addTable[regA];
-    }
+// DAA
+void Z80::daa(void) {
+    syncFlags();
+    uint16_t result = daaTable[regA | (carryFlag ? 0x100 : 0)
+        | ((sz5h3pnFlags & HALFCARRY_MASK) << 5) | ((sz5h3pnFlags & ADDSUB_MASK) << 9)];
 
-    carryFlag = carry;
-    // Los add/sub ya ponen el resto de los flags
+    regA = result >> 8;
+    sz5h3pnFlags = result & 0xfe;
+    carryFlag = (result & CARRY_MASK) != 0;
     flagQ = true;
 }
 
@@ -630,6 +846,7 @@ void Z80::push(uint16_t word) {
 
 // LDI
 void Z80::ldi(void) {
+    syncFlags();
     uint8_t work8 = Z80Ops::peek8(REG_HL);
     Z80Ops::poke8(REG_DE, work8);
     Z80Ops::addressOnBus(REG_DE, 2);
@@ -652,6 +869,7 @@ void Z80::ldi(void) {
 
 // LDD
 void Z80::ldd(void) {
+    syncFlags();
     uint8_t work8 = Z80Ops::peek8(REG_HL);
     Z80Ops::poke8(REG_DE, work8);
     Z80Ops::addressOnBus(REG_DE, 2);
@@ -674,9 +892,11 @@ void Z80::ldd(void) {
 
 // CPI
 void Z80::cpi(void) {
+    syncFlags();
     uint8_t memHL = Z80Ops::peek8(REG_HL);
     bool carry = carryFlag; // lo guardo porque cp lo toca
     cp(memHL);
+    syncFlags();
     carryFlag = carry;
     Z80Ops::addressOnBus(REG_HL, 5);
     REG_HL++;
@@ -698,9 +918,11 @@ void Z80::cpi(void) {
 
 // CPD
 void Z80::cpd(void) {
+    syncFlags();
     uint8_t memHL = Z80Ops::peek8(REG_HL);
     bool carry = carryFlag; // lo guardo porque cp lo toca
     cp(memHL);
+    syncFlags();
     carryFlag = carry;
     Z80Ops::addressOnBus(REG_HL, 5);
     REG_HL--;
@@ -722,6 +944,7 @@ void Z80::cpd(void) {
 
 // INI
 void Z80::ini(void) {
+    syncFlags();
     REG_WZ = REG_BC;
     Z80Ops::addressOnBus(getPairIR().word, 1);
     uint8_t work8 = Z80Ops::inPort(REG_WZ++);
@@ -753,6 +976,7 @@ void Z80::ini(void) {
 
 // IND
 void Z80::ind(void) {
+    syncFlags();
     REG_WZ = REG_BC;
     Z80Ops::addressOnBus(getPairIR().word, 1);
     uint8_t work8 = Z80Ops::inPort(REG_WZ--);
@@ -784,6 +1008,7 @@ void Z80::ind(void) {
 
 // OUTI
 void Z80::outi(void) {
+    syncFlags();
 
     Z80Ops::addressOnBus(getPairIR().word, 1);
 
@@ -816,6 +1041,7 @@ void Z80::outi(void) {
 
 // OUTD
 void Z80::outd(void) {
+    syncFlags();
 
     Z80Ops::addressOnBus(getPairIR().word, 1);
 
@@ -846,6 +1072,65 @@ void Z80::outd(void) {
     flagQ = true;
 }
 
+// Block instruction repeat (LDIR, CPIR, INIR, OTIR, LDDR, CPDR, INDR, OTDR)
+// Instead of rewinding PC and going back through execute() for every byte,
+// the next iteration runs here, with the same M1 fetches, R increments and
+// Q/EI bookkeeping that execute() would do between instructions, so T-states
+// and contention stay exact. The loop ends when an interrupt would be
+// accepted, or when the machine says through isRepeatAllowed() that its
+// deadline has been reached.
+// If the byte pair at the rewound PC is no longer the block instruction
+// (it overwrote itself or a port write paged it out), the fetched opcode
+// is decoded as usual and the bulk loop ends.
+bool Z80::repeatBlock(uint8_t blockOpcode) {
+
+    if (activeNMI || (ffIFF1 && activeINT) || !Z80Ops::isRepeatAllowed())
+        return false;
+
+#ifdef WITH_BREAKPOINT_SUPPORT
+    if (breakpointEnabled)
+        return false;
+#endif
+
+#ifdef INSTR_TRACE
+    // cada vuelta debe quedar en la traza
+    if (traceEnabled)
+        return false;
+#endif
+
+#ifdef WITH_EXEC_DONE
+    if (execDone)
+        return false;
+#endif
+
+    lastFlagQ = flagQ;
+
+#ifdef Z80_PROFILER
+    // every iteration counts as one execution of the block instruction
+    profileSample();
+    profileStart();
+#endif
+
+    opCode = Z80Ops::fetchOpcode(REG_PC++);
+    regR++;
+    flagQ = pendingEI = false;
+    if (opCode != 0xED) {
+        PROFILE_OPCODE(PROF_BASE, opCode);
+        decodeOpcode(opCode);
+        return false;
+    }
+
+    opCode = Z80Ops::fetchOpcode(REG_PC++);
+    regR++;
+    if (opCode != blockOpcode) {
+        PROFILE_OPCODE(PROF_ED, opCode);
+        decodeED(opCode);
+        return false;
+    }
+
+    return true;
+}
+
 // Pone a 1 el Flag Z si el bit b del registro
 // r es igual a 0
 /*
@@ -859,6 +1144,7 @@ void Z80::outd(void) {
  *          http://scratchpad.wikia.com/wiki/Z80
  */
 void Z80::bitTest(uint8_t mask, uint8_t reg) {
+    syncFlags();
     bool zeroFlag = (mask & reg) == 0;
 
     sz5h3pnFlags = (sz53n_addTable[reg] & ~FLAG_SZP_MASK) | HALFCARRY_MASK;
@@ -932,44 +1218,89 @@ void Z80::nmi(void) {
     REG_PC = REG_WZ = 0x0066;
 }
 
-void Z80::execute(void) {
+void Z80::execute(uint32_t deadline) {
 
-    opCode = Z80Ops::fetchOpcode(REG_PC);
-    regR++;
+    // Con un prefijo pendiente se sigue con la misma instrucción
+    bool resumed = prefixOpcode != 0;
+    if (!resumed) {
+#ifdef Z80_PROFILER
+        profileStart();
+#endif
+
+#ifdef INSTR_TRACE
+        if (traceEnabled)
+            Z80Ops::traceInstruction(REG_PC);
+#endif
 
+#if defined(ROM_HLE) && !defined(Z80_CORE_VARIANT)
+        // Rutina de la ROM hecha por la máquina: acaba en una instrucción que
+        // no toca los flags, y no se aceptan interrupciones a medias (DI, o
+        // la máquina no la hace con una INT pendiente)
+        if (REG_PC < 0x4000 && romHookPage[REG_PC >> 8] && !activeNMI
 #ifdef WITH_BREAKPOINT_SUPPORT
-    if (breakpointEnabled && prefixOpcode == 0) {
-        opCode = Z80Ops::breakpoint(REG_PC, opCode);
-    }
+            && !breakpointEnabled
+#endif
+#ifdef INSTR_TRACE
+            && !traceEnabled
+#endif
+#ifdef WITH_EXEC_DONE
+            && !execDone
+#endif
+            && Z80Ops::romRoutine(REG_PC)) {
+            lastFlagQ = false;
+            return;
+        }
 #endif
-    REG_PC++;
+
+        opCode = Z80Ops::fetchOpcode(REG_PC);
+        regR++;
+        REG_PC++;
+
+        flagQ = pendingEI = false;
+        PROFILE_OPCODE(PROF_BASE, opCode);
+        decodeOpcode(opCode);
+    }
 
     // El prefijo 0xCB no cuenta para esta guerra.
     // En CBxx todas las xx producen un código válido
     // de instrucción, incluyendo CBCB.
-    switch (prefixOpcode) {
-        case 0x00:
-            flagQ = pendingEI = false;
-            decodeOpcode(opCode);
-            break;
-        case 0xDD:
-            prefixOpcode = 0;
-            decodeDDFD(opCode, regIX);
-            break;
-        case 0xED:
-            prefixOpcode = 0;
-            decodeED(opCode);
-            break;
-        case 0xFD:
-            prefixOpcode = 0;
-            decodeDDFD(opCode, regIY);
-            break;
-        default:
+    // Tras un prefijo DD, ED o FD (o una cadena de ellos) el código que
+    // sigue se lee y decodifica aquí mismo, con su M1 y su incremento de R,
+    // sin volver al bucle de la máquina, mientras no se llegue a
+    // 'deadline'. Al llegar se vuelve con el prefijo pendiente, como si
+    // cada eslabón fuera una llamada: la máquina acaba ahí el frame y la
+    // INT se acepta tras el resto de la cadena, no una instrucción después.
+    while (prefixOpcode != 0) {
+        if (!resumed && Z80Ops::getTstates() >= deadline)
             return;
+        resumed = false;
+
+        uint8_t prefix = prefixOpcode;
+        prefixOpcode = 0;
+
+        opCode = Z80Ops::fetchOpcode(REG_PC);
+        regR++;
+        REG_PC++;
+
+        switch (prefix) {
+            case 0xDD:
+                PROFILE_OPCODE(PROF_DD, opCode);
+                decodeDDFD(opCode, regIX);
+                break;
+            case 0xED:
+                PROFILE_OPCODE(PROF_ED, opCode);
+                decodeED(opCode);
+                break;
+            case 0xFD:
+                PROFILE_OPCODE(PROF_FD, opCode);
+                decodeDDFD(opCode, regIY);
+                break;
+        }
     }
 
-    if (prefixOpcode != 0)
-        return;
+#ifdef Z80_PROFILER
+    profileSample();
+#endif
 
     lastFlagQ = flagQ;
 
@@ -990,26 +1321,189 @@ void Z80::execute(void) {
     }
 
     // Ahora se comprueba si está activada la señal INT
-    if (ffIFF1 && !pendingEI && Z80Ops::isActiveINT()) {
+    if (ffIFF1 && !pendingEI && activeINT) {
+        activeINT = false;
         lastFlagQ = false;
         interrupt();
     }
 }
 
+#if defined(Z80_PROFILER) || defined(Z80_TABLES_BENCHMARK)
+// Contador de ciclos del procesador que ejecuta el emulador
+static inline uint32_t hostCycles(void) {
+#if defined(__XTENSA__)
+    uint32_t ccount;
+    __asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+    return ccount;
+#elif defined(__x86_64__) || defined(__i386__)
+    return (uint32_t) __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+#endif
+
+#ifdef Z80_PROFILER
+void Z80::profileStart(void) {
+    profStartTstates = Z80Ops::getTstates();
+    profStartCycles = hostCycles();
+}
+
+void Z80::profileSample(void) {
+    uint32_t tstates = Z80Ops::getTstates();
+
+    profCount[profTable][profOpcode]++;
+    // una instrucción partida por el final de frame no suma T-estados
+    if (tstates >= profStartTstates) {
+        profTstates[profTable][profOpcode] += tstates - profStartTstates;
+    }
+    profCycles[profTable][profOpcode] += hostCycles() - profStartCycles;
+}
+
+void Z80::profileReset(void) {
+    memset(profCount, 0, sizeof(profCount));
+    memset(profTstates, 0, sizeof(profTstates));
+    memset(profCycles, 0, sizeof(profCycles));
+}
+
+void Z80::profileDump(FILE* out) {
+    static const char* const tableName[PROF_TABLES] = { "", "CB", "ED", "DD", "FD", "DDCB" };
+
+    fprintf(out, "table,opcode,count,tstates,cycles\n");
+    for (int table = 0; table < PROF_TABLES; table++) {
+        for (int op = 0; op < 256; op++) {
+            if (profCount[table][op] == 0)
+                continue;
+            fprintf(out, "%s,%02X,%u,%llu,%llu\n", tableName[table], op,
+                    (unsigned) profCount[table][op],
+                    (unsigned long long) profTstates[table][op],
+                    (unsigned long long) profCycles[table][op]);
+        }
+    }
+    fflush(out);
+}
+#endif
+
+#ifdef Z80_TABLES_BENCHMARK
+#define BENCH_LOOKUPS 1000000
+
+// Mismo patrón de acceso para las dos copias de las tablas
+static uint32_t __attribute__((noinline)) benchLookups(const uint8_t* flags,
+        const uint16_t* daa, uint32_t* checksum) {
+    uint32_t seed = 1;
+    uint32_t sum = 0;
+    uint32_t start = hostCycles();
+    for (uint32_t i = 0; i < BENCH_LOOKUPS; i++) {
+        seed = seed * 1103515245 + 12345;
+        sum += flags[(seed >> 8) & 0xff] + daa[(seed >> 16) & 0x7ff];
+    }
+    *checksum = sum;
+    return hostCycles() - start;
+}
+
+void Z80::benchmarkTables(void) {
+    // copia en DRAM (.bss) de las tablas
+    static uint8_t ramFlags[256];
+    static uint16_t ramDaa[2048];
+
+    memcpy(ramFlags, sz53pn_addTable, sizeof(ramFlags));
+    memcpy(ramDaa, daaTable, sizeof(ramDaa));
+
+    uint32_t sumTables, sumRam;
+    uint32_t cyclesTables = benchLookups(sz53pn_addTable, daaTable, &sumTables);
+    uint32_t cyclesRam = benchLookups(ramFlags, ramDaa, &sumRam);
+
+    printf("Z80 tables at %p (%s): %u cycles / %u lookups\n", daaTable,
+#ifdef Z80_TABLES_IN_DRAM
+        "DRAM",
+#else
+        "flash",
+#endif
+        cyclesTables, BENCH_LOOKUPS * 2);
+    printf("Z80 tables copy at %p (DRAM): %u cycles / %u lookups\n", ramDaa,
+        cyclesRam, BENCH_LOOKUPS * 2);
+    if (sumTables != sumRam)
+        printf("Z80 tables copy mismatch!\n");
+}
+#endif
+
+// Bucle de ejecución sin pasar por la máquina entre instrucciones. Vuelve
+// al llegar a 'deadline' o al entrar en HALT, para que la máquina pueda
+// adelantar el reloj hasta su siguiente evento.
+void Z80::executeUntil(uint32_t deadline) {
+    do {
+#if defined(Z80_BLOCK_CACHE) && !defined(Z80_CORE_VARIANT)
+        // Los bloques no aceptan interrupciones: solo se entra en uno si
+        // tras la instrucción actual no se iba a aceptar ninguna
+        if (blockCacheEnabled && prefixOpcode == 0 && !activeNMI && !(ffIFF1 && activeINT)
+#ifdef WITH_BREAKPOINT_SUPPORT
+            && !breakpointEnabled
+#endif
+#ifdef INSTR_TRACE
+            && !traceEnabled
+#endif
+#ifdef WITH_EXEC_DONE
+            && !execDone
+#endif
+            && REG_PC < BLOCK_CACHE_LIMIT && blockIndex[REG_PC] != BLOCK_NEVER
+            && runBlock(deadline))
+            continue;
+#endif
+        execute(deadline);
+    } while (Z80Ops::getTstates() < deadline && !halted);
+}
+
 void Z80::decodeOpcode(uint8_t opCode) {
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatch[256] = {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_end, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_end, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_end, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_end, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_end, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_end, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_end,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatch[opCode];
+#endif
     switch (opCode) {
-        case 0x00:
+        case 0x00: OPLABEL(0x00)
         { /* NOP */
             break;
         }
-        case 0x01:
+        case 0x01: OPLABEL(0x01)
         { /* LD BC,nn */
             REG_BC = Z80Ops::peek16(REG_PC);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x02:
+        case 0x02: OPLABEL(0x02)
         { /* LD (BC),A */
             Z80Ops::poke8(REG_BC, regA);
             REG_W = regA;
@@ -1017,30 +1511,31 @@ void Z80::decodeOpcode(uint8_t opCode) {
             //REG_WZ = (regA << 8) | (REG_C + 1);
             break;
         }
-        case 0x03:
+        case 0x03: OPLABEL(0x03)
         { /* INC BC */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_BC++;
             break;
         }
-        case 0x04:
+        case 0x04: OPLABEL(0x04)
         { /* INC B */
             inc8(REG_B);
             break;
         }
-        case 0x05:
+        case 0x05: OPLABEL(0x05)
         { /* DEC B */
             dec8(REG_B);
             break;
         }
-        case 0x06:
+        case 0x06: OPLABEL(0x06)
         { /* LD B,n */
             REG_B = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x07:
+        case 0x07: OPLABEL(0x07)
         { /* RLCA */
+            syncFlags();
             carryFlag = (regA > 0x7f);
             regA <<= 1;
             if (carryFlag) {
@@ -1050,7 +1545,7 @@ void Z80::decodeOpcode(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x08:
+        case 0x08: OPLABEL(0x08)
         { /* EX AF,AF' */
             uint8_t work8 = regA;
             regA = REG_Ax;
@@ -1061,42 +1556,43 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_Fx = work8;
             break;
         }
-        case 0x09:
+        case 0x09: OPLABEL(0x09)
         { /* ADD HL,BC */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regHL, REG_BC);
             break;
         }
-        case 0x0A:
+        case 0x0A: OPLABEL(0x0A)
         { /* LD A,(BC) */
             regA = Z80Ops::peek8(REG_BC);
             REG_WZ = REG_BC + 1;
             break;
         }
-        case 0x0B:
+        case 0x0B: OPLABEL(0x0B)
         { /* DEC BC */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_BC--;
             break;
         }
-        case 0x0C:
+        case 0x0C: OPLABEL(0x0C)
         { /* INC C */
             inc8(REG_C);
             break;
         }
-        case 0x0D:
+        case 0x0D: OPLABEL(0x0D)
         { /* DEC C */
             dec8(REG_C);
             break;
         }
-        case 0x0E:
+        case 0x0E: OPLABEL(0x0E)
         { /* LD C,n */
             REG_C = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x0F:
+        case 0x0F: OPLABEL(0x0F)
         { /* RRCA */
+            syncFlags();
             carryFlag = (regA & CARRY_MASK) != 0;
             regA >>= 1;
             if (carryFlag) {
@@ -1106,7 +1602,7 @@ void Z80::decodeOpcode(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x10:
+        case 0x10: OPLABEL(0x10)
         { /* DJNZ e */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             int8_t offset = Z80Ops::peek8(REG_PC);
@@ -1118,13 +1614,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             }
             break;
         }
-        case 0x11:
+        case 0x11: OPLABEL(0x11)
         { /* LD DE,nn */
             REG_DE = Z80Ops::peek16(REG_PC);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x12:
+        case 0x12: OPLABEL(0x12)
         { /* LD (DE),A */
             Z80Ops::poke8(REG_DE, regA);
             REG_W = regA;
@@ -1132,30 +1628,31 @@ void Z80::decodeOpcode(uint8_t opCode) {
             //REG_WZ = (regA << 8) | (REG_E + 1);
             break;
         }
-        case 0x13:
+        case 0x13: OPLABEL(0x13)
         { /* INC DE */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_DE++;
             break;
         }
-        case 0x14:
+        case 0x14: OPLABEL(0x14)
         { /* INC D */
             inc8(REG_D);
             break;
         }
-        case 0x15:
+        case 0x15: OPLABEL(0x15)
         { /* DEC D */
             dec8(REG_D);
             break;
         }
-        case 0x16:
+        case 0x16: OPLABEL(0x16)
         { /* LD D,n */
             REG_D = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x17:
+        case 0x17: OPLABEL(0x17)
         { /* RLA */
+            syncFlags();
             bool oldCarry = carryFlag;
             carryFlag = regA > 0x7f;
             regA <<= 1;
@@ -1166,49 +1663,50 @@ void Z80::decodeOpcode(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x18:
+        case 0x18: OPLABEL(0x18)
         { /* JR e */
             int8_t offset = Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
             REG_PC = REG_WZ = REG_PC + offset + 1;
             break;
         }
-        case 0x19:
+        case 0x19: OPLABEL(0x19)
         { /* ADD HL,DE */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regHL, REG_DE);
             break;
         }
-        case 0x1A:
+        case 0x1A: OPLABEL(0x1A)
         { /* LD A,(DE) */
             regA = Z80Ops::peek8(REG_DE);
             REG_WZ = REG_DE + 1;
             break;
         }
-        case 0x1B:
+        case 0x1B: OPLABEL(0x1B)
         { /* DEC DE */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_DE--;
             break;
         }
-        case 0x1C:
+        case 0x1C: OPLABEL(0x1C)
         { /* INC E */
             inc8(REG_E);
             break;
         }
-        case 0x1D:
+        case 0x1D: OPLABEL(0x1D)
         { /* DEC E */
             dec8(REG_E);
             break;
         }
-        case 0x1E:
+        case 0x1E: OPLABEL(0x1E)
         { /* LD E,n */
             REG_E = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x1F:
+        case 0x1F: OPLABEL(0x1F)
         { /* RRA */
+            syncFlags();
             bool oldCarry = carryFlag;
             carryFlag = (regA & CARRY_MASK) != 0;
             regA >>= 1;
@@ -1219,10 +1717,10 @@ void Z80::decodeOpcode(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x20:
+        case 0x20: OPLABEL(0x20)
         { /* JR NZ,e */
             int8_t offset = Z80Ops::peek8(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) == 0) {
+            if (!isZeroFlag()) {
                 Z80Ops::addressOnBus(REG_PC, 5);
                 REG_PC += offset;
                 REG_WZ = REG_PC + 1;
@@ -1230,13 +1728,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC++;
             break;
         }
-        case 0x21:
+        case 0x21: OPLABEL(0x21)
         { /* LD HL,nn */
             REG_HL = Z80Ops::peek16(REG_PC);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x22:
+        case 0x22: OPLABEL(0x22)
         { /* LD (nn),HL */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ, regHL);
@@ -1244,37 +1742,37 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x23:
+        case 0x23: OPLABEL(0x23)
         { /* INC HL */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_HL++;
             break;
         }
-        case 0x24:
+        case 0x24: OPLABEL(0x24)
         { /* INC H */
             inc8(REG_H);
             break;
         }
-        case 0x25:
+        case 0x25: OPLABEL(0x25)
         { /* DEC H */
             dec8(REG_H);
             break;
         }
-        case 0x26:
+        case 0x26: OPLABEL(0x26)
         { /* LD H,n */
             REG_H = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x27:
+        case 0x27: OPLABEL(0x27)
         { /* DAA */
             daa();
             break;
         }
-        case 0x28:
+        case 0x28: OPLABEL(0x28)
         { /* JR Z,e */
             int8_t offset = Z80Ops::peek8(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) != 0) {
+            if (isZeroFlag()) {
                 Z80Ops::addressOnBus(REG_PC, 5);
                 REG_PC += offset;
                 REG_WZ = REG_PC + 1;
@@ -1282,13 +1780,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC++;
             break;
         }
-        case 0x29:
+        case 0x29: OPLABEL(0x29)
         { /* ADD HL,HL */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regHL, REG_HL);
             break;
         }
-        case 0x2A:
+        case 0x2A: OPLABEL(0x2A)
         { /* LD HL,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             REG_HL = Z80Ops::peek16(REG_WZ);
@@ -1296,40 +1794,41 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x2B:
+        case 0x2B: OPLABEL(0x2B)
         { /* DEC HL */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_HL--;
             break;
         }
-        case 0x2C:
+        case 0x2C: OPLABEL(0x2C)
         { /* INC L */
             inc8(REG_L);
             break;
         }
-        case 0x2D:
+        case 0x2D: OPLABEL(0x2D)
         { /* DEC L */
             dec8(REG_L);
             break;
         }
-        case 0x2E:
+        case 0x2E: OPLABEL(0x2E)
         { /* LD L,n */
             REG_L = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x2F:
+        case 0x2F: OPLABEL(0x2F)
         { /* CPL */
+            syncFlags();
             regA ^= 0xff;
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZP_MASK) | HALFCARRY_MASK
                     | (regA & FLAG_53_MASK) | ADDSUB_MASK;
             flagQ = true;
             break;
         }
-        case 0x30:
+        case 0x30: OPLABEL(0x30)
         { /* JR NC,e */
             int8_t offset = Z80Ops::peek8(REG_PC);
-            if (!carryFlag) {
+            if (!isCarryFlag()) {
                 Z80Ops::addressOnBus(REG_PC, 5);
                 REG_PC += offset;
                 REG_WZ = REG_PC + 1;
@@ -1337,13 +1836,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC++;
             break;
         }
-        case 0x31:
+        case 0x31: OPLABEL(0x31)
         { /* LD SP,nn */
             REG_SP = Z80Ops::peek16(REG_PC);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x32:
+        case 0x32: OPLABEL(0x32)
         { /* LD (nn),A */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke8(REG_WZ, regA);
@@ -1351,13 +1850,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x33:
+        case 0x33: OPLABEL(0x33)
         { /* INC SP */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_SP++;
             break;
         }
-        case 0x34:
+        case 0x34: OPLABEL(0x34)
         { /* INC (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             inc8(work8);
@@ -1365,7 +1864,7 @@ void Z80::decodeOpcode(uint8_t opCode) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x35:
+        case 0x35: OPLABEL(0x35)
         { /* DEC (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             dec8(work8);
@@ -1373,24 +1872,25 @@ void Z80::decodeOpcode(uint8_t opCode) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x36:
+        case 0x36: OPLABEL(0x36)
         { /* LD (HL),n */
             Z80Ops::poke8(REG_HL, Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
         }
-        case 0x37:
+        case 0x37: OPLABEL(0x37)
         { /* SCF */
+            syncFlags();
             uint8_t regQ = lastFlagQ ? sz5h3pnFlags : 0;
             carryFlag = true;
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZP_MASK) | (((regQ ^ sz5h3pnFlags) | regA) & FLAG_53_MASK);
             flagQ = true;
             break;
         }
-        case 0x38:
+        case 0x38: OPLABEL(0x38)
         { /* JR C,e */
             int8_t offset = Z80Ops::peek8(REG_PC);
-            if (carryFlag) {
+            if (isCarryFlag()) {
                 Z80Ops::addressOnBus(REG_PC, 5);
                 REG_PC += offset;
                 REG_WZ = REG_PC + 1;
@@ -1398,13 +1898,13 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC++;
             break;
         }
-        case 0x39:
+        case 0x39: OPLABEL(0x39)
         { /* ADD HL,SP */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regHL, REG_SP);
             break;
         }
-        case 0x3A:
+        case 0x3A: OPLABEL(0x3A)
         { /* LD A,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             regA = Z80Ops::peek8(REG_WZ);
@@ -1412,30 +1912,31 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x3B:
+        case 0x3B: OPLABEL(0x3B)
         { /* DEC SP */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_SP--;
             break;
         }
-        case 0x3C:
+        case 0x3C: OPLABEL(0x3C)
         { /* INC A */
             inc8(regA);
             break;
         }
-        case 0x3D:
+        case 0x3D: OPLABEL(0x3D)
         { /* DEC A */
             dec8(regA);
             break;
         }
-        case 0x3E:
+        case 0x3E: OPLABEL(0x3E)
         { /* LD A,n */
             regA = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x3F:
+        case 0x3F: OPLABEL(0x3F)
         { /* CCF */
+            syncFlags();
             uint8_t regQ = lastFlagQ ? sz5h3pnFlags : 0;
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZP_MASK) | (((regQ ^ sz5h3pnFlags) | regA) & FLAG_53_MASK);
             if (carryFlag) {
@@ -1448,42 +1949,42 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //      case 0x40: {     /* LD B,B */
 //           break;
 //    }
-        case 0x41:
+        case 0x41: OPLABEL(0x41)
         { /* LD B,C */
             REG_B = REG_C;
             break;
         }
-        case 0x42:
+        case 0x42: OPLABEL(0x42)
         { /* LD B,D */
             REG_B = REG_D;
             break;
         }
-        case 0x43:
+        case 0x43: OPLABEL(0x43)
         { /* LD B,E */
             REG_B = REG_E;
             break;
         }
-        case 0x44:
+        case 0x44: OPLABEL(0x44)
         { /* LD B,H */
             REG_B = REG_H;
             break;
         }
-        case 0x45:
+        case 0x45: OPLABEL(0x45)
         { /* LD B,L */
             REG_B = REG_L;
             break;
         }
-        case 0x46:
+        case 0x46: OPLABEL(0x46)
         { /* LD B,(HL) */
             REG_B = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x47:
+        case 0x47: OPLABEL(0x47)
         { /* LD B,A */
             REG_B = regA;
             break;
         }
-        case 0x48:
+        case 0x48: OPLABEL(0x48)
         { /* LD C,B */
             REG_C = REG_B;
             break;
@@ -1491,42 +1992,42 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //        case 0x49: {     /* LD C,C */
 //            break;
 //        }
-        case 0x4A:
+        case 0x4A: OPLABEL(0x4A)
         { /* LD C,D */
             REG_C = REG_D;
             break;
         }
-        case 0x4B:
+        case 0x4B: OPLABEL(0x4B)
         { /* LD C,E */
             REG_C = REG_E;
             break;
         }
-        case 0x4C:
+        case 0x4C: OPLABEL(0x4C)
         { /* LD C,H */
             REG_C = REG_H;
             break;
         }
-        case 0x4D:
+        case 0x4D: OPLABEL(0x4D)
         { /* LD C,L */
             REG_C = REG_L;
             break;
         }
-        case 0x4E:
+        case 0x4E: OPLABEL(0x4E)
         { /* LD C,(HL) */
             REG_C = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x4F:
+        case 0x4F: OPLABEL(0x4F)
         { /* LD C,A */
             REG_C = regA;
             break;
         }
-        case 0x50:
+        case 0x50: OPLABEL(0x50)
         { /* LD D,B */
             REG_D = REG_B;
             break;
         }
-        case 0x51:
+        case 0x51: OPLABEL(0x51)
         { /* LD D,C */
             REG_D = REG_C;
             break;
@@ -1534,42 +2035,42 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //            case 0x52: {     /* LD D,D */
 //                break;
 //            }
-        case 0x53:
+        case 0x53: OPLABEL(0x53)
         { /* LD D,E */
             REG_D = REG_E;
             break;
         }
-        case 0x54:
+        case 0x54: OPLABEL(0x54)
         { /* LD D,H */
             REG_D = REG_H;
             break;
         }
-        case 0x55:
+        case 0x55: OPLABEL(0x55)
         { /* LD D,L */
             REG_D = REG_L;
             break;
         }
-        case 0x56:
+        case 0x56: OPLABEL(0x56)
         { /* LD D,(HL) */
             REG_D = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x57:
+        case 0x57: OPLABEL(0x57)
         { /* LD D,A */
             REG_D = regA;
             break;
         }
-        case 0x58:
+        case 0x58: OPLABEL(0x58)
         { /* LD E,B */
             REG_E = REG_B;
             break;
         }
-        case 0x59:
+        case 0x59: OPLABEL(0x59)
         { /* LD E,C */
             REG_E = REG_C;
             break;
         }
-        case 0x5A:
+        case 0x5A: OPLABEL(0x5A)
         { /* LD E,D */
             REG_E = REG_D;
             break;
@@ -1577,42 +2078,42 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //            case 0x5B: {     /* LD E,E */
 //                break;
 //            }
-        case 0x5C:
+        case 0x5C: OPLABEL(0x5C)
         { /* LD E,H */
             REG_E = REG_H;
             break;
         }
-        case 0x5D:
+        case 0x5D: OPLABEL(0x5D)
         { /* LD E,L */
             REG_E = REG_L;
             break;
         }
-        case 0x5E:
+        case 0x5E: OPLABEL(0x5E)
         { /* LD E,(HL) */
             REG_E = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x5F:
+        case 0x5F: OPLABEL(0x5F)
         { /* LD E,A */
             REG_E = regA;
             break;
         }
-        case 0x60:
+        case 0x60: OPLABEL(0x60)
         { /* LD H,B */
             REG_H = REG_B;
             break;
         }
-        case 0x61:
+        case 0x61: OPLABEL(0x61)
         { /* LD H,C */
             REG_H = REG_C;
             break;
         }
-        case 0x62:
+        case 0x62: OPLABEL(0x62)
         { /* LD H,D */
             REG_H = REG_D;
             break;
         }
-        case 0x63:
+        case 0x63: OPLABEL(0x63)
         { /* LD H,E */
             REG_H = REG_E;
             break;
@@ -1620,42 +2121,42 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //            case 0x64: {     /* LD H,H */
 //                break;
 //            }
-        case 0x65:
+        case 0x65: OPLABEL(0x65)
         { /* LD H,L */
             REG_H = REG_L;
             break;
         }
-        case 0x66:
+        case 0x66: OPLABEL(0x66)
         { /* LD H,(HL) */
             REG_H = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x67:
+        case 0x67: OPLABEL(0x67)
         { /* LD H,A */
             REG_H = regA;
             break;
         }
-        case 0x68:
+        case 0x68: OPLABEL(0x68)
         { /* LD L,B */
             REG_L = REG_B;
             break;
         }
-        case 0x69:
+        case 0x69: OPLABEL(0x69)
         { /* LD L,C */
             REG_L = REG_C;
             break;
         }
-        case 0x6A:
+        case 0x6A: OPLABEL(0x6A)
         { /* LD L,D */
             REG_L = REG_D;
             break;
         }
-        case 0x6B:
+        case 0x6B: OPLABEL(0x6B)
         { /* LD L,E */
             REG_L = REG_E;
             break;
         }
-        case 0x6C:
+        case 0x6C: OPLABEL(0x6C)
         { /* LD L,H */
             REG_L = REG_H;
             break;
@@ -1663,88 +2164,88 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //            case 0x6D: {     /* LD L,L */
 //                break;
 //            }
-        case 0x6E:
+        case 0x6E: OPLABEL(0x6E)
         { /* LD L,(HL) */
             REG_L = Z80Ops::peek8(REG_HL);
             break;
         }
-        case 0x6F:
+        case 0x6F: OPLABEL(0x6F)
         { /* LD L,A */
             REG_L = regA;
             break;
         }
-        case 0x70:
+        case 0x70: OPLABEL(0x70)
         { /* LD (HL),B */
             Z80Ops::poke8(REG_HL, REG_B);
             break;
         }
-        case 0x71:
+        case 0x71: OPLABEL(0x71)
         { /* LD (HL),C */
             Z80Ops::poke8(REG_HL, REG_C);
             break;
         }
-        case 0x72:
+        case 0x72: OPLABEL(0x72)
         { /* LD (HL),D */
             Z80Ops::poke8(REG_HL, REG_D);
             break;
         }
-        case 0x73:
+        case 0x73: OPLABEL(0x73)
         { /* LD (HL),E */
             Z80Ops::poke8(REG_HL, REG_E);
             break;
         }
-        case 0x74:
+        case 0x74: OPLABEL(0x74)
         { /* LD (HL),H */
             Z80Ops::poke8(REG_HL, REG_H);
             break;
         }
-        case 0x75:
+        case 0x75: OPLABEL(0x75)
         { /* LD (HL),L */
             Z80Ops::poke8(REG_HL, REG_L);
             break;
         }
-        case 0x76:
+        case 0x76: OPLABEL(0x76)
         { /* HALT */
             REG_PC--;
             halted = true;
             break;
         }
-        case 0x77:
+        case 0x77: OPLABEL(0x77)
         { /* LD (HL),A */
             Z80Ops::poke8(REG_HL, regA);
             break;
         }
-        case 0x78:
+        case 0x78: OPLABEL(0x78)
         { /* LD A,B */
             regA = REG_B;
             break;
         }
-        case 0x79:
+        case 0x79: OPLABEL(0x79)
         { /* LD A,C */
             regA = REG_C;
             break;
         }
-        case 0x7A:
+        case 0x7A: OPLABEL(0x7A)
         { /* LD A,D */
             regA = REG_D;
             break;
         }
-        case 0x7B:
+        case 0x7B: OPLABEL(0x7B)
         { /* LD A,E */
             regA = REG_E;
             break;
         }
-        case 0x7C:
+        case 0x7C: OPLABEL(0x7C)
         { /* LD A,H */
             regA = REG_H;
             break;
         }
-        case 0x7D:
+        case 0x7D: OPLABEL(0x7D)
         { /* LD A,L */
             regA = REG_L;
             break;
         }
-        case 0x7E:
+        case 0x7E: OPLABEL(0x7E)
         { /* LD A,(HL) */
             regA = Z80Ops::peek8(REG_HL);
             break;
@@ -1752,358 +2253,358 @@ void Z80::decodeOpcode(uint8_t opCode) {
 //            case 0x7F: {     /* LD A,A */
 //                break;
 //            }
-        case 0x80:
+        case 0x80: OPLABEL(0x80)
         { /* ADD A,B */
             add(REG_B);
             break;
         }
-        case 0x81:
+        case 0x81: OPLABEL(0x81)
         { /* ADD A,C */
             add(REG_C);
             break;
         }
-        case 0x82:
+        case 0x82: OPLABEL(0x82)
         { /* ADD A,D */
             add(REG_D);
             break;
         }
-        case 0x83:
+        case 0x83: OPLABEL(0x83)
         { /* ADD A,E */
             add(REG_E);
             break;
         }
-        case 0x84:
+        case 0x84: OPLABEL(0x84)
         { /* ADD A,H */
             add(REG_H);
             break;
         }
-        case 0x85:
+        case 0x85: OPLABEL(0x85)
         { /* ADD A,L */
             add(REG_L);
             break;
         }
-        case 0x86:
+        case 0x86: OPLABEL(0x86)
         { /* ADD A,(HL) */
             add(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0x87:
+        case 0x87: OPLABEL(0x87)
         { /* ADD A,A */
             add(regA);
             break;
         }
-        case 0x88:
+        case 0x88: OPLABEL(0x88)
         { /* ADC A,B */
             adc(REG_B);
             break;
         }
-        case 0x89:
+        case 0x89: OPLABEL(0x89)
         { /* ADC A,C */
             adc(REG_C);
             break;
         }
-        case 0x8A:
+        case 0x8A: OPLABEL(0x8A)
         { /* ADC A,D */
             adc(REG_D);
             break;
         }
-        case 0x8B:
+        case 0x8B: OPLABEL(0x8B)
         { /* ADC A,E */
             adc(REG_E);
             break;
         }
-        case 0x8C:
+        case 0x8C: OPLABEL(0x8C)
         { /* ADC A,H */
             adc(REG_H);
             break;
         }
-        case 0x8D:
+        case 0x8D: OPLABEL(0x8D)
         { /* ADC A,L */
             adc(REG_L);
             break;
         }
-        case 0x8E:
+        case 0x8E: OPLABEL(0x8E)
         { /* ADC A,(HL) */
             adc(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0x8F:
+        case 0x8F: OPLABEL(0x8F)
         { /* ADC A,A */
             adc(regA);
             break;
         }
-        case 0x90:
+        case 0x90: OPLABEL(0x90)
         { /* SUB B */
             sub(REG_B);
             break;
         }
-        case 0x91:
+        case 0x91: OPLABEL(0x91)
         { /* SUB C */
             sub(REG_C);
             break;
         }
-        case 0x92:
+        case 0x92: OPLABEL(0x92)
         { /* SUB D */
             sub(REG_D);
             break;
         }
-        case 0x93:
+        case 0x93: OPLABEL(0x93)
         { /* SUB E */
             sub(REG_E);
             break;
         }
-        case 0x94:
+        case 0x94: OPLABEL(0x94)
         { /* SUB H */
             sub(REG_H);
             break;
         }
-        case 0x95:
+        case 0x95: OPLABEL(0x95)
         { /* SUB L */
             sub(REG_L);
             break;
         }
-        case 0x96:
+        case 0x96: OPLABEL(0x96)
         { /* SUB (HL) */
             sub(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0x97:
+        case 0x97: OPLABEL(0x97)
         { /* SUB A */
             sub(regA);
             break;
         }
-        case 0x98:
+        case 0x98: OPLABEL(0x98)
         { /* SBC A,B */
             sbc(REG_B);
             break;
         }
-        case 0x99:
+        case 0x99: OPLABEL(0x99)
         { /* SBC A,C */
             sbc(REG_C);
             break;
         }
-        case 0x9A:
+        case 0x9A: OPLABEL(0x9A)
         { /* SBC A,D */
             sbc(REG_D);
             break;
         }
-        case 0x9B:
+        case 0x9B: OPLABEL(0x9B)
         { /* SBC A,E */
             sbc(REG_E);
             break;
         }
-        case 0x9C:
+        case 0x9C: OPLABEL(0x9C)
         { /* SBC A,H */
             sbc(REG_H);
             break;
         }
-        case 0x9D:
+        case 0x9D: OPLABEL(0x9D)
         { /* SBC A,L */
             sbc(REG_L);
             break;
         }
-        case 0x9E:
+        case 0x9E: OPLABEL(0x9E)
         { /* SBC A,(HL) */
             sbc(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0x9F:
+        case 0x9F: OPLABEL(0x9F)
         { /* SBC A,A */
             sbc(regA);
             break;
         }
-        case 0xA0:
+        case 0xA0: OPLABEL(0xA0)
         { /* AND B */
             and_(REG_B);
             break;
         }
-        case 0xA1:
+        case 0xA1: OPLABEL(0xA1)
         { /* AND C */
             and_(REG_C);
             break;
         }
-        case 0xA2:
+        case 0xA2: OPLABEL(0xA2)
         { /* AND D */
             and_(REG_D);
             break;
         }
-        case 0xA3:
+        case 0xA3: OPLABEL(0xA3)
         { /* AND E */
             and_(REG_E);
             break;
         }
-        case 0xA4:
+        case 0xA4: OPLABEL(0xA4)
         { /* AND H */
             and_(REG_H);
             break;
         }
-        case 0xA5:
+        case 0xA5: OPLABEL(0xA5)
         { /* AND L */
             and_(REG_L);
             break;
         }
-        case 0xA6:
+        case 0xA6: OPLABEL(0xA6)
         { /* AND (HL) */
             and_(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0xA7:
+        case 0xA7: OPLABEL(0xA7)
         { /* AND A */
             and_(regA);
             break;
         }
-        case 0xA8:
+        case 0xA8: OPLABEL(0xA8)
         { /* XOR B */
             xor_(REG_B);
             break;
         }
-        case 0xA9:
+        case 0xA9: OPLABEL(0xA9)
         { /* XOR C */
             xor_(REG_C);
             break;
         }
-        case 0xAA:
+        case 0xAA: OPLABEL(0xAA)
         { /* XOR D */
             xor_(REG_D);
             break;
         }
-        case 0xAB:
+        case 0xAB: OPLABEL(0xAB)
         { /* XOR E */
             xor_(REG_E);
             break;
         }
-        case 0xAC:
+        case 0xAC: OPLABEL(0xAC)
         { /* XOR H */
             xor_(REG_H);
             break;
         }
-        case 0xAD:
+        case 0xAD: OPLABEL(0xAD)
         { /* XOR L */
             xor_(REG_L);
             break;
         }
-        case 0xAE:
+        case 0xAE: OPLABEL(0xAE)
         { /* XOR (HL) */
             xor_(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0xAF:
+        case 0xAF: OPLABEL(0xAF)
         { /* XOR A */
             xor_(regA);
             break;
         }
-        case 0xB0:
+        case 0xB0: OPLABEL(0xB0)
         { /* OR B */
             or_(REG_B);
             break;
         }
-        case 0xB1:
+        case 0xB1: OPLABEL(0xB1)
         { /* OR C */
             or_(REG_C);
             break;
         }
-        case 0xB2:
+        case 0xB2: OPLABEL(0xB2)
         { /* OR D */
             or_(REG_D);
             break;
         }
-        case 0xB3:
+        case 0xB3: OPLABEL(0xB3)
         { /* OR E */
             or_(REG_E);
             break;
         }
-        case 0xB4:
+        case 0xB4: OPLABEL(0xB4)
         { /* OR H */
             or_(REG_H);
             break;
         }
-        case 0xB5:
+        case 0xB5: OPLABEL(0xB5)
         { /* OR L */
             or_(REG_L);
             break;
         }
-        case 0xB6:
+        case 0xB6: OPLABEL(0xB6)
         { /* OR (HL) */
             or_(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0xB7:
+        case 0xB7: OPLABEL(0xB7)
         { /* OR A */
             or_(regA);
             break;
         }
-        case 0xB8:
+        case 0xB8: OPLABEL(0xB8)
         { /* CP B */
             cp(REG_B);
             break;
         }
-        case 0xB9:
+        case 0xB9: OPLABEL(0xB9)
         { /* CP C */
             cp(REG_C);
             break;
         }
-        case 0xBA:
+        case 0xBA: OPLABEL(0xBA)
         { /* CP D */
             cp(REG_D);
             break;
         }
-        case 0xBB:
+        case 0xBB: OPLABEL(0xBB)
         { /* CP E */
             cp(REG_E);
             break;
         }
-        case 0xBC:
+        case 0xBC: OPLABEL(0xBC)
         { /* CP H */
             cp(REG_H);
             break;
         }
-        case 0xBD:
+        case 0xBD: OPLABEL(0xBD)
         { /* CP L */
             cp(REG_L);
             break;
         }
-        case 0xBE:
+        case 0xBE: OPLABEL(0xBE)
         { /* CP (HL) */
             cp(Z80Ops::peek8(REG_HL));
             break;
         }
-        case 0xBF:
+        case 0xBF: OPLABEL(0xBF)
         { /* CP A */
             cp(regA);
             break;
         }
-        case 0xC0:
+        case 0xC0: OPLABEL(0xC0)
         { /* RET NZ */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if ((sz5h3pnFlags & ZERO_MASK) == 0) {
+            if (!isZeroFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
         }
-        case 0xC1:
+        case 0xC1: OPLABEL(0xC1)
         { /* POP BC */
             REG_BC = pop();
             break;
         }
-        case 0xC2:
+        case 0xC2: OPLABEL(0xC2)
         { /* JP NZ,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) == 0) {
+            if (!isZeroFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xC3:
+        case 0xC3: OPLABEL(0xC3)
         { /* JP nn */
             REG_WZ = REG_PC = Z80Ops::peek16(REG_PC);
             break;
         }
-        case 0xC4:
+        case 0xC4: OPLABEL(0xC4)
         { /* CALL NZ,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) == 0) {
+            if (!isZeroFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2112,57 +2613,57 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xC5:
+        case 0xC5: OPLABEL(0xC5)
         { /* PUSH BC */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_BC);
             break;
         }
-        case 0xC6:
+        case 0xC6: OPLABEL(0xC6)
         { /* ADD A,n */
             add(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
         }
-        case 0xC7:
+        case 0xC7: OPLABEL(0xC7)
         { /* RST 00H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x00;
             break;
         }
-        case 0xC8:
+        case 0xC8: OPLABEL(0xC8)
         { /* RET Z */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if ((sz5h3pnFlags & ZERO_MASK) != 0) {
+            if (isZeroFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
         }
-        case 0xC9:
+        case 0xC9: OPLABEL(0xC9)
         { /* RET */
             REG_PC = REG_WZ = pop();
             break;
         }
-        case 0xCA:
+        case 0xCA: OPLABEL(0xCA)
         { /* JP Z,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) != 0) {
+            if (isZeroFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xCB:
+        case 0xCB: OPLABEL(0xCB)
         { /* Subconjunto de instrucciones */
             decodeCB();
             break;
         }
-        case 0xCC:
+        case 0xCC: OPLABEL(0xCC)
         { /* CALL Z,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & ZERO_MASK) != 0) {
+            if (isZeroFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2171,7 +2672,7 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xCD:
+        case 0xCD: OPLABEL(0xCD)
         { /* CALL nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::addressOnBus(REG_PC + 1, 1);
@@ -2179,43 +2680,43 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_WZ;
             break;
         }
-        case 0xCE:
+        case 0xCE: OPLABEL(0xCE)
         { /* ADC A,n */
             adc(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
         }
-        case 0xCF:
+        case 0xCF: OPLABEL(0xCF)
         { /* RST 08H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x08;
             break;
         }
-        case 0xD0:
+        case 0xD0: OPLABEL(0xD0)
         { /* RET NC */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if (!carryFlag) {
+            if (!isCarryFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
         }
-        case 0xD1:
+        case 0xD1: OPLABEL(0xD1)
         { /* POP DE */
             REG_DE = pop();
             break;
         }
-        case 0xD2:
+        case 0xD2: OPLABEL(0xD2)
         { /* JP NC,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (!carryFlag) {
+            if (!isCarryFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xD3:
+        case 0xD3: OPLABEL(0xD3)
         { /* OUT (n),A */
             uint8_t work8 = Z80Ops::peek8(REG_PC);
             REG_PC++;
@@ -2224,10 +2725,10 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_WZ |= (work8 + 1);
             break;
         }
-        case 0xD4:
+        case 0xD4: OPLABEL(0xD4)
         { /* CALL NC,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (!carryFlag) {
+            if (!isCarryFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2236,34 +2737,34 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xD5:
+        case 0xD5: OPLABEL(0xD5)
         { /* PUSH DE */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_DE);
             break;
         }
-        case 0xD6:
+        case 0xD6: OPLABEL(0xD6)
         { /* SUB n */
             sub(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
         }
-        case 0xD7:
+        case 0xD7: OPLABEL(0xD7)
         { /* RST 10H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x10;
             break;
         }
-        case 0xD8:
+        case 0xD8: OPLABEL(0xD8)
         { /* RET C */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if (carryFlag) {
+            if (isCarryFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
         }
-        case 0xD9:
+        case 0xD9: OPLABEL(0xD9)
         { /* EXX */
             uint16_t tmp;
             tmp = REG_BC;
@@ -2279,17 +2780,17 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_HLx = tmp;
             break;
         }
-        case 0xDA:
+        case 0xDA: OPLABEL(0xDA)
         { /* JP C,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (carryFlag) {
+            if (isCarryFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xDB:
+        case 0xDB: OPLABEL(0xDB)
         { /* IN A,(n) */
             REG_W = regA;
             REG_Z = Z80Ops::peek8(REG_PC);
@@ -2299,10 +2800,10 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_WZ++;
             break;
         }
-        case 0xDC:
+        case 0xDC: OPLABEL(0xDC)
         { /* CALL C,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (carryFlag) {
+            if (isCarryFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2311,44 +2812,45 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xDD:
+        case 0xDD: OPLABEL(0xDD)
         { /* Subconjunto de instrucciones */
             opCode = Z80Ops::fetchOpcode(REG_PC++);
             regR++;
+            PROFILE_OPCODE(PROF_DD, opCode);
             decodeDDFD(opCode, regIX);
             break;
         }
-        case 0xDE:
+        case 0xDE: OPLABEL(0xDE)
         { /* SBC A,n */
             sbc(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
         }
-        case 0xDF:
+        case 0xDF: OPLABEL(0xDF)
         { /* RST 18H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x18;
             break;
         }
-        case 0xE0: /* RET PO */
+        case 0xE0: OPLABEL(0xE0) /* RET PO */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if ((sz5h3pnFlags & PARITY_MASK) == 0) {
+            if (!isParOverFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
-        case 0xE1: /* POP HL */
+        case 0xE1: OPLABEL(0xE1) /* POP HL */
             REG_HL = pop();
             break;
-        case 0xE2: /* JP PO,nn */
+        case 0xE2: OPLABEL(0xE2) /* JP PO,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & PARITY_MASK) == 0) {
+            if (!isParOverFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xE3:
+        case 0xE3: OPLABEL(0xE3)
         { /* EX (SP),HL */
             // Instrucción de ejecución sutil.
             RegisterPair work = regHL;
@@ -2361,9 +2863,9 @@ void Z80::decodeOpcode(uint8_t opCode) {
             REG_WZ = REG_HL;
             break;
         }
-        case 0xE4: /* CALL PO,nn */
+        case 0xE4: OPLABEL(0xE4) /* CALL PO,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & PARITY_MASK) == 0) {
+            if (!isParOverFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2371,46 +2873,46 @@ void Z80::decodeOpcode(uint8_t opCode) {
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xE5: /* PUSH HL */
+        case 0xE5: OPLABEL(0xE5) /* PUSH HL */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_HL);
             break;
-        case 0xE6: /* AND n */
+        case 0xE6: OPLABEL(0xE6) /* AND n */
             and_(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
-        case 0xE7: /* RST 20H */
+        case 0xE7: OPLABEL(0xE7) /* RST 20H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x20;
             break;
-        case 0xE8: /* RET PE */
+        case 0xE8: OPLABEL(0xE8) /* RET PE */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if ((sz5h3pnFlags & PARITY_MASK) != 0) {
+            if (isParOverFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
-        case 0xE9: /* JP (HL) */
+        case 0xE9: OPLABEL(0xE9) /* JP (HL) */
             REG_PC = REG_HL;
             break;
-        case 0xEA: /* JP PE,nn */
+        case 0xEA: OPLABEL(0xEA) /* JP PE,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & PARITY_MASK) != 0) {
+            if (isParOverFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xEB:
+        case 0xEB: OPLABEL(0xEB)
         { /* EX DE,HL */
             uint16_t tmp = REG_HL;
             REG_HL = REG_DE;
             REG_DE = tmp;
             break;
         }
-        case 0xEC: /* CALL PE,nn */
+        case 0xEC: OPLABEL(0xEC) /* CALL PE,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if ((sz5h3pnFlags & PARITY_MASK) != 0) {
+            if (isParOverFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2418,43 +2920,44 @@ void Z80::decodeOpcode(uint8_t opCode) {
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xED: /*Subconjunto de instrucciones*/
+        case 0xED: OPLABEL(0xED) /*Subconjunto de instrucciones*/
             opCode = Z80Ops::fetchOpcode(REG_PC++);
             regR++;
+            PROFILE_OPCODE(PROF_ED, opCode);
             decodeED(opCode);
             break;
-        case 0xEE: /* XOR n */
+        case 0xEE: OPLABEL(0xEE) /* XOR n */
             xor_(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
-        case 0xEF: /* RST 28H */
+        case 0xEF: OPLABEL(0xEF) /* RST 28H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x28;
             break;
-        case 0xF0: /* RET P */
+        case 0xF0: OPLABEL(0xF0) /* RET P */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if (sz5h3pnFlags < SIGN_MASK) {
+            if (!isSignFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
-        case 0xF1: /* POP AF */
+        case 0xF1: OPLABEL(0xF1) /* POP AF */
             setRegAF(pop());
             break;
-        case 0xF2: /* JP P,nn */
+        case 0xF2: OPLABEL(0xF2) /* JP P,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (sz5h3pnFlags < SIGN_MASK) {
+            if (!isSignFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xF3: /* DI */
+        case 0xF3: OPLABEL(0xF3) /* DI */
             ffIFF1 = ffIFF2 = false;
             break;
-        case 0xF4: /* CALL P,nn */
+        case 0xF4: OPLABEL(0xF4) /* CALL P,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (sz5h3pnFlags < SIGN_MASK) {
+            if (!isSignFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2462,44 +2965,44 @@ void Z80::decodeOpcode(uint8_t opCode) {
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xF5: /* PUSH AF */
+        case 0xF5: OPLABEL(0xF5) /* PUSH AF */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(getRegAF());
             break;
-        case 0xF6: /* OR n */
+        case 0xF6: OPLABEL(0xF6) /* OR n */
             or_(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
-        case 0xF7: /* RST 30H */
+        case 0xF7: OPLABEL(0xF7) /* RST 30H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x30;
             break;
-        case 0xF8: /* RET M */
+        case 0xF8: OPLABEL(0xF8) /* RET M */
             Z80Ops::addressOnBus(getPairIR().word, 1);
-            if (sz5h3pnFlags > 0x7f) {
+            if (isSignFlag()) {
                 REG_PC = REG_WZ = pop();
             }
             break;
-        case 0xF9: /* LD SP,HL */
+        case 0xF9: OPLABEL(0xF9) /* LD SP,HL */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_SP = REG_HL;
             break;
-        case 0xFA: /* JP M,nn */
+        case 0xFA: OPLABEL(0xFA) /* JP M,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (sz5h3pnFlags > 0x7f) {
+            if (isSignFlag()) {
                 REG_PC = REG_WZ;
                 break;
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xFB: /* EI */
+        case 0xFB: OPLABEL(0xFB) /* EI */
             ffIFF1 = ffIFF2 = true;
             pendingEI = true;
             break;
-        case 0xFC: /* CALL M,nn */
+        case 0xFC: OPLABEL(0xFC) /* CALL M,nn */
             REG_WZ = Z80Ops::peek16(REG_PC);
-            if (sz5h3pnFlags > 0x7f) {
+            if (isSignFlag()) {
                 Z80Ops::addressOnBus(REG_PC + 1, 1);
                 push(REG_PC + 2);
                 REG_PC = REG_WZ;
@@ -2507,60 +3010,100 @@ void Z80::decodeOpcode(uint8_t opCode) {
             }
             REG_PC = REG_PC + 2;
             break;
-        case 0xFD: /* Subconjunto de instrucciones */
+        case 0xFD: OPLABEL(0xFD) /* Subconjunto de instrucciones */
             opCode = Z80Ops::fetchOpcode(REG_PC++);
             regR++;
+            PROFILE_OPCODE(PROF_FD, opCode);
             decodeDDFD(opCode, regIY);
             break;
-        case 0xFE: /* CP n */
+        case 0xFE: OPLABEL(0xFE) /* CP n */
             cp(Z80Ops::peek8(REG_PC));
             REG_PC++;
             break;
-        case 0xFF: /* RST 38H */
+        case 0xFF: OPLABEL(0xFF) /* RST 38H */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(REG_PC);
             REG_PC = REG_WZ = 0x38;
     } /* del switch( codigo ) */
+    OPLABEL(end);
 }
 
 //Subconjunto de instrucciones 0xCB
 
 void Z80::decodeCB(void) {
     uint8_t opCode = Z80Ops::fetchOpcode(REG_PC++);
+    PROFILE_OPCODE(PROF_CB, opCode);
     regR++;
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatch[256] = {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatch[opCode];
+#endif
     switch (opCode) {
-        case 0x00:
+        case 0x00: OPLABEL(0x00)
         { /* RLC B */
             rlc(REG_B);
             break;
         }
-        case 0x01:
+        case 0x01: OPLABEL(0x01)
         { /* RLC C */
             rlc(REG_C);
             break;
         }
-        case 0x02:
+        case 0x02: OPLABEL(0x02)
         { /* RLC D */
             rlc(REG_D);
             break;
         }
-        case 0x03:
+        case 0x03: OPLABEL(0x03)
         { /* RLC E */
             rlc(REG_E);
             break;
         }
-        case 0x04:
+        case 0x04: OPLABEL(0x04)
         { /* RLC H */
             rlc(REG_H);
             break;
         }
-        case 0x05:
+        case 0x05: OPLABEL(0x05)
         { /* RLC L */
             rlc(REG_L);
             break;
         }
-        case 0x06:
+        case 0x06: OPLABEL(0x06)
         { /* RLC (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             rlc(work8);
@@ -2568,42 +3111,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x07:
+        case 0x07: OPLABEL(0x07)
         { /* RLC A */
             rlc(regA);
             break;
         }
-        case 0x08:
+        case 0x08: OPLABEL(0x08)
         { /* RRC B */
             rrc(REG_B);
             break;
         }
-        case 0x09:
+        case 0x09: OPLABEL(0x09)
         { /* RRC C */
             rrc(REG_C);
             break;
         }
-        case 0x0A:
+        case 0x0A: OPLABEL(0x0A)
         { /* RRC D */
             rrc(REG_D);
             break;
         }
-        case 0x0B:
+        case 0x0B: OPLABEL(0x0B)
         { /* RRC E */
             rrc(REG_E);
             break;
         }
-        case 0x0C:
+        case 0x0C: OPLABEL(0x0C)
         { /* RRC H */
             rrc(REG_H);
             break;
         }
-        case 0x0D:
+        case 0x0D: OPLABEL(0x0D)
         { /* RRC L */
             rrc(REG_L);
             break;
         }
-        case 0x0E:
+        case 0x0E: OPLABEL(0x0E)
         { /* RRC (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             rrc(work8);
@@ -2611,42 +3154,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x0F:
+        case 0x0F: OPLABEL(0x0F)
         { /* RRC A */
             rrc(regA);
             break;
         }
-        case 0x10:
+        case 0x10: OPLABEL(0x10)
         { /* RL B */
             rl(REG_B);
             break;
         }
-        case 0x11:
+        case 0x11: OPLABEL(0x11)
         { /* RL C */
             rl(REG_C);
             break;
         }
-        case 0x12:
+        case 0x12: OPLABEL(0x12)
         { /* RL D */
             rl(REG_D);
             break;
         }
-        case 0x13:
+        case 0x13: OPLABEL(0x13)
         { /* RL E */
             rl(REG_E);
             break;
         }
-        case 0x14:
+        case 0x14: OPLABEL(0x14)
         { /* RL H */
             rl(REG_H);
             break;
         }
-        case 0x15:
+        case 0x15: OPLABEL(0x15)
         { /* RL L */
             rl(REG_L);
             break;
         }
-        case 0x16:
+        case 0x16: OPLABEL(0x16)
         { /* RL (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             rl(work8);
@@ -2654,42 +3197,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x17:
+        case 0x17: OPLABEL(0x17)
         { /* RL A */
             rl(regA);
             break;
         }
-        case 0x18:
+        case 0x18: OPLABEL(0x18)
         { /* RR B */
             rr(REG_B);
             break;
         }
-        case 0x19:
+        case 0x19: OPLABEL(0x19)
         { /* RR C */
             rr(REG_C);
             break;
         }
-        case 0x1A:
+        case 0x1A: OPLABEL(0x1A)
         { /* RR D */
             rr(REG_D);
             break;
         }
-        case 0x1B:
+        case 0x1B: OPLABEL(0x1B)
         { /* RR E */
             rr(REG_E);
             break;
         }
-        case 0x1C:
+        case 0x1C: OPLABEL(0x1C)
         { /*RR H*/
             rr(REG_H);
             break;
         }
-        case 0x1D:
+        case 0x1D: OPLABEL(0x1D)
         { /* RR L */
             rr(REG_L);
             break;
         }
-        case 0x1E:
+        case 0x1E: OPLABEL(0x1E)
         { /* RR (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             rr(work8);
@@ -2697,42 +3240,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x1F:
+        case 0x1F: OPLABEL(0x1F)
         { /* RR A */
             rr(regA);
             break;
         }
-        case 0x20:
+        case 0x20: OPLABEL(0x20)
         { /* SLA B */
             sla(REG_B);
             break;
         }
-        case 0x21:
+        case 0x21: OPLABEL(0x21)
         { /* SLA C */
             sla(REG_C);
             break;
         }
-        case 0x22:
+        case 0x22: OPLABEL(0x22)
         { /* SLA D */
             sla(REG_D);
             break;
         }
-        case 0x23:
+        case 0x23: OPLABEL(0x23)
         { /* SLA E */
             sla(REG_E);
             break;
         }
-        case 0x24:
+        case 0x24: OPLABEL(0x24)
         { /* SLA H */
             sla(REG_H);
             break;
         }
-        case 0x25:
+        case 0x25: OPLABEL(0x25)
         { /* SLA L */
             sla(REG_L);
             break;
         }
-        case 0x26:
+        case 0x26: OPLABEL(0x26)
         { /* SLA (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             sla(work8);
@@ -2740,42 +3283,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x27:
+        case 0x27: OPLABEL(0x27)
         { /* SLA A */
             sla(regA);
             break;
         }
-        case 0x28:
+        case 0x28: OPLABEL(0x28)
         { /* SRA B */
             sra(REG_B);
             break;
         }
-        case 0x29:
+        case 0x29: OPLABEL(0x29)
         { /* SRA C */
             sra(REG_C);
             break;
         }
-        case 0x2A:
+        case 0x2A: OPLABEL(0x2A)
         { /* SRA D */
             sra(REG_D);
             break;
         }
-        case 0x2B:
+        case 0x2B: OPLABEL(0x2B)
         { /* SRA E */
             sra(REG_E);
             break;
         }
-        case 0x2C:
+        case 0x2C: OPLABEL(0x2C)
         { /* SRA H */
             sra(REG_H);
             break;
         }
-        case 0x2D:
+        case 0x2D: OPLABEL(0x2D)
         { /* SRA L */
             sra(REG_L);
             break;
         }
-        case 0x2E:
+        case 0x2E: OPLABEL(0x2E)
         { /* SRA (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             sra(work8);
@@ -2783,42 +3326,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x2F:
+        case 0x2F: OPLABEL(0x2F)
         { /* SRA A */
             sra(regA);
             break;
         }
-        case 0x30:
+        case 0x30: OPLABEL(0x30)
         { /* SLL B */
             sll(REG_B);
             break;
         }
-        case 0x31:
+        case 0x31: OPLABEL(0x31)
         { /* SLL C */
             sll(REG_C);
             break;
         }
-        case 0x32:
+        case 0x32: OPLABEL(0x32)
         { /* SLL D */
             sll(REG_D);
             break;
         }
-        case 0x33:
+        case 0x33: OPLABEL(0x33)
         { /* SLL E */
             sll(REG_E);
             break;
         }
-        case 0x34:
+        case 0x34: OPLABEL(0x34)
         { /* SLL H */
             sll(REG_H);
             break;
         }
-        case 0x35:
+        case 0x35: OPLABEL(0x35)
         { /* SLL L */
             sll(REG_L);
             break;
         }
-        case 0x36:
+        case 0x36: OPLABEL(0x36)
         { /* SLL (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             sll(work8);
@@ -2826,42 +3369,42 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x37:
+        case 0x37: OPLABEL(0x37)
         { /* SLL A */
             sll(regA);
             break;
         }
-        case 0x38:
+        case 0x38: OPLABEL(0x38)
         { /* SRL B */
             srl(REG_B);
             break;
         }
-        case 0x39:
+        case 0x39: OPLABEL(0x39)
         { /* SRL C */
             srl(REG_C);
             break;
         }
-        case 0x3A:
+        case 0x3A: OPLABEL(0x3A)
         { /* SRL D */
             srl(REG_D);
             break;
         }
-        case 0x3B:
+        case 0x3B: OPLABEL(0x3B)
         { /* SRL E */
             srl(REG_E);
             break;
         }
-        case 0x3C:
+        case 0x3C: OPLABEL(0x3C)
         { /* SRL H */
             srl(REG_H);
             break;
         }
-        case 0x3D:
+        case 0x3D: OPLABEL(0x3D)
         { /* SRL L */
             srl(REG_L);
             break;
         }
-        case 0x3E:
+        case 0x3E: OPLABEL(0x3E)
         { /* SRL (HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL);
             srl(work8);
@@ -2869,1015 +3412,1015 @@ void Z80::decodeCB(void) {
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x3F:
+        case 0x3F: OPLABEL(0x3F)
         { /* SRL A */
             srl(regA);
             break;
         }
-        case 0x40:
+        case 0x40: OPLABEL(0x40)
         { /* BIT 0,B */
             bitTest(0x01, REG_B);
             break;
         }
-        case 0x41:
+        case 0x41: OPLABEL(0x41)
         { /* BIT 0,C */
             bitTest(0x01, REG_C);
             break;
         }
-        case 0x42:
+        case 0x42: OPLABEL(0x42)
         { /* BIT 0,D */
             bitTest(0x01, REG_D);
             break;
         }
-        case 0x43:
+        case 0x43: OPLABEL(0x43)
         { /* BIT 0,E */
             bitTest(0x01, REG_E);
             break;
         }
-        case 0x44:
+        case 0x44: OPLABEL(0x44)
         { /* BIT 0,H */
             bitTest(0x01, REG_H);
             break;
         }
-        case 0x45:
+        case 0x45: OPLABEL(0x45)
         { /* BIT 0,L */
             bitTest(0x01, REG_L);
             break;
         }
-        case 0x46:
+        case 0x46: OPLABEL(0x46)
         { /* BIT 0,(HL) */
             bitTest(0x01, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x47:
+        case 0x47: OPLABEL(0x47)
         { /* BIT 0,A */
             bitTest(0x01, regA);
             break;
         }
-        case 0x48:
+        case 0x48: OPLABEL(0x48)
         { /* BIT 1,B */
             bitTest(0x02, REG_B);
             break;
         }
-        case 0x49:
+        case 0x49: OPLABEL(0x49)
         { /* BIT 1,C */
             bitTest(0x02, REG_C);
             break;
         }
-        case 0x4A:
+        case 0x4A: OPLABEL(0x4A)
         { /* BIT 1,D */
             bitTest(0x02, REG_D);
             break;
         }
-        case 0x4B:
+        case 0x4B: OPLABEL(0x4B)
         { /* BIT 1,E */
             bitTest(0x02, REG_E);
             break;
         }
-        case 0x4C:
+        case 0x4C: OPLABEL(0x4C)
         { /* BIT 1,H */
             bitTest(0x02, REG_H);
             break;
         }
-        case 0x4D:
+        case 0x4D: OPLABEL(0x4D)
         { /* BIT 1,L */
             bitTest(0x02, REG_L);
             break;
         }
-        case 0x4E:
+        case 0x4E: OPLABEL(0x4E)
         { /* BIT 1,(HL) */
             bitTest(0x02, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x4F:
+        case 0x4F: OPLABEL(0x4F)
         { /* BIT 1,A */
             bitTest(0x02, regA);
             break;
         }
-        case 0x50:
+        case 0x50: OPLABEL(0x50)
         { /* BIT 2,B */
             bitTest(0x04, REG_B);
             break;
         }
-        case 0x51:
+        case 0x51: OPLABEL(0x51)
         { /* BIT 2,C */
             bitTest(0x04, REG_C);
             break;
         }
-        case 0x52:
+        case 0x52: OPLABEL(0x52)
         { /* BIT 2,D */
             bitTest(0x04, REG_D);
             break;
         }
-        case 0x53:
+        case 0x53: OPLABEL(0x53)
         { /* BIT 2,E */
             bitTest(0x04, REG_E);
             break;
         }
-        case 0x54:
+        case 0x54: OPLABEL(0x54)
         { /* BIT 2,H */
             bitTest(0x04, REG_H);
             break;
         }
-        case 0x55:
+        case 0x55: OPLABEL(0x55)
         { /* BIT 2,L */
             bitTest(0x04, REG_L);
             break;
         }
-        case 0x56:
+        case 0x56: OPLABEL(0x56)
         { /* BIT 2,(HL) */
             bitTest(0x04, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x57:
+        case 0x57: OPLABEL(0x57)
         { /* BIT 2,A */
             bitTest(0x04, regA);
             break;
         }
-        case 0x58:
+        case 0x58: OPLABEL(0x58)
         { /* BIT 3,B */
             bitTest(0x08, REG_B);
             break;
         }
-        case 0x59:
+        case 0x59: OPLABEL(0x59)
         { /* BIT 3,C */
             bitTest(0x08, REG_C);
             break;
         }
-        case 0x5A:
+        case 0x5A: OPLABEL(0x5A)
         { /* BIT 3,D */
             bitTest(0x08, REG_D);
             break;
         }
-        case 0x5B:
+        case 0x5B: OPLABEL(0x5B)
         { /* BIT 3,E */
             bitTest(0x08, REG_E);
             break;
         }
-        case 0x5C:
+        case 0x5C: OPLABEL(0x5C)
         { /* BIT 3,H */
             bitTest(0x08, REG_H);
             break;
         }
-        case 0x5D:
+        case 0x5D: OPLABEL(0x5D)
         { /* BIT 3,L */
             bitTest(0x08, REG_L);
             break;
         }
-        case 0x5E:
+        case 0x5E: OPLABEL(0x5E)
         { /* BIT 3,(HL) */
             bitTest(0x08, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x5F:
+        case 0x5F: OPLABEL(0x5F)
         { /* BIT 3,A */
             bitTest(0x08, regA);
             break;
         }
-        case 0x60:
+        case 0x60: OPLABEL(0x60)
         { /* BIT 4,B */
             bitTest(0x10, REG_B);
             break;
         }
-        case 0x61:
+        case 0x61: OPLABEL(0x61)
         { /* BIT 4,C */
             bitTest(0x10, REG_C);
             break;
         }
-        case 0x62:
+        case 0x62: OPLABEL(0x62)
         { /* BIT 4,D */
             bitTest(0x10, REG_D);
             break;
         }
-        case 0x63:
+        case 0x63: OPLABEL(0x63)
         { /* BIT 4,E */
             bitTest(0x10, REG_E);
             break;
         }
-        case 0x64:
+        case 0x64: OPLABEL(0x64)
         { /* BIT 4,H */
             bitTest(0x10, REG_H);
             break;
         }
-        case 0x65:
+        case 0x65: OPLABEL(0x65)
         { /* BIT 4,L */
             bitTest(0x10, REG_L);
             break;
         }
-        case 0x66:
+        case 0x66: OPLABEL(0x66)
         { /* BIT 4,(HL) */
             bitTest(0x10, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x67:
+        case 0x67: OPLABEL(0x67)
         { /* BIT 4,A */
             bitTest(0x10, regA);
             break;
         }
-        case 0x68:
+        case 0x68: OPLABEL(0x68)
         { /* BIT 5,B */
             bitTest(0x20, REG_B);
             break;
         }
-        case 0x69:
+        case 0x69: OPLABEL(0x69)
         { /* BIT 5,C */
             bitTest(0x20, REG_C);
             break;
         }
-        case 0x6A:
+        case 0x6A: OPLABEL(0x6A)
         { /* BIT 5,D */
             bitTest(0x20, REG_D);
             break;
         }
-        case 0x6B:
+        case 0x6B: OPLABEL(0x6B)
         { /* BIT 5,E */
             bitTest(0x20, REG_E);
             break;
         }
-        case 0x6C:
+        case 0x6C: OPLABEL(0x6C)
         { /* BIT 5,H */
             bitTest(0x20, REG_H);
             break;
         }
-        case 0x6D:
+        case 0x6D: OPLABEL(0x6D)
         { /* BIT 5,L */
             bitTest(0x20, REG_L);
             break;
         }
-        case 0x6E:
+        case 0x6E: OPLABEL(0x6E)
         { /* BIT 5,(HL) */
             bitTest(0x20, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x6F:
+        case 0x6F: OPLABEL(0x6F)
         { /* BIT 5,A */
             bitTest(0x20, regA);
             break;
         }
-        case 0x70:
+        case 0x70: OPLABEL(0x70)
         { /* BIT 6,B */
             bitTest(0x40, REG_B);
             break;
         }
-        case 0x71:
+        case 0x71: OPLABEL(0x71)
         { /* BIT 6,C */
             bitTest(0x40, REG_C);
             break;
         }
-        case 0x72:
+        case 0x72: OPLABEL(0x72)
         { /* BIT 6,D */
             bitTest(0x40, REG_D);
             break;
         }
-        case 0x73:
+        case 0x73: OPLABEL(0x73)
         { /* BIT 6,E */
             bitTest(0x40, REG_E);
             break;
         }
-        case 0x74:
+        case 0x74: OPLABEL(0x74)
         { /* BIT 6,H */
             bitTest(0x40, REG_H);
             break;
         }
-        case 0x75:
+        case 0x75: OPLABEL(0x75)
         { /* BIT 6,L */
             bitTest(0x40, REG_L);
             break;
         }
-        case 0x76:
+        case 0x76: OPLABEL(0x76)
         { /* BIT 6,(HL) */
             bitTest(0x40, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x77:
+        case 0x77: OPLABEL(0x77)
         { /* BIT 6,A */
             bitTest(0x40, regA);
             break;
         }
-        case 0x78:
+        case 0x78: OPLABEL(0x78)
         { /* BIT 7,B */
             bitTest(0x80, REG_B);
             break;
         }
-        case 0x79:
+        case 0x79: OPLABEL(0x79)
         { /* BIT 7,C */
             bitTest(0x80, REG_C);
             break;
         }
-        case 0x7A:
+        case 0x7A: OPLABEL(0x7A)
         { /* BIT 7,D */
             bitTest(0x80, REG_D);
             break;
         }
-        case 0x7B:
+        case 0x7B: OPLABEL(0x7B)
         { /* BIT 7,E */
             bitTest(0x80, REG_E);
             break;
         }
-        case 0x7C:
+        case 0x7C: OPLABEL(0x7C)
         { /* BIT 7,H */
             bitTest(0x80, REG_H);
             break;
         }
-        case 0x7D:
+        case 0x7D: OPLABEL(0x7D)
         { /* BIT 7,L */
             bitTest(0x80, REG_L);
             break;
         }
-        case 0x7E:
+        case 0x7E: OPLABEL(0x7E)
         { /* BIT 7,(HL) */
             bitTest(0x80, Z80Ops::peek8(REG_HL));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK) | (REG_W & FLAG_53_MASK);
             Z80Ops::addressOnBus(REG_HL, 1);
             break;
         }
-        case 0x7F:
+        case 0x7F: OPLABEL(0x7F)
         { /* BIT 7,A */
             bitTest(0x80, regA);
             break;
         }
-        case 0x80:
+        case 0x80: OPLABEL(0x80)
         { /* RES 0,B */
             REG_B &= 0xFE;
             break;
         }
-        case 0x81:
+        case 0x81: OPLABEL(0x81)
         { /* RES 0,C */
             REG_C &= 0xFE;
             break;
         }
-        case 0x82:
+        case 0x82: OPLABEL(0x82)
         { /* RES 0,D */
             REG_D &= 0xFE;
             break;
         }
-        case 0x83:
+        case 0x83: OPLABEL(0x83)
         { /* RES 0,E */
             REG_E &= 0xFE;
             break;
         }
-        case 0x84:
+        case 0x84: OPLABEL(0x84)
         { /* RES 0,H */
             REG_H &= 0xFE;
             break;
         }
-        case 0x85:
+        case 0x85: OPLABEL(0x85)
         { /* RES 0,L */
             REG_L &= 0xFE;
             break;
         }
-        case 0x86:
+        case 0x86: OPLABEL(0x86)
         { /* RES 0,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xFE;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x87:
+        case 0x87: OPLABEL(0x87)
         { /* RES 0,A */
             regA &= 0xFE;
             break;
         }
-        case 0x88:
+        case 0x88: OPLABEL(0x88)
         { /* RES 1,B */
             REG_B &= 0xFD;
             break;
         }
-        case 0x89:
+        case 0x89: OPLABEL(0x89)
         { /* RES 1,C */
             REG_C &= 0xFD;
             break;
         }
-        case 0x8A:
+        case 0x8A: OPLABEL(0x8A)
         { /* RES 1,D */
             REG_D &= 0xFD;
             break;
         }
-        case 0x8B:
+        case 0x8B: OPLABEL(0x8B)
         { /* RES 1,E */
             REG_E &= 0xFD;
             break;
         }
-        case 0x8C:
+        case 0x8C: OPLABEL(0x8C)
         { /* RES 1,H */
             REG_H &= 0xFD;
             break;
         }
-        case 0x8D:
+        case 0x8D: OPLABEL(0x8D)
         { /* RES 1,L */
             REG_L &= 0xFD;
             break;
         }
-        case 0x8E:
+        case 0x8E: OPLABEL(0x8E)
         { /* RES 1,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xFD;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x8F:
+        case 0x8F: OPLABEL(0x8F)
         { /* RES 1,A */
             regA &= 0xFD;
             break;
         }
-        case 0x90:
+        case 0x90: OPLABEL(0x90)
         { /* RES 2,B */
             REG_B &= 0xFB;
             break;
         }
-        case 0x91:
+        case 0x91: OPLABEL(0x91)
         { /* RES 2,C */
             REG_C &= 0xFB;
             break;
         }
-        case 0x92:
+        case 0x92: OPLABEL(0x92)
         { /* RES 2,D */
             REG_D &= 0xFB;
             break;
         }
-        case 0x93:
+        case 0x93: OPLABEL(0x93)
         { /* RES 2,E */
             REG_E &= 0xFB;
             break;
         }
-        case 0x94:
+        case 0x94: OPLABEL(0x94)
         { /* RES 2,H */
             REG_H &= 0xFB;
             break;
         }
-        case 0x95:
+        case 0x95: OPLABEL(0x95)
         { /* RES 2,L */
             REG_L &= 0xFB;
             break;
         }
-        case 0x96:
+        case 0x96: OPLABEL(0x96)
         { /* RES 2,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xFB;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x97:
+        case 0x97: OPLABEL(0x97)
         { /* RES 2,A */
             regA &= 0xFB;
             break;
         }
-        case 0x98:
+        case 0x98: OPLABEL(0x98)
         { /* RES 3,B */
             REG_B &= 0xF7;
             break;
         }
-        case 0x99:
+        case 0x99: OPLABEL(0x99)
         { /* RES 3,C */
             REG_C &= 0xF7;
             break;
         }
-        case 0x9A:
+        case 0x9A: OPLABEL(0x9A)
         { /* RES 3,D */
             REG_D &= 0xF7;
             break;
         }
-        case 0x9B:
+        case 0x9B: OPLABEL(0x9B)
         { /* RES 3,E */
             REG_E &= 0xF7;
             break;
         }
-        case 0x9C:
+        case 0x9C: OPLABEL(0x9C)
         { /* RES 3,H */
             REG_H &= 0xF7;
             break;
         }
-        case 0x9D:
+        case 0x9D: OPLABEL(0x9D)
         { /* RES 3,L */
             REG_L &= 0xF7;
             break;
         }
-        case 0x9E:
+        case 0x9E: OPLABEL(0x9E)
         { /* RES 3,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xF7;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0x9F:
+        case 0x9F: OPLABEL(0x9F)
         { /* RES 3,A */
             regA &= 0xF7;
             break;
         }
-        case 0xA0:
+        case 0xA0: OPLABEL(0xA0)
         { /* RES 4,B */
             REG_B &= 0xEF;
             break;
         }
-        case 0xA1:
+        case 0xA1: OPLABEL(0xA1)
         { /* RES 4,C */
             REG_C &= 0xEF;
             break;
         }
-        case 0xA2:
+        case 0xA2: OPLABEL(0xA2)
         { /* RES 4,D */
             REG_D &= 0xEF;
             break;
         }
-        case 0xA3:
+        case 0xA3: OPLABEL(0xA3)
         { /* RES 4,E */
             REG_E &= 0xEF;
             break;
         }
-        case 0xA4:
+        case 0xA4: OPLABEL(0xA4)
         { /* RES 4,H */
             REG_H &= 0xEF;
             break;
         }
-        case 0xA5:
+        case 0xA5: OPLABEL(0xA5)
         { /* RES 4,L */
             REG_L &= 0xEF;
             break;
         }
-        case 0xA6:
+        case 0xA6: OPLABEL(0xA6)
         { /* RES 4,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xEF;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xA7:
+        case 0xA7: OPLABEL(0xA7)
         { /* RES 4,A */
             regA &= 0xEF;
             break;
         }
-        case 0xA8:
+        case 0xA8: OPLABEL(0xA8)
         { /* RES 5,B */
             REG_B &= 0xDF;
             break;
         }
-        case 0xA9:
+        case 0xA9: OPLABEL(0xA9)
         { /* RES 5,C */
             REG_C &= 0xDF;
             break;
         }
-        case 0xAA:
+        case 0xAA: OPLABEL(0xAA)
         { /* RES 5,D */
             REG_D &= 0xDF;
             break;
         }
-        case 0xAB:
+        case 0xAB: OPLABEL(0xAB)
         { /* RES 5,E */
             REG_E &= 0xDF;
             break;
         }
-        case 0xAC:
+        case 0xAC: OPLABEL(0xAC)
         { /* RES 5,H */
             REG_H &= 0xDF;
             break;
         }
-        case 0xAD:
+        case 0xAD: OPLABEL(0xAD)
         { /* RES 5,L */
             REG_L &= 0xDF;
             break;
         }
-        case 0xAE:
+        case 0xAE: OPLABEL(0xAE)
         { /* RES 5,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xDF;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xAF:
+        case 0xAF: OPLABEL(0xAF)
         { /* RES 5,A */
             regA &= 0xDF;
             break;
         }
-        case 0xB0:
+        case 0xB0: OPLABEL(0xB0)
         { /* RES 6,B */
             REG_B &= 0xBF;
             break;
         }
-        case 0xB1:
+        case 0xB1: OPLABEL(0xB1)
         { /* RES 6,C */
             REG_C &= 0xBF;
             break;
         }
-        case 0xB2:
+        case 0xB2: OPLABEL(0xB2)
         { /* RES 6,D */
             REG_D &= 0xBF;
             break;
         }
-        case 0xB3:
+        case 0xB3: OPLABEL(0xB3)
         { /* RES 6,E */
             REG_E &= 0xBF;
             break;
         }
-        case 0xB4:
+        case 0xB4: OPLABEL(0xB4)
         { /* RES 6,H */
             REG_H &= 0xBF;
             break;
         }
-        case 0xB5:
+        case 0xB5: OPLABEL(0xB5)
         { /* RES 6,L */
             REG_L &= 0xBF;
             break;
         }
-        case 0xB6:
+        case 0xB6: OPLABEL(0xB6)
         { /* RES 6,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0xBF;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xB7:
+        case 0xB7: OPLABEL(0xB7)
         { /* RES 6,A */
             regA &= 0xBF;
             break;
         }
-        case 0xB8:
+        case 0xB8: OPLABEL(0xB8)
         { /* RES 7,B */
             REG_B &= 0x7F;
             break;
         }
-        case 0xB9:
+        case 0xB9: OPLABEL(0xB9)
         { /* RES 7,C */
             REG_C &= 0x7F;
             break;
         }
-        case 0xBA:
+        case 0xBA: OPLABEL(0xBA)
         { /* RES 7,D */
             REG_D &= 0x7F;
             break;
         }
-        case 0xBB:
+        case 0xBB: OPLABEL(0xBB)
         { /* RES 7,E */
             REG_E &= 0x7F;
             break;
         }
-        case 0xBC:
+        case 0xBC: OPLABEL(0xBC)
         { /* RES 7,H */
             REG_H &= 0x7F;
             break;
         }
-        case 0xBD:
+        case 0xBD: OPLABEL(0xBD)
         { /* RES 7,L */
             REG_L &= 0x7F;
             break;
         }
-        case 0xBE:
+        case 0xBE: OPLABEL(0xBE)
         { /* RES 7,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) & 0x7F;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xBF:
+        case 0xBF: OPLABEL(0xBF)
         { /* RES 7,A */
             regA &= 0x7F;
             break;
         }
-        case 0xC0:
+        case 0xC0: OPLABEL(0xC0)
         { /* SET 0,B */
             REG_B |= 0x01;
             break;
         }
-        case 0xC1:
+        case 0xC1: OPLABEL(0xC1)
         { /* SET 0,C */
             REG_C |= 0x01;
             break;
         }
-        case 0xC2:
+        case 0xC2: OPLABEL(0xC2)
         { /* SET 0,D */
             REG_D |= 0x01;
             break;
         }
-        case 0xC3:
+        case 0xC3: OPLABEL(0xC3)
         { /* SET 0,E */
             REG_E |= 0x01;
             break;
         }
-        case 0xC4:
+        case 0xC4: OPLABEL(0xC4)
         { /* SET 0,H */
             REG_H |= 0x01;
             break;
         }
-        case 0xC5:
+        case 0xC5: OPLABEL(0xC5)
         { /* SET 0,L */
             REG_L |= 0x01;
             break;
         }
-        case 0xC6:
+        case 0xC6: OPLABEL(0xC6)
         { /* SET 0,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x01;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xC7:
+        case 0xC7: OPLABEL(0xC7)
         { /* SET 0,A */
             regA |= 0x01;
             break;
         }
-        case 0xC8:
+        case 0xC8: OPLABEL(0xC8)
         { /* SET 1,B */
             REG_B |= 0x02;
             break;
         }
-        case 0xC9:
+        case 0xC9: OPLABEL(0xC9)
         { /* SET 1,C */
             REG_C |= 0x02;
             break;
         }
-        case 0xCA:
+        case 0xCA: OPLABEL(0xCA)
         { /* SET 1,D */
             REG_D |= 0x02;
             break;
         }
-        case 0xCB:
+        case 0xCB: OPLABEL(0xCB)
         { /* SET 1,E */
             REG_E |= 0x02;
             break;
         }
-        case 0xCC:
+        case 0xCC: OPLABEL(0xCC)
         { /* SET 1,H */
             REG_H |= 0x02;
             break;
         }
-        case 0xCD:
+        case 0xCD: OPLABEL(0xCD)
         { /* SET 1,L */
             REG_L |= 0x02;
             break;
         }
-        case 0xCE:
+        case 0xCE: OPLABEL(0xCE)
         { /* SET 1,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x02;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xCF:
+        case 0xCF: OPLABEL(0xCF)
         { /* SET 1,A */
             regA |= 0x02;
             break;
         }
-        case 0xD0:
+        case 0xD0: OPLABEL(0xD0)
         { /* SET 2,B */
             REG_B |= 0x04;
             break;
         }
-        case 0xD1:
+        case 0xD1: OPLABEL(0xD1)
         { /* SET 2,C */
             REG_C |= 0x04;
             break;
         }
-        case 0xD2:
+        case 0xD2: OPLABEL(0xD2)
         { /* SET 2,D */
             REG_D |= 0x04;
             break;
         }
-        case 0xD3:
+        case 0xD3: OPLABEL(0xD3)
         { /* SET 2,E */
             REG_E |= 0x04;
             break;
         }
-        case 0xD4:
+        case 0xD4: OPLABEL(0xD4)
         { /* SET 2,H */
             REG_H |= 0x04;
             break;
         }
-        case 0xD5:
+        case 0xD5: OPLABEL(0xD5)
         { /* SET 2,L */
             REG_L |= 0x04;
             break;
         }
-        case 0xD6:
+        case 0xD6: OPLABEL(0xD6)
         { /* SET 2,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x04;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xD7:
+        case 0xD7: OPLABEL(0xD7)
         { /* SET 2,A */
             regA |= 0x04;
             break;
         }
-        case 0xD8:
+        case 0xD8: OPLABEL(0xD8)
         { /* SET 3,B */
             REG_B |= 0x08;
             break;
         }
-        case 0xD9:
+        case 0xD9: OPLABEL(0xD9)
         { /* SET 3,C */
             REG_C |= 0x08;
             break;
         }
-        case 0xDA:
+        case 0xDA: OPLABEL(0xDA)
         { /* SET 3,D */
             REG_D |= 0x08;
             break;
         }
-        case 0xDB:
+        case 0xDB: OPLABEL(0xDB)
         { /* SET 3,E */
             REG_E |= 0x08;
             break;
         }
-        case 0xDC:
+        case 0xDC: OPLABEL(0xDC)
         { /* SET 3,H */
             REG_H |= 0x08;
             break;
         }
-        case 0xDD:
+        case 0xDD: OPLABEL(0xDD)
         { /* SET 3,L */
             REG_L |= 0x08;
             break;
         }
-        case 0xDE:
+        case 0xDE: OPLABEL(0xDE)
         { /* SET 3,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x08;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xDF:
+        case 0xDF: OPLABEL(0xDF)
         { /* SET 3,A */
             regA |= 0x08;
             break;
         }
-        case 0xE0:
+        case 0xE0: OPLABEL(0xE0)
         { /* SET 4,B */
             REG_B |= 0x10;
             break;
         }
-        case 0xE1:
+        case 0xE1: OPLABEL(0xE1)
         { /* SET 4,C */
             REG_C |= 0x10;
             break;
         }
-        case 0xE2:
+        case 0xE2: OPLABEL(0xE2)
         { /* SET 4,D */
             REG_D |= 0x10;
             break;
         }
-        case 0xE3:
+        case 0xE3: OPLABEL(0xE3)
         { /* SET 4,E */
             REG_E |= 0x10;
             break;
         }
-        case 0xE4:
+        case 0xE4: OPLABEL(0xE4)
         { /* SET 4,H */
             REG_H |= 0x10;
             break;
         }
-        case 0xE5:
+        case 0xE5: OPLABEL(0xE5)
         { /* SET 4,L */
             REG_L |= 0x10;
             break;
         }
-        case 0xE6:
+        case 0xE6: OPLABEL(0xE6)
         { /* SET 4,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x10;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xE7:
+        case 0xE7: OPLABEL(0xE7)
         { /* SET 4,A */
             regA |= 0x10;
             break;
         }
-        case 0xE8:
+        case 0xE8: OPLABEL(0xE8)
         { /* SET 5,B */
             REG_B |= 0x20;
             break;
         }
-        case 0xE9:
+        case 0xE9: OPLABEL(0xE9)
         { /* SET 5,C */
             REG_C |= 0x20;
             break;
         }
-        case 0xEA:
+        case 0xEA: OPLABEL(0xEA)
         { /* SET 5,D */
             REG_D |= 0x20;
             break;
         }
-        case 0xEB:
+        case 0xEB: OPLABEL(0xEB)
         { /* SET 5,E */
             REG_E |= 0x20;
             break;
         }
-        case 0xEC:
+        case 0xEC: OPLABEL(0xEC)
         { /* SET 5,H */
             REG_H |= 0x20;
             break;
         }
-        case 0xED:
+        case 0xED: OPLABEL(0xED)
         { /* SET 5,L */
             REG_L |= 0x20;
             break;
         }
-        case 0xEE:
+        case 0xEE: OPLABEL(0xEE)
         { /* SET 5,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x20;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xEF:
+        case 0xEF: OPLABEL(0xEF)
         { /* SET 5,A */
             regA |= 0x20;
             break;
         }
-        case 0xF0:
+        case 0xF0: OPLABEL(0xF0)
         { /* SET 6,B */
             REG_B |= 0x40;
             break;
         }
-        case 0xF1:
+        case 0xF1: OPLABEL(0xF1)
         { /* SET 6,C */
             REG_C |= 0x40;
             break;
         }
-        case 0xF2:
+        case 0xF2: OPLABEL(0xF2)
         { /* SET 6,D */
             REG_D |= 0x40;
             break;
         }
-        case 0xF3:
+        case 0xF3: OPLABEL(0xF3)
         { /* SET 6,E */
             REG_E |= 0x40;
             break;
         }
-        case 0xF4:
+        case 0xF4: OPLABEL(0xF4)
         { /* SET 6,H */
             REG_H |= 0x40;
             break;
         }
-        case 0xF5:
+        case 0xF5: OPLABEL(0xF5)
         { /* SET 6,L */
             REG_L |= 0x40;
             break;
         }
-        case 0xF6:
+        case 0xF6: OPLABEL(0xF6)
         { /* SET 6,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x40;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xF7:
+        case 0xF7: OPLABEL(0xF7)
         { /* SET 6,A */
             regA |= 0x40;
             break;
         }
-        case 0xF8:
+        case 0xF8: OPLABEL(0xF8)
         { /* SET 7,B */
             REG_B |= 0x80;
             break;
         }
-        case 0xF9:
+        case 0xF9: OPLABEL(0xF9)
         { /* SET 7,C */
             REG_C |= 0x80;
             break;
         }
-        case 0xFA:
+        case 0xFA: OPLABEL(0xFA)
         { /* SET 7,D */
             REG_D |= 0x80;
             break;
         }
-        case 0xFB:
+        case 0xFB: OPLABEL(0xFB)
         { /* SET 7,E */
             REG_E |= 0x80;
             break;
         }
-        case 0xFC:
+        case 0xFC: OPLABEL(0xFC)
         { /* SET 7,H */
             REG_H |= 0x80;
             break;
         }
-        case 0xFD:
+        case 0xFD: OPLABEL(0xFD)
         { /* SET 7,L */
             REG_L |= 0x80;
             break;
         }
-        case 0xFE:
+        case 0xFE: OPLABEL(0xFE)
         { /* SET 7,(HL) */
             uint8_t work8 = Z80Ops::peek8(REG_HL) | 0x80;
             Z80Ops::addressOnBus(REG_HL, 1);
             Z80Ops::poke8(REG_HL, work8);
             break;
         }
-        case 0xFF:
+        case 0xFF: OPLABEL(0xFF)
         { /* SET 7,A */
             regA |= 0x80;
             break;
@@ -3904,90 +4447,127 @@ void Z80::decodeCB(void) {
  * interrupciones entre cada prefijo.
  */
 void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatch[256] = {
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x09, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x19, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_default,
+        &&op_default, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x34, &&op_0x35, &&op_0x36, &&op_default,
+        &&op_default, &&op_0x39, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x44, &&op_0x45, &&op_0x46, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x54, &&op_0x55, &&op_0x56, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_default,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_default, &&op_0x77,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x84, &&op_0x85, &&op_0x86, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x94, &&op_0x95, &&op_0x96, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_0xCB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xDD, &&op_default, &&op_default,
+        &&op_default, &&op_0xE1, &&op_default, &&op_0xE3, &&op_default, &&op_0xE5, &&op_default, &&op_default,
+        &&op_default, &&op_0xE9, &&op_default, &&op_default, &&op_default, &&op_0xED, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_0xF9, &&op_default, &&op_default, &&op_default, &&op_0xFD, &&op_default, &&op_default
+    };
+    goto *dispatch[opCode];
+#endif
     switch (opCode) {
-        case 0x09:
+        case 0x09: OPLABEL(0x09)
         { /* ADD IX,BC */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regIXY, REG_BC);
             break;
         }
-        case 0x19:
+        case 0x19: OPLABEL(0x19)
         { /* ADD IX,DE */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regIXY, REG_DE);
             break;
         }
-        case 0x21:
+        case 0x21: OPLABEL(0x21)
         { /* LD IX,nn */
             regIXY.word = Z80Ops::peek16(REG_PC);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x22:
+        case 0x22: OPLABEL(0x22)
         { /* LD (nn),IX */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ++, regIXY);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x23:
+        case 0x23: OPLABEL(0x23)
         { /* INC IX */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             regIXY.word++;
             break;
         }
-        case 0x24:
+        case 0x24: OPLABEL(0x24)
         { /* INC IXh */
             inc8(regIXY.byte8.hi);
             break;
         }
-        case 0x25:
+        case 0x25: OPLABEL(0x25)
         { /* DEC IXh */
             dec8(regIXY.byte8.hi);
             break;
         }
-        case 0x26:
+        case 0x26: OPLABEL(0x26)
         { /* LD IXh,n */
             regIXY.byte8.hi = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x29:
+        case 0x29: OPLABEL(0x29)
         { /* ADD IX,IX */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regIXY, regIXY.word);
             break;
         }
-        case 0x2A:
+        case 0x2A: OPLABEL(0x2A)
         { /* LD IX,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             regIXY.word = Z80Ops::peek16(REG_WZ++);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x2B:
+        case 0x2B: OPLABEL(0x2B)
         { /* DEC IX */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             regIXY.word--;
             break;
         }
-        case 0x2C:
+        case 0x2C: OPLABEL(0x2C)
         { /* INC IXl */
             inc8(regIXY.byte8.lo);
             break;
         }
-        case 0x2D:
+        case 0x2D: OPLABEL(0x2D)
         { /* DEC IXl */
             dec8(regIXY.byte8.lo);
             break;
         }
-        case 0x2E:
+        case 0x2E: OPLABEL(0x2E)
         { /* LD IXl,n */
             regIXY.byte8.lo = Z80Ops::peek8(REG_PC);
             REG_PC++;
             break;
         }
-        case 0x34:
+        case 0x34: OPLABEL(0x34)
         { /* INC (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -3998,7 +4578,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, work8);
             break;
         }
-        case 0x35:
+        case 0x35: OPLABEL(0x35)
         { /* DEC (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4009,7 +4589,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, work8);
             break;
         }
-        case 0x36:
+        case 0x36: OPLABEL(0x36)
         { /* LD (IX+d),n */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             REG_PC++;
@@ -4019,23 +4599,23 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, work8);
             break;
         }
-        case 0x39:
+        case 0x39: OPLABEL(0x39)
         { /* ADD IX,SP */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             add16(regIXY, REG_SP);
             break;
         }
-        case 0x44:
+        case 0x44: OPLABEL(0x44)
         { /* LD B,IXh */
             REG_B = regIXY.byte8.hi;
             break;
         }
-        case 0x45:
+        case 0x45: OPLABEL(0x45)
         { /* LD B,IXl */
             REG_B = regIXY.byte8.lo;
             break;
         }
-        case 0x46:
+        case 0x46: OPLABEL(0x46)
         { /* LD B,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4043,17 +4623,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_B = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x4C:
+        case 0x4C: OPLABEL(0x4C)
         { /* LD C,IXh */
             REG_C = regIXY.byte8.hi;
             break;
         }
-        case 0x4D:
+        case 0x4D: OPLABEL(0x4D)
         { /* LD C,IXl */
             REG_C = regIXY.byte8.lo;
             break;
         }
-        case 0x4E:
+        case 0x4E: OPLABEL(0x4E)
         { /* LD C,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4061,17 +4641,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_C = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x54:
+        case 0x54: OPLABEL(0x54)
         { /* LD D,IXh */
             REG_D = regIXY.byte8.hi;
             break;
         }
-        case 0x55:
+        case 0x55: OPLABEL(0x55)
         { /* LD D,IXl */
             REG_D = regIXY.byte8.lo;
             break;
         }
-        case 0x56:
+        case 0x56: OPLABEL(0x56)
         { /* LD D,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4079,17 +4659,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_D = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x5C:
+        case 0x5C: OPLABEL(0x5C)
         { /* LD E,IXh */
             REG_E = regIXY.byte8.hi;
             break;
         }
-        case 0x5D:
+        case 0x5D: OPLABEL(0x5D)
         { /* LD E,IXl */
             REG_E = regIXY.byte8.lo;
             break;
         }
-        case 0x5E:
+        case 0x5E: OPLABEL(0x5E)
         { /* LD E,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4097,36 +4677,36 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_E = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x60:
+        case 0x60: OPLABEL(0x60)
         { /* LD IXh,B */
             regIXY.byte8.hi = REG_B;
             break;
         }
-        case 0x61:
+        case 0x61: OPLABEL(0x61)
         { /* LD IXh,C */
             regIXY.byte8.hi = REG_C;
             break;
         }
-        case 0x62:
+        case 0x62: OPLABEL(0x62)
         { /* LD IXh,D */
             regIXY.byte8.hi = REG_D;
             break;
         }
-        case 0x63:
+        case 0x63: OPLABEL(0x63)
         { /* LD IXh,E */
             regIXY.byte8.hi = REG_E;
             break;
         }
-        case 0x64:
+        case 0x64: OPLABEL(0x64)
         { /* LD IXh,IXh */
             break;
         }
-        case 0x65:
+        case 0x65: OPLABEL(0x65)
         { /* LD IXh,IXl */
             regIXY.byte8.hi = regIXY.byte8.lo;
             break;
         }
-        case 0x66:
+        case 0x66: OPLABEL(0x66)
         { /* LD H,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4134,41 +4714,41 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_H = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x67:
+        case 0x67: OPLABEL(0x67)
         { /* LD IXh,A */
             regIXY.byte8.hi = regA;
             break;
         }
-        case 0x68:
+        case 0x68: OPLABEL(0x68)
         { /* LD IXl,B */
             regIXY.byte8.lo = REG_B;
             break;
         }
-        case 0x69:
+        case 0x69: OPLABEL(0x69)
         { /* LD IXl,C */
             regIXY.byte8.lo = REG_C;
             break;
         }
-        case 0x6A:
+        case 0x6A: OPLABEL(0x6A)
         { /* LD IXl,D */
             regIXY.byte8.lo = REG_D;
             break;
         }
-        case 0x6B:
+        case 0x6B: OPLABEL(0x6B)
         { /* LD IXl,E */
             regIXY.byte8.lo = REG_E;
             break;
         }
-        case 0x6C:
+        case 0x6C: OPLABEL(0x6C)
         { /* LD IXl,IXh */
             regIXY.byte8.lo = regIXY.byte8.hi;
             break;
         }
-        case 0x6D:
+        case 0x6D: OPLABEL(0x6D)
         { /* LD IXl,IXl */
             break;
         }
-        case 0x6E:
+        case 0x6E: OPLABEL(0x6E)
         { /* LD L,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4176,12 +4756,12 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_L = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x6F:
+        case 0x6F: OPLABEL(0x6F)
         { /* LD IXl,A */
             regIXY.byte8.lo = regA;
             break;
         }
-        case 0x70:
+        case 0x70: OPLABEL(0x70)
         { /* LD (IX+d),B */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4189,7 +4769,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_B);
             break;
         }
-        case 0x71:
+        case 0x71: OPLABEL(0x71)
         { /* LD (IX+d),C */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4197,7 +4777,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_C);
             break;
         }
-        case 0x72:
+        case 0x72: OPLABEL(0x72)
         { /* LD (IX+d),D */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4205,7 +4785,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_D);
             break;
         }
-        case 0x73:
+        case 0x73: OPLABEL(0x73)
         { /* LD (IX+d),E */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4213,7 +4793,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_E);
             break;
         }
-        case 0x74:
+        case 0x74: OPLABEL(0x74)
         { /* LD (IX+d),H */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4221,7 +4801,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_H);
             break;
         }
-        case 0x75:
+        case 0x75: OPLABEL(0x75)
         { /* LD (IX+d),L */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4229,7 +4809,7 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, REG_L);
             break;
         }
-        case 0x77:
+        case 0x77: OPLABEL(0x77)
         { /* LD (IX+d),A */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4237,17 +4817,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             Z80Ops::poke8(REG_WZ, regA);
             break;
         }
-        case 0x7C:
+        case 0x7C: OPLABEL(0x7C)
         { /* LD A,IXh */
             regA = regIXY.byte8.hi;
             break;
         }
-        case 0x7D:
+        case 0x7D: OPLABEL(0x7D)
         { /* LD A,IXl */
             regA = regIXY.byte8.lo;
             break;
         }
-        case 0x7E:
+        case 0x7E: OPLABEL(0x7E)
         { /* LD A,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4255,17 +4835,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             regA = Z80Ops::peek8(REG_WZ);
             break;
         }
-        case 0x84:
+        case 0x84: OPLABEL(0x84)
         { /* ADD A,IXh */
             add(regIXY.byte8.hi);
             break;
         }
-        case 0x85:
+        case 0x85: OPLABEL(0x85)
         { /* ADD A,IXl */
             add(regIXY.byte8.lo);
             break;
         }
-        case 0x86:
+        case 0x86: OPLABEL(0x86)
         { /* ADD A,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4273,17 +4853,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             add(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0x8C:
+        case 0x8C: OPLABEL(0x8C)
         { /* ADC A,IXh */
             adc(regIXY.byte8.hi);
             break;
         }
-        case 0x8D:
+        case 0x8D: OPLABEL(0x8D)
         { /* ADC A,IXl */
             adc(regIXY.byte8.lo);
             break;
         }
-        case 0x8E:
+        case 0x8E: OPLABEL(0x8E)
         { /* ADC A,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4291,17 +4871,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             adc(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0x94:
+        case 0x94: OPLABEL(0x94)
         { /* SUB IXh */
             sub(regIXY.byte8.hi);
             break;
         }
-        case 0x95:
+        case 0x95: OPLABEL(0x95)
         { /* SUB IXl */
             sub(regIXY.byte8.lo);
             break;
         }
-        case 0x96:
+        case 0x96: OPLABEL(0x96)
         { /* SUB (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4309,17 +4889,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             sub(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0x9C:
+        case 0x9C: OPLABEL(0x9C)
         { /* SBC A,IXh */
             sbc(regIXY.byte8.hi);
             break;
         }
-        case 0x9D:
+        case 0x9D: OPLABEL(0x9D)
         { /* SBC A,IXl */
             sbc(regIXY.byte8.lo);
             break;
         }
-        case 0x9E:
+        case 0x9E: OPLABEL(0x9E)
         { /* SBC A,(IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4327,17 +4907,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             sbc(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0xA4:
+        case 0xA4: OPLABEL(0xA4)
         { /* AND IXh */
             and_(regIXY.byte8.hi);
             break;
         }
-        case 0xA5:
+        case 0xA5: OPLABEL(0xA5)
         { /* AND IXl */
             and_(regIXY.byte8.lo);
             break;
         }
-        case 0xA6:
+        case 0xA6: OPLABEL(0xA6)
         { /* AND (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4345,17 +4925,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             and_(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0xAC:
+        case 0xAC: OPLABEL(0xAC)
         { /* XOR IXh */
             xor_(regIXY.byte8.hi);
             break;
         }
-        case 0xAD:
+        case 0xAD: OPLABEL(0xAD)
         { /* XOR IXl */
             xor_(regIXY.byte8.lo);
             break;
         }
-        case 0xAE:
+        case 0xAE: OPLABEL(0xAE)
         { /* XOR (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4363,17 +4943,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             xor_(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0xB4:
+        case 0xB4: OPLABEL(0xB4)
         { /* OR IXh */
             or_(regIXY.byte8.hi);
             break;
         }
-        case 0xB5:
+        case 0xB5: OPLABEL(0xB5)
         { /* OR IXl */
             or_(regIXY.byte8.lo);
             break;
         }
-        case 0xB6:
+        case 0xB6: OPLABEL(0xB6)
         { /* OR (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4381,17 +4961,17 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             or_(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0xBC:
+        case 0xBC: OPLABEL(0xBC)
         { /* CP IXh */
             cp(regIXY.byte8.hi);
             break;
         }
-        case 0xBD:
+        case 0xBD: OPLABEL(0xBD)
         { /* CP IXl */
             cp(regIXY.byte8.lo);
             break;
         }
-        case 0xBE:
+        case 0xBE: OPLABEL(0xBE)
         { /* CP (IX+d) */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 5);
@@ -4399,25 +4979,26 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             cp(Z80Ops::peek8(REG_WZ));
             break;
         }
-        case 0xCB:
+        case 0xCB: OPLABEL(0xCB)
         { /* Subconjunto de instrucciones */
             REG_WZ = regIXY.word + (int8_t) Z80Ops::peek8(REG_PC);
             REG_PC++;
             opCode = Z80Ops::peek8(REG_PC);
             Z80Ops::addressOnBus(REG_PC, 2);
             REG_PC++;
+            PROFILE_OPCODE(PROF_DDCB, opCode);
             decodeDDFDCB(opCode, REG_WZ);
             break;
         }
-        case 0xDD:
+        case 0xDD: OPLABEL(0xDD)
             prefixOpcode = 0xDD;
             break;
-        case 0xE1:
+        case 0xE1: OPLABEL(0xE1)
         { /* POP IX */
             regIXY.word = pop();
             break;
         }
-        case 0xE3:
+        case 0xE3: OPLABEL(0xE3)
         { /* EX (SP),IX */
             // Instrucción de ejecución sutil como pocas... atento al dato.
             RegisterPair work16 = regIXY;
@@ -4431,45 +5012,40 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
             REG_WZ = regIXY.word;
             break;
         }
-        case 0xE5:
+        case 0xE5: OPLABEL(0xE5)
         { /* PUSH IX */
             Z80Ops::addressOnBus(getPairIR().word, 1);
             push(regIXY.word);
             break;
         }
-        case 0xE9:
+        case 0xE9: OPLABEL(0xE9)
         { /* JP (IX) */
             REG_PC = regIXY.word;
             break;
         }
-        case 0xED:
+        case 0xED: OPLABEL(0xED)
         {
             prefixOpcode = 0xED;
             break;
         }
-        case 0xF9:
+        case 0xF9: OPLABEL(0xF9)
         { /* LD SP,IX */
             Z80Ops::addressOnBus(getPairIR().word, 2);
             REG_SP = regIXY.word;
             break;
         }
-        case 0xFD:
+        case 0xFD: OPLABEL(0xFD)
         {
             prefixOpcode = 0xFD;
             break;
         }
-        default:
+        default: OPLABEL(default)
         {
             // Detrás de un DD/FD o varios en secuencia venía un código
             // que no correspondía con una instrucción que involucra a
             // IX o IY. Se trata como si fuera un código normal.
             // Sin esto, además de emular mal, falla el test
             // ld <bcdexya>,<bcdexya> de ZEXALL.
-#ifdef WITH_BREAKPOINT_SUPPORT
-            if (breakpointEnabled && prefixOpcode == 0) {
-                opCode = Z80Ops::breakpoint(REG_PC, opCode);
-            }
-#endif
             decodeOpcode(opCode);
             break;
         }
@@ -4479,15 +5055,52 @@ void Z80::decodeDDFD(uint8_t opCode, RegisterPair& regIXY) {
 // Subconjunto de instrucciones 0xDDCB
 void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
 
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatch[256] = {
+        &&op_0x00, &&op_0x01, &&op_0x02, &&op_0x03, &&op_0x04, &&op_0x05, &&op_0x06, &&op_0x07,
+        &&op_0x08, &&op_0x09, &&op_0x0A, &&op_0x0B, &&op_0x0C, &&op_0x0D, &&op_0x0E, &&op_0x0F,
+        &&op_0x10, &&op_0x11, &&op_0x12, &&op_0x13, &&op_0x14, &&op_0x15, &&op_0x16, &&op_0x17,
+        &&op_0x18, &&op_0x19, &&op_0x1A, &&op_0x1B, &&op_0x1C, &&op_0x1D, &&op_0x1E, &&op_0x1F,
+        &&op_0x20, &&op_0x21, &&op_0x22, &&op_0x23, &&op_0x24, &&op_0x25, &&op_0x26, &&op_0x27,
+        &&op_0x28, &&op_0x29, &&op_0x2A, &&op_0x2B, &&op_0x2C, &&op_0x2D, &&op_0x2E, &&op_0x2F,
+        &&op_0x30, &&op_0x31, &&op_0x32, &&op_0x33, &&op_0x34, &&op_0x35, &&op_0x36, &&op_0x37,
+        &&op_0x38, &&op_0x39, &&op_0x3A, &&op_0x3B, &&op_0x3C, &&op_0x3D, &&op_0x3E, &&op_0x3F,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_0x77,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_0x7F,
+        &&op_0x80, &&op_0x81, &&op_0x82, &&op_0x83, &&op_0x84, &&op_0x85, &&op_0x86, &&op_0x87,
+        &&op_0x88, &&op_0x89, &&op_0x8A, &&op_0x8B, &&op_0x8C, &&op_0x8D, &&op_0x8E, &&op_0x8F,
+        &&op_0x90, &&op_0x91, &&op_0x92, &&op_0x93, &&op_0x94, &&op_0x95, &&op_0x96, &&op_0x97,
+        &&op_0x98, &&op_0x99, &&op_0x9A, &&op_0x9B, &&op_0x9C, &&op_0x9D, &&op_0x9E, &&op_0x9F,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_0xA4, &&op_0xA5, &&op_0xA6, &&op_0xA7,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_0xAC, &&op_0xAD, &&op_0xAE, &&op_0xAF,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_0xB4, &&op_0xB5, &&op_0xB6, &&op_0xB7,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_0xBC, &&op_0xBD, &&op_0xBE, &&op_0xBF,
+        &&op_0xC0, &&op_0xC1, &&op_0xC2, &&op_0xC3, &&op_0xC4, &&op_0xC5, &&op_0xC6, &&op_0xC7,
+        &&op_0xC8, &&op_0xC9, &&op_0xCA, &&op_0xCB, &&op_0xCC, &&op_0xCD, &&op_0xCE, &&op_0xCF,
+        &&op_0xD0, &&op_0xD1, &&op_0xD2, &&op_0xD3, &&op_0xD4, &&op_0xD5, &&op_0xD6, &&op_0xD7,
+        &&op_0xD8, &&op_0xD9, &&op_0xDA, &&op_0xDB, &&op_0xDC, &&op_0xDD, &&op_0xDE, &&op_0xDF,
+        &&op_0xE0, &&op_0xE1, &&op_0xE2, &&op_0xE3, &&op_0xE4, &&op_0xE5, &&op_0xE6, &&op_0xE7,
+        &&op_0xE8, &&op_0xE9, &&op_0xEA, &&op_0xEB, &&op_0xEC, &&op_0xED, &&op_0xEE, &&op_0xEF,
+        &&op_0xF0, &&op_0xF1, &&op_0xF2, &&op_0xF3, &&op_0xF4, &&op_0xF5, &&op_0xF6, &&op_0xF7,
+        &&op_0xF8, &&op_0xF9, &&op_0xFA, &&op_0xFB, &&op_0xFC, &&op_0xFD, &&op_0xFE, &&op_0xFF
+    };
+    goto *dispatch[opCode];
+#endif
     switch (opCode) {
-        case 0x00: /* RLC (IX+d),B */
-        case 0x01: /* RLC (IX+d),C */
-        case 0x02: /* RLC (IX+d),D */
-        case 0x03: /* RLC (IX+d),E */
-        case 0x04: /* RLC (IX+d),H */
-        case 0x05: /* RLC (IX+d),L */
-        case 0x06: /* RLC (IX+d)   */
-        case 0x07: /* RLC (IX+d),A */
+        case 0x00: OPLABEL(0x00) /* RLC (IX+d),B */
+        case 0x01: OPLABEL(0x01) /* RLC (IX+d),C */
+        case 0x02: OPLABEL(0x02) /* RLC (IX+d),D */
+        case 0x03: OPLABEL(0x03) /* RLC (IX+d),E */
+        case 0x04: OPLABEL(0x04) /* RLC (IX+d),H */
+        case 0x05: OPLABEL(0x05) /* RLC (IX+d),L */
+        case 0x06: OPLABEL(0x06) /* RLC (IX+d)   */
+        case 0x07: OPLABEL(0x07) /* RLC (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             rlc(work8);
@@ -4496,14 +5109,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x08: /* RRC (IX+d),B */
-        case 0x09: /* RRC (IX+d),C */
-        case 0x0A: /* RRC (IX+d),D */
-        case 0x0B: /* RRC (IX+d),E */
-        case 0x0C: /* RRC (IX+d),H */
-        case 0x0D: /* RRC (IX+d),L */
-        case 0x0E: /* RRC (IX+d)   */
-        case 0x0F: /* RRC (IX+d),A */
+        case 0x08: OPLABEL(0x08) /* RRC (IX+d),B */
+        case 0x09: OPLABEL(0x09) /* RRC (IX+d),C */
+        case 0x0A: OPLABEL(0x0A) /* RRC (IX+d),D */
+        case 0x0B: OPLABEL(0x0B) /* RRC (IX+d),E */
+        case 0x0C: OPLABEL(0x0C) /* RRC (IX+d),H */
+        case 0x0D: OPLABEL(0x0D) /* RRC (IX+d),L */
+        case 0x0E: OPLABEL(0x0E) /* RRC (IX+d)   */
+        case 0x0F: OPLABEL(0x0F) /* RRC (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             rrc(work8);
@@ -4512,14 +5125,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x10: /* RL (IX+d),B */
-        case 0x11: /* RL (IX+d),C */
-        case 0x12: /* RL (IX+d),D */
-        case 0x13: /* RL (IX+d),E */
-        case 0x14: /* RL (IX+d),H */
-        case 0x15: /* RL (IX+d),L */
-        case 0x16: /* RL (IX+d)   */
-        case 0x17: /* RL (IX+d),A */
+        case 0x10: OPLABEL(0x10) /* RL (IX+d),B */
+        case 0x11: OPLABEL(0x11) /* RL (IX+d),C */
+        case 0x12: OPLABEL(0x12) /* RL (IX+d),D */
+        case 0x13: OPLABEL(0x13) /* RL (IX+d),E */
+        case 0x14: OPLABEL(0x14) /* RL (IX+d),H */
+        case 0x15: OPLABEL(0x15) /* RL (IX+d),L */
+        case 0x16: OPLABEL(0x16) /* RL (IX+d)   */
+        case 0x17: OPLABEL(0x17) /* RL (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             rl(work8);
@@ -4528,14 +5141,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x18: /* RR (IX+d),B */
-        case 0x19: /* RR (IX+d),C */
-        case 0x1A: /* RR (IX+d),D */
-        case 0x1B: /* RR (IX+d),E */
-        case 0x1C: /* RR (IX+d),H */
-        case 0x1D: /* RR (IX+d),L */
-        case 0x1E: /* RR (IX+d)   */
-        case 0x1F: /* RR (IX+d),A */
+        case 0x18: OPLABEL(0x18) /* RR (IX+d),B */
+        case 0x19: OPLABEL(0x19) /* RR (IX+d),C */
+        case 0x1A: OPLABEL(0x1A) /* RR (IX+d),D */
+        case 0x1B: OPLABEL(0x1B) /* RR (IX+d),E */
+        case 0x1C: OPLABEL(0x1C) /* RR (IX+d),H */
+        case 0x1D: OPLABEL(0x1D) /* RR (IX+d),L */
+        case 0x1E: OPLABEL(0x1E) /* RR (IX+d)   */
+        case 0x1F: OPLABEL(0x1F) /* RR (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             rr(work8);
@@ -4544,14 +5157,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x20: /* SLA (IX+d),B */
-        case 0x21: /* SLA (IX+d),C */
-        case 0x22: /* SLA (IX+d),D */
-        case 0x23: /* SLA (IX+d),E */
-        case 0x24: /* SLA (IX+d),H */
-        case 0x25: /* SLA (IX+d),L */
-        case 0x26: /* SLA (IX+d)   */
-        case 0x27: /* SLA (IX+d),A */
+        case 0x20: OPLABEL(0x20) /* SLA (IX+d),B */
+        case 0x21: OPLABEL(0x21) /* SLA (IX+d),C */
+        case 0x22: OPLABEL(0x22) /* SLA (IX+d),D */
+        case 0x23: OPLABEL(0x23) /* SLA (IX+d),E */
+        case 0x24: OPLABEL(0x24) /* SLA (IX+d),H */
+        case 0x25: OPLABEL(0x25) /* SLA (IX+d),L */
+        case 0x26: OPLABEL(0x26) /* SLA (IX+d)   */
+        case 0x27: OPLABEL(0x27) /* SLA (IX+d),A */
         {
              uint8_t work8 = Z80Ops::peek8(address);
              sla(work8);
@@ -4560,14 +5173,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
              copyToRegister(opCode, work8);
             break;
         }
-        case 0x28: /* SRA (IX+d),B */
-        case 0x29: /* SRA (IX+d),C */
-        case 0x2A: /* SRA (IX+d),D */
-        case 0x2B: /* SRA (IX+d),E */
-        case 0x2C: /* SRA (IX+d),H */
-        case 0x2D: /* SRA (IX+d),L */
-        case 0x2E: /* SRA (IX+d)   */
-        case 0x2F: /* SRA (IX+d),A */
+        case 0x28: OPLABEL(0x28) /* SRA (IX+d),B */
+        case 0x29: OPLABEL(0x29) /* SRA (IX+d),C */
+        case 0x2A: OPLABEL(0x2A) /* SRA (IX+d),D */
+        case 0x2B: OPLABEL(0x2B) /* SRA (IX+d),E */
+        case 0x2C: OPLABEL(0x2C) /* SRA (IX+d),H */
+        case 0x2D: OPLABEL(0x2D) /* SRA (IX+d),L */
+        case 0x2E: OPLABEL(0x2E) /* SRA (IX+d)   */
+        case 0x2F: OPLABEL(0x2F) /* SRA (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             sra(work8);
@@ -4576,14 +5189,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x30: /* SLL (IX+d),B */
-        case 0x31: /* SLL (IX+d),C */
-        case 0x32: /* SLL (IX+d),D */
-        case 0x33: /* SLL (IX+d),E */
-        case 0x34: /* SLL (IX+d),H */
-        case 0x35: /* SLL (IX+d),L */
-        case 0x36: /* SLL (IX+d)   */
-        case 0x37: /* SLL (IX+d),A */
+        case 0x30: OPLABEL(0x30) /* SLL (IX+d),B */
+        case 0x31: OPLABEL(0x31) /* SLL (IX+d),C */
+        case 0x32: OPLABEL(0x32) /* SLL (IX+d),D */
+        case 0x33: OPLABEL(0x33) /* SLL (IX+d),E */
+        case 0x34: OPLABEL(0x34) /* SLL (IX+d),H */
+        case 0x35: OPLABEL(0x35) /* SLL (IX+d),L */
+        case 0x36: OPLABEL(0x36) /* SLL (IX+d)   */
+        case 0x37: OPLABEL(0x37) /* SLL (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             sll(work8);
@@ -4592,14 +5205,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x38: /* SRL (IX+d),B */
-        case 0x39: /* SRL (IX+d),C */
-        case 0x3A: /* SRL (IX+d),D */
-        case 0x3B: /* SRL (IX+d),E */
-        case 0x3C: /* SRL (IX+d),H */
-        case 0x3D: /* SRL (IX+d),L */
-        case 0x3E: /* SRL (IX+d)   */
-        case 0x3F: /* SRL (IX+d),A */
+        case 0x38: OPLABEL(0x38) /* SRL (IX+d),B */
+        case 0x39: OPLABEL(0x39) /* SRL (IX+d),C */
+        case 0x3A: OPLABEL(0x3A) /* SRL (IX+d),D */
+        case 0x3B: OPLABEL(0x3B) /* SRL (IX+d),E */
+        case 0x3C: OPLABEL(0x3C) /* SRL (IX+d),H */
+        case 0x3D: OPLABEL(0x3D) /* SRL (IX+d),L */
+        case 0x3E: OPLABEL(0x3E) /* SRL (IX+d)   */
+        case 0x3F: OPLABEL(0x3F) /* SRL (IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address);
             srl(work8);
@@ -4608,14 +5221,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x40:
-        case 0x41:
-        case 0x42:
-        case 0x43:
-        case 0x44:
-        case 0x45:
-        case 0x46:
-        case 0x47:
+        case 0x40: OPLABEL(0x40)
+        case 0x41: OPLABEL(0x41)
+        case 0x42: OPLABEL(0x42)
+        case 0x43: OPLABEL(0x43)
+        case 0x44: OPLABEL(0x44)
+        case 0x45: OPLABEL(0x45)
+        case 0x46: OPLABEL(0x46)
+        case 0x47: OPLABEL(0x47)
         { /* BIT 0,(IX+d) */
             bitTest(0x01, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4623,14 +5236,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x48:
-        case 0x49:
-        case 0x4A:
-        case 0x4B:
-        case 0x4C:
-        case 0x4D:
-        case 0x4E:
-        case 0x4F:
+        case 0x48: OPLABEL(0x48)
+        case 0x49: OPLABEL(0x49)
+        case 0x4A: OPLABEL(0x4A)
+        case 0x4B: OPLABEL(0x4B)
+        case 0x4C: OPLABEL(0x4C)
+        case 0x4D: OPLABEL(0x4D)
+        case 0x4E: OPLABEL(0x4E)
+        case 0x4F: OPLABEL(0x4F)
         { /* BIT 1,(IX+d) */
             bitTest(0x02, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4638,14 +5251,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x50:
-        case 0x51:
-        case 0x52:
-        case 0x53:
-        case 0x54:
-        case 0x55:
-        case 0x56:
-        case 0x57:
+        case 0x50: OPLABEL(0x50)
+        case 0x51: OPLABEL(0x51)
+        case 0x52: OPLABEL(0x52)
+        case 0x53: OPLABEL(0x53)
+        case 0x54: OPLABEL(0x54)
+        case 0x55: OPLABEL(0x55)
+        case 0x56: OPLABEL(0x56)
+        case 0x57: OPLABEL(0x57)
         { /* BIT 2,(IX+d) */
             bitTest(0x04, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4653,14 +5266,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x58:
-        case 0x59:
-        case 0x5A:
-        case 0x5B:
-        case 0x5C:
-        case 0x5D:
-        case 0x5E:
-        case 0x5F:
+        case 0x58: OPLABEL(0x58)
+        case 0x59: OPLABEL(0x59)
+        case 0x5A: OPLABEL(0x5A)
+        case 0x5B: OPLABEL(0x5B)
+        case 0x5C: OPLABEL(0x5C)
+        case 0x5D: OPLABEL(0x5D)
+        case 0x5E: OPLABEL(0x5E)
+        case 0x5F: OPLABEL(0x5F)
         { /* BIT 3,(IX+d) */
             bitTest(0x08, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4668,14 +5281,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x60:
-        case 0x61:
-        case 0x62:
-        case 0x63:
-        case 0x64:
-        case 0x65:
-        case 0x66:
-        case 0x67:
+        case 0x60: OPLABEL(0x60)
+        case 0x61: OPLABEL(0x61)
+        case 0x62: OPLABEL(0x62)
+        case 0x63: OPLABEL(0x63)
+        case 0x64: OPLABEL(0x64)
+        case 0x65: OPLABEL(0x65)
+        case 0x66: OPLABEL(0x66)
+        case 0x67: OPLABEL(0x67)
         { /* BIT 4,(IX+d) */
             bitTest(0x10, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4683,14 +5296,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x68:
-        case 0x69:
-        case 0x6A:
-        case 0x6B:
-        case 0x6C:
-        case 0x6D:
-        case 0x6E:
-        case 0x6F:
+        case 0x68: OPLABEL(0x68)
+        case 0x69: OPLABEL(0x69)
+        case 0x6A: OPLABEL(0x6A)
+        case 0x6B: OPLABEL(0x6B)
+        case 0x6C: OPLABEL(0x6C)
+        case 0x6D: OPLABEL(0x6D)
+        case 0x6E: OPLABEL(0x6E)
+        case 0x6F: OPLABEL(0x6F)
         { /* BIT 5,(IX+d) */
             bitTest(0x20, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4698,14 +5311,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x70:
-        case 0x71:
-        case 0x72:
-        case 0x73:
-        case 0x74:
-        case 0x75:
-        case 0x76:
-        case 0x77:
+        case 0x70: OPLABEL(0x70)
+        case 0x71: OPLABEL(0x71)
+        case 0x72: OPLABEL(0x72)
+        case 0x73: OPLABEL(0x73)
+        case 0x74: OPLABEL(0x74)
+        case 0x75: OPLABEL(0x75)
+        case 0x76: OPLABEL(0x76)
+        case 0x77: OPLABEL(0x77)
         { /* BIT 6,(IX+d) */
             bitTest(0x40, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4713,14 +5326,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x78:
-        case 0x79:
-        case 0x7A:
-        case 0x7B:
-        case 0x7C:
-        case 0x7D:
-        case 0x7E:
-        case 0x7F:
+        case 0x78: OPLABEL(0x78)
+        case 0x79: OPLABEL(0x79)
+        case 0x7A: OPLABEL(0x7A)
+        case 0x7B: OPLABEL(0x7B)
+        case 0x7C: OPLABEL(0x7C)
+        case 0x7D: OPLABEL(0x7D)
+        case 0x7E: OPLABEL(0x7E)
+        case 0x7F: OPLABEL(0x7F)
         { /* BIT 7,(IX+d) */
             bitTest(0x80, Z80Ops::peek8(address));
             sz5h3pnFlags = (sz5h3pnFlags & FLAG_SZHP_MASK)
@@ -4728,14 +5341,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             Z80Ops::addressOnBus(address, 1);
             break;
         }
-        case 0x80: /* RES 0,(IX+d),B */
-        case 0x81: /* RES 0,(IX+d),C */
-        case 0x82: /* RES 0,(IX+d),D */
-        case 0x83: /* RES 0,(IX+d),E */
-        case 0x84: /* RES 0,(IX+d),H */
-        case 0x85: /* RES 0,(IX+d),L */
-        case 0x86: /* RES 0,(IX+d)   */
-        case 0x87: /* RES 0,(IX+d),A */
+        case 0x80: OPLABEL(0x80) /* RES 0,(IX+d),B */
+        case 0x81: OPLABEL(0x81) /* RES 0,(IX+d),C */
+        case 0x82: OPLABEL(0x82) /* RES 0,(IX+d),D */
+        case 0x83: OPLABEL(0x83) /* RES 0,(IX+d),E */
+        case 0x84: OPLABEL(0x84) /* RES 0,(IX+d),H */
+        case 0x85: OPLABEL(0x85) /* RES 0,(IX+d),L */
+        case 0x86: OPLABEL(0x86) /* RES 0,(IX+d)   */
+        case 0x87: OPLABEL(0x87) /* RES 0,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xFE;
             Z80Ops::addressOnBus(address, 1);
@@ -4743,14 +5356,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x88: /* RES 1,(IX+d),B */
-        case 0x89: /* RES 1,(IX+d),C */
-        case 0x8A: /* RES 1,(IX+d),D */
-        case 0x8B: /* RES 1,(IX+d),E */
-        case 0x8C: /* RES 1,(IX+d),H */
-        case 0x8D: /* RES 1,(IX+d),L */
-        case 0x8E: /* RES 1,(IX+d)   */
-        case 0x8F: /* RES 1,(IX+d),A */
+        case 0x88: OPLABEL(0x88) /* RES 1,(IX+d),B */
+        case 0x89: OPLABEL(0x89) /* RES 1,(IX+d),C */
+        case 0x8A: OPLABEL(0x8A) /* RES 1,(IX+d),D */
+        case 0x8B: OPLABEL(0x8B) /* RES 1,(IX+d),E */
+        case 0x8C: OPLABEL(0x8C) /* RES 1,(IX+d),H */
+        case 0x8D: OPLABEL(0x8D) /* RES 1,(IX+d),L */
+        case 0x8E: OPLABEL(0x8E) /* RES 1,(IX+d)   */
+        case 0x8F: OPLABEL(0x8F) /* RES 1,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xFD;
             Z80Ops::addressOnBus(address, 1);
@@ -4758,14 +5371,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x90: /* RES 2,(IX+d),B */
-        case 0x91: /* RES 2,(IX+d),C */
-        case 0x92: /* RES 2,(IX+d),D */
-        case 0x93: /* RES 2,(IX+d),E */
-        case 0x94: /* RES 2,(IX+d),H */
-        case 0x95: /* RES 2,(IX+d),L */
-        case 0x96: /* RES 2,(IX+d)   */
-        case 0x97: /* RES 2,(IX+d),A */
+        case 0x90: OPLABEL(0x90) /* RES 2,(IX+d),B */
+        case 0x91: OPLABEL(0x91) /* RES 2,(IX+d),C */
+        case 0x92: OPLABEL(0x92) /* RES 2,(IX+d),D */
+        case 0x93: OPLABEL(0x93) /* RES 2,(IX+d),E */
+        case 0x94: OPLABEL(0x94) /* RES 2,(IX+d),H */
+        case 0x95: OPLABEL(0x95) /* RES 2,(IX+d),L */
+        case 0x96: OPLABEL(0x96) /* RES 2,(IX+d)   */
+        case 0x97: OPLABEL(0x97) /* RES 2,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xFB;
             Z80Ops::addressOnBus(address, 1);
@@ -4773,14 +5386,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0x98: /* RES 3,(IX+d),B */
-        case 0x99: /* RES 3,(IX+d),C */
-        case 0x9A: /* RES 3,(IX+d),D */
-        case 0x9B: /* RES 3,(IX+d),E */
-        case 0x9C: /* RES 3,(IX+d),H */
-        case 0x9D: /* RES 3,(IX+d),L */
-        case 0x9E: /* RES 3,(IX+d)   */
-        case 0x9F: /* RES 3,(IX+d),A */
+        case 0x98: OPLABEL(0x98) /* RES 3,(IX+d),B */
+        case 0x99: OPLABEL(0x99) /* RES 3,(IX+d),C */
+        case 0x9A: OPLABEL(0x9A) /* RES 3,(IX+d),D */
+        case 0x9B: OPLABEL(0x9B) /* RES 3,(IX+d),E */
+        case 0x9C: OPLABEL(0x9C) /* RES 3,(IX+d),H */
+        case 0x9D: OPLABEL(0x9D) /* RES 3,(IX+d),L */
+        case 0x9E: OPLABEL(0x9E) /* RES 3,(IX+d)   */
+        case 0x9F: OPLABEL(0x9F) /* RES 3,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xF7;
             Z80Ops::addressOnBus(address, 1);
@@ -4788,14 +5401,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xA0: /* RES 4,(IX+d),B */
-        case 0xA1: /* RES 4,(IX+d),C */
-        case 0xA2: /* RES 4,(IX+d),D */
-        case 0xA3: /* RES 4,(IX+d),E */
-        case 0xA4: /* RES 4,(IX+d),H */
-        case 0xA5: /* RES 4,(IX+d),L */
-        case 0xA6: /* RES 4,(IX+d)   */
-        case 0xA7: /* RES 4,(IX+d),A */
+        case 0xA0: OPLABEL(0xA0) /* RES 4,(IX+d),B */
+        case 0xA1: OPLABEL(0xA1) /* RES 4,(IX+d),C */
+        case 0xA2: OPLABEL(0xA2) /* RES 4,(IX+d),D */
+        case 0xA3: OPLABEL(0xA3) /* RES 4,(IX+d),E */
+        case 0xA4: OPLABEL(0xA4) /* RES 4,(IX+d),H */
+        case 0xA5: OPLABEL(0xA5) /* RES 4,(IX+d),L */
+        case 0xA6: OPLABEL(0xA6) /* RES 4,(IX+d)   */
+        case 0xA7: OPLABEL(0xA7) /* RES 4,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xEF;
             Z80Ops::addressOnBus(address, 1);
@@ -4803,14 +5416,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xA8: /* RES 5,(IX+d),B */
-        case 0xA9: /* RES 5,(IX+d),C */
-        case 0xAA: /* RES 5,(IX+d),D */
-        case 0xAB: /* RES 5,(IX+d),E */
-        case 0xAC: /* RES 5,(IX+d),H */
-        case 0xAD: /* RES 5,(IX+d),L */
-        case 0xAE: /* RES 5,(IX+d)   */
-        case 0xAF: /* RES 5,(IX+d),A */
+        case 0xA8: OPLABEL(0xA8) /* RES 5,(IX+d),B */
+        case 0xA9: OPLABEL(0xA9) /* RES 5,(IX+d),C */
+        case 0xAA: OPLABEL(0xAA) /* RES 5,(IX+d),D */
+        case 0xAB: OPLABEL(0xAB) /* RES 5,(IX+d),E */
+        case 0xAC: OPLABEL(0xAC) /* RES 5,(IX+d),H */
+        case 0xAD: OPLABEL(0xAD) /* RES 5,(IX+d),L */
+        case 0xAE: OPLABEL(0xAE) /* RES 5,(IX+d)   */
+        case 0xAF: OPLABEL(0xAF) /* RES 5,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xDF;
             Z80Ops::addressOnBus(address, 1);
@@ -4818,14 +5431,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xB0: /* RES 6,(IX+d),B */
-        case 0xB1: /* RES 6,(IX+d),C */
-        case 0xB2: /* RES 6,(IX+d),D */
-        case 0xB3: /* RES 6,(IX+d),E */
-        case 0xB4: /* RES 6,(IX+d),H */
-        case 0xB5: /* RES 6,(IX+d),L */
-        case 0xB6: /* RES 6,(IX+d)   */
-        case 0xB7: /* RES 6,(IX+d),A */
+        case 0xB0: OPLABEL(0xB0) /* RES 6,(IX+d),B */
+        case 0xB1: OPLABEL(0xB1) /* RES 6,(IX+d),C */
+        case 0xB2: OPLABEL(0xB2) /* RES 6,(IX+d),D */
+        case 0xB3: OPLABEL(0xB3) /* RES 6,(IX+d),E */
+        case 0xB4: OPLABEL(0xB4) /* RES 6,(IX+d),H */
+        case 0xB5: OPLABEL(0xB5) /* RES 6,(IX+d),L */
+        case 0xB6: OPLABEL(0xB6) /* RES 6,(IX+d)   */
+        case 0xB7: OPLABEL(0xB7) /* RES 6,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0xBF;
             Z80Ops::addressOnBus(address, 1);
@@ -4833,14 +5446,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xB8: /* RES 7,(IX+d),B */
-        case 0xB9: /* RES 7,(IX+d),C */
-        case 0xBA: /* RES 7,(IX+d),D */
-        case 0xBB: /* RES 7,(IX+d),E */
-        case 0xBC: /* RES 7,(IX+d),H */
-        case 0xBD: /* RES 7,(IX+d),L */
-        case 0xBE: /* RES 7,(IX+d)   */
-        case 0xBF: /* RES 7,(IX+d),A */
+        case 0xB8: OPLABEL(0xB8) /* RES 7,(IX+d),B */
+        case 0xB9: OPLABEL(0xB9) /* RES 7,(IX+d),C */
+        case 0xBA: OPLABEL(0xBA) /* RES 7,(IX+d),D */
+        case 0xBB: OPLABEL(0xBB) /* RES 7,(IX+d),E */
+        case 0xBC: OPLABEL(0xBC) /* RES 7,(IX+d),H */
+        case 0xBD: OPLABEL(0xBD) /* RES 7,(IX+d),L */
+        case 0xBE: OPLABEL(0xBE) /* RES 7,(IX+d)   */
+        case 0xBF: OPLABEL(0xBF) /* RES 7,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) & 0x7F;
             Z80Ops::addressOnBus(address, 1);
@@ -4848,14 +5461,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xC0: /* SET 0,(IX+d),B */
-        case 0xC1: /* SET 0,(IX+d),C */
-        case 0xC2: /* SET 0,(IX+d),D */
-        case 0xC3: /* SET 0,(IX+d),E */
-        case 0xC4: /* SET 0,(IX+d),H */
-        case 0xC5: /* SET 0,(IX+d),L */
-        case 0xC6: /* SET 0,(IX+d)   */
-        case 0xC7: /* SET 0,(IX+d),A */
+        case 0xC0: OPLABEL(0xC0) /* SET 0,(IX+d),B */
+        case 0xC1: OPLABEL(0xC1) /* SET 0,(IX+d),C */
+        case 0xC2: OPLABEL(0xC2) /* SET 0,(IX+d),D */
+        case 0xC3: OPLABEL(0xC3) /* SET 0,(IX+d),E */
+        case 0xC4: OPLABEL(0xC4) /* SET 0,(IX+d),H */
+        case 0xC5: OPLABEL(0xC5) /* SET 0,(IX+d),L */
+        case 0xC6: OPLABEL(0xC6) /* SET 0,(IX+d)   */
+        case 0xC7: OPLABEL(0xC7) /* SET 0,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x01;
             Z80Ops::addressOnBus(address, 1);
@@ -4863,14 +5476,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xC8: /* SET 1,(IX+d),B */
-        case 0xC9: /* SET 1,(IX+d),C */
-        case 0xCA: /* SET 1,(IX+d),D */
-        case 0xCB: /* SET 1,(IX+d),E */
-        case 0xCC: /* SET 1,(IX+d),H */
-        case 0xCD: /* SET 1,(IX+d),L */
-        case 0xCE: /* SET 1,(IX+d)   */
-        case 0xCF: /* SET 1,(IX+d),A */
+        case 0xC8: OPLABEL(0xC8) /* SET 1,(IX+d),B */
+        case 0xC9: OPLABEL(0xC9) /* SET 1,(IX+d),C */
+        case 0xCA: OPLABEL(0xCA) /* SET 1,(IX+d),D */
+        case 0xCB: OPLABEL(0xCB) /* SET 1,(IX+d),E */
+        case 0xCC: OPLABEL(0xCC) /* SET 1,(IX+d),H */
+        case 0xCD: OPLABEL(0xCD) /* SET 1,(IX+d),L */
+        case 0xCE: OPLABEL(0xCE) /* SET 1,(IX+d)   */
+        case 0xCF: OPLABEL(0xCF) /* SET 1,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x02;
             Z80Ops::addressOnBus(address, 1);
@@ -4878,14 +5491,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xD0: /* SET 2,(IX+d),B */
-        case 0xD1: /* SET 2,(IX+d),C */
-        case 0xD2: /* SET 2,(IX+d),D */
-        case 0xD3: /* SET 2,(IX+d),E */
-        case 0xD4: /* SET 2,(IX+d),H */
-        case 0xD5: /* SET 2,(IX+d),L */
-        case 0xD6: /* SET 2,(IX+d)   */
-        case 0xD7: /* SET 2,(IX+d),A */
+        case 0xD0: OPLABEL(0xD0) /* SET 2,(IX+d),B */
+        case 0xD1: OPLABEL(0xD1) /* SET 2,(IX+d),C */
+        case 0xD2: OPLABEL(0xD2) /* SET 2,(IX+d),D */
+        case 0xD3: OPLABEL(0xD3) /* SET 2,(IX+d),E */
+        case 0xD4: OPLABEL(0xD4) /* SET 2,(IX+d),H */
+        case 0xD5: OPLABEL(0xD5) /* SET 2,(IX+d),L */
+        case 0xD6: OPLABEL(0xD6) /* SET 2,(IX+d)   */
+        case 0xD7: OPLABEL(0xD7) /* SET 2,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x04;
             Z80Ops::addressOnBus(address, 1);
@@ -4893,14 +5506,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xD8: /* SET 3,(IX+d),B */
-        case 0xD9: /* SET 3,(IX+d),C */
-        case 0xDA: /* SET 3,(IX+d),D */
-        case 0xDB: /* SET 3,(IX+d),E */
-        case 0xDC: /* SET 3,(IX+d),H */
-        case 0xDD: /* SET 3,(IX+d),L */
-        case 0xDE: /* SET 3,(IX+d)   */
-        case 0xDF: /* SET 3,(IX+d),A */
+        case 0xD8: OPLABEL(0xD8) /* SET 3,(IX+d),B */
+        case 0xD9: OPLABEL(0xD9) /* SET 3,(IX+d),C */
+        case 0xDA: OPLABEL(0xDA) /* SET 3,(IX+d),D */
+        case 0xDB: OPLABEL(0xDB) /* SET 3,(IX+d),E */
+        case 0xDC: OPLABEL(0xDC) /* SET 3,(IX+d),H */
+        case 0xDD: OPLABEL(0xDD) /* SET 3,(IX+d),L */
+        case 0xDE: OPLABEL(0xDE) /* SET 3,(IX+d)   */
+        case 0xDF: OPLABEL(0xDF) /* SET 3,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x08;
             Z80Ops::addressOnBus(address, 1);
@@ -4908,14 +5521,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xE0: /* SET 4,(IX+d),B */
-        case 0xE1: /* SET 4,(IX+d),C */
-        case 0xE2: /* SET 4,(IX+d),D */
-        case 0xE3: /* SET 4,(IX+d),E */
-        case 0xE4: /* SET 4,(IX+d),H */
-        case 0xE5: /* SET 4,(IX+d),L */
-        case 0xE6: /* SET 4,(IX+d)   */
-        case 0xE7: /* SET 4,(IX+d),A */
+        case 0xE0: OPLABEL(0xE0) /* SET 4,(IX+d),B */
+        case 0xE1: OPLABEL(0xE1) /* SET 4,(IX+d),C */
+        case 0xE2: OPLABEL(0xE2) /* SET 4,(IX+d),D */
+        case 0xE3: OPLABEL(0xE3) /* SET 4,(IX+d),E */
+        case 0xE4: OPLABEL(0xE4) /* SET 4,(IX+d),H */
+        case 0xE5: OPLABEL(0xE5) /* SET 4,(IX+d),L */
+        case 0xE6: OPLABEL(0xE6) /* SET 4,(IX+d)   */
+        case 0xE7: OPLABEL(0xE7) /* SET 4,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x10;
             Z80Ops::addressOnBus(address, 1);
@@ -4923,14 +5536,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xE8: /* SET 5,(IX+d),B */
-        case 0xE9: /* SET 5,(IX+d),C */
-        case 0xEA: /* SET 5,(IX+d),D */
-        case 0xEB: /* SET 5,(IX+d),E */
-        case 0xEC: /* SET 5,(IX+d),H */
-        case 0xED: /* SET 5,(IX+d),L */
-        case 0xEE: /* SET 5,(IX+d)   */
-        case 0xEF: /* SET 5,(IX+d),A */
+        case 0xE8: OPLABEL(0xE8) /* SET 5,(IX+d),B */
+        case 0xE9: OPLABEL(0xE9) /* SET 5,(IX+d),C */
+        case 0xEA: OPLABEL(0xEA) /* SET 5,(IX+d),D */
+        case 0xEB: OPLABEL(0xEB) /* SET 5,(IX+d),E */
+        case 0xEC: OPLABEL(0xEC) /* SET 5,(IX+d),H */
+        case 0xED: OPLABEL(0xED) /* SET 5,(IX+d),L */
+        case 0xEE: OPLABEL(0xEE) /* SET 5,(IX+d)   */
+        case 0xEF: OPLABEL(0xEF) /* SET 5,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x20;
             Z80Ops::addressOnBus(address, 1);
@@ -4938,14 +5551,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xF0: /* SET 6,(IX+d),B */
-        case 0xF1: /* SET 6,(IX+d),C */
-        case 0xF2: /* SET 6,(IX+d),D */
-        case 0xF3: /* SET 6,(IX+d),E */
-        case 0xF4: /* SET 6,(IX+d),H */
-        case 0xF5: /* SET 6,(IX+d),L */
-        case 0xF6: /* SET 6,(IX+d)   */
-        case 0xF7: /* SET 6,(IX+d),A */
+        case 0xF0: OPLABEL(0xF0) /* SET 6,(IX+d),B */
+        case 0xF1: OPLABEL(0xF1) /* SET 6,(IX+d),C */
+        case 0xF2: OPLABEL(0xF2) /* SET 6,(IX+d),D */
+        case 0xF3: OPLABEL(0xF3) /* SET 6,(IX+d),E */
+        case 0xF4: OPLABEL(0xF4) /* SET 6,(IX+d),H */
+        case 0xF5: OPLABEL(0xF5) /* SET 6,(IX+d),L */
+        case 0xF6: OPLABEL(0xF6) /* SET 6,(IX+d)   */
+        case 0xF7: OPLABEL(0xF7) /* SET 6,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x40;
             Z80Ops::addressOnBus(address, 1);
@@ -4953,14 +5566,14 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
             copyToRegister(opCode, work8);
             break;
         }
-        case 0xF8: /* SET 7,(IX+d),B */
-        case 0xF9: /* SET 7,(IX+d),C */
-        case 0xFA: /* SET 7,(IX+d),D */
-        case 0xFB: /* SET 7,(IX+d),E */
-        case 0xFC: /* SET 7,(IX+d),H */
-        case 0xFD: /* SET 7,(IX+d),L */
-        case 0xFE: /* SET 7,(IX+d)   */
-        case 0xFF: /* SET 7,(IX+d),A */
+        case 0xF8: OPLABEL(0xF8) /* SET 7,(IX+d),B */
+        case 0xF9: OPLABEL(0xF9) /* SET 7,(IX+d),C */
+        case 0xFA: OPLABEL(0xFA) /* SET 7,(IX+d),D */
+        case 0xFB: OPLABEL(0xFB) /* SET 7,(IX+d),E */
+        case 0xFC: OPLABEL(0xFC) /* SET 7,(IX+d),H */
+        case 0xFD: OPLABEL(0xFD) /* SET 7,(IX+d),L */
+        case 0xFE: OPLABEL(0xFE) /* SET 7,(IX+d)   */
+        case 0xFF: OPLABEL(0xFF) /* SET 7,(IX+d),A */
         {
             uint8_t work8 = Z80Ops::peek8(address) | 0x80;
             Z80Ops::addressOnBus(address, 1);
@@ -4974,9 +5587,47 @@ void Z80::decodeDDFDCB(uint8_t opCode, uint16_t address) {
 //Subconjunto de instrucciones 0xED
 
 void Z80::decodeED(uint8_t opCode) {
+#ifdef Z80_THREADED_DISPATCH
+    static const void* const dispatch[256] = {
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0x40, &&op_0x41, &&op_0x42, &&op_0x43, &&op_0x44, &&op_0x45, &&op_0x46, &&op_0x47,
+        &&op_0x48, &&op_0x49, &&op_0x4A, &&op_0x4B, &&op_0x4C, &&op_0x4D, &&op_0x4E, &&op_0x4F,
+        &&op_0x50, &&op_0x51, &&op_0x52, &&op_0x53, &&op_0x54, &&op_0x55, &&op_0x56, &&op_0x57,
+        &&op_0x58, &&op_0x59, &&op_0x5A, &&op_0x5B, &&op_0x5C, &&op_0x5D, &&op_0x5E, &&op_0x5F,
+        &&op_0x60, &&op_0x61, &&op_0x62, &&op_0x63, &&op_0x64, &&op_0x65, &&op_0x66, &&op_0x67,
+        &&op_0x68, &&op_0x69, &&op_0x6A, &&op_0x6B, &&op_0x6C, &&op_0x6D, &&op_0x6E, &&op_0x6F,
+        &&op_0x70, &&op_0x71, &&op_0x72, &&op_0x73, &&op_0x74, &&op_0x75, &&op_0x76, &&op_default,
+        &&op_0x78, &&op_0x79, &&op_0x7A, &&op_0x7B, &&op_0x7C, &&op_0x7D, &&op_0x7E, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xA0, &&op_0xA1, &&op_0xA2, &&op_0xA3, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xA8, &&op_0xA9, &&op_0xAA, &&op_0xAB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xB0, &&op_0xB1, &&op_0xB2, &&op_0xB3, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_0xB8, &&op_0xB9, &&op_0xBA, &&op_0xBB, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xDD, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xED, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_default,
+        &&op_default, &&op_default, &&op_default, &&op_default, &&op_default, &&op_0xFD, &&op_default, &&op_default
+    };
+    goto *dispatch[opCode];
+#endif
     switch (opCode) {
-        case 0x40:
+        case 0x40: OPLABEL(0x40)
         { /* IN B,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_B = Z80Ops::inPort(REG_WZ);
             REG_WZ++;
@@ -4984,20 +5635,20 @@ void Z80::decodeED(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x41:
+        case 0x41: OPLABEL(0x41)
         { /* OUT (C),B */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ, REG_B);
             REG_WZ++;
             break;
         }
-        case 0x42:
+        case 0x42: OPLABEL(0x42)
         { /* SBC HL,BC */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             sbc16(REG_BC);
             break;
         }
-        case 0x43:
+        case 0x43: OPLABEL(0x43)
         { /* LD (nn),BC */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ, regBC);
@@ -5005,43 +5656,44 @@ void Z80::decodeED(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x44:
-        case 0x4C:
-        case 0x54:
-        case 0x5C:
-        case 0x64:
-        case 0x6C:
-        case 0x74:
-        case 0x7C:
+        case 0x44: OPLABEL(0x44)
+        case 0x4C: OPLABEL(0x4C)
+        case 0x54: OPLABEL(0x54)
+        case 0x5C: OPLABEL(0x5C)
+        case 0x64: OPLABEL(0x64)
+        case 0x6C: OPLABEL(0x6C)
+        case 0x74: OPLABEL(0x74)
+        case 0x7C: OPLABEL(0x7C)
         { /* NEG */
+            syncFlags();
             uint8_t aux = regA;
             regA = 0;
             carryFlag = false;
             sbc(aux);
             break;
         }
-        case 0x45:
-        case 0x4D: /* RETI */
-        case 0x55:
-        case 0x5D:
-        case 0x65:
-        case 0x6D:
-        case 0x75:
-        case 0x7D:
+        case 0x45: OPLABEL(0x45)
+        case 0x4D: OPLABEL(0x4D) /* RETI */
+        case 0x55: OPLABEL(0x55)
+        case 0x5D: OPLABEL(0x5D)
+        case 0x65: OPLABEL(0x65)
+        case 0x6D: OPLABEL(0x6D)
+        case 0x75: OPLABEL(0x75)
+        case 0x7D: OPLABEL(0x7D)
         { /* RETN */
             ffIFF1 = ffIFF2;
             REG_PC = REG_WZ = pop();
             break;
         }
-        case 0x46:
-        case 0x4E:
-        case 0x66:
-        case 0x6E:
+        case 0x46: OPLABEL(0x46)
+        case 0x4E: OPLABEL(0x4E)
+        case 0x66: OPLABEL(0x66)
+        case 0x6E: OPLABEL(0x6E)
         { /* IM 0 */
             modeINT = IntMode::IM0;
             break;
         }
-        case 0x47:
+        case 0x47: OPLABEL(0x47)
         { /* LD I,A */
             /*
              * El par IR se pone en el bus de direcciones *antes*
@@ -5051,8 +5703,9 @@ void Z80::decodeED(uint8_t opCode) {
             regI = regA;
             break;
         }
-        case 0x48:
+        case 0x48: OPLABEL(0x48)
         { /* IN C,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_C = Z80Ops::inPort(REG_WZ);
             REG_WZ++;
@@ -5060,20 +5713,20 @@ void Z80::decodeED(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x49:
+        case 0x49: OPLABEL(0x49)
         { /* OUT (C),C */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ, REG_C);
             REG_WZ++;
             break;
         }
-        case 0x4A:
+        case 0x4A: OPLABEL(0x4A)
         { /* ADC HL,BC */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             adc16(REG_BC);
             break;
         }
-        case 0x4B:
+        case 0x4B: OPLABEL(0x4B)
         { /* LD BC,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             REG_BC = Z80Ops::peek16(REG_WZ);
@@ -5081,7 +5734,7 @@ void Z80::decodeED(uint8_t opCode) {
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x4F:
+        case 0x4F: OPLABEL(0x4F)
         { /* LD R,A */
             /*
              * El par IR se pone en el bus de direcciones *antes*
@@ -5091,8 +5744,9 @@ void Z80::decodeED(uint8_t opCode) {
             setRegR(regA);
             break;
         }
-        case 0x50:
+        case 0x50: OPLABEL(0x50)
         { /* IN D,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_D = Z80Ops::inPort(REG_WZ);
             REG_WZ++;
@@ -5100,115 +5754,120 @@ void Z80::decodeED(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x51:
+        case 0x51: OPLABEL(0x51)
         { /* OUT (C),D */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, REG_D);
             break;
         }
-        case 0x52:
+        case 0x52: OPLABEL(0x52)
         { /* SBC HL,DE */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             sbc16(REG_DE);
             break;
         }
-        case 0x53:
+        case 0x53: OPLABEL(0x53)
         { /* LD (nn),DE */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ++, regDE);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x56:
-        case 0x76:
+        case 0x56: OPLABEL(0x56)
+        case 0x76: OPLABEL(0x76)
         { /* IM 1 */
             modeINT = IntMode::IM1;
             break;
         }
-        case 0x57:
+        case 0x57: OPLABEL(0x57)
         { /* LD A,I */
+            syncFlags();
             Z80Ops::addressOnBus(getPairIR().word, 1);
             regA = regI;
             sz5h3pnFlags = sz53n_addTable[regA];
-            if (ffIFF2 && !Z80Ops::isActiveINT()) {
+            if (ffIFF2 && !activeINT) {
                 sz5h3pnFlags |= PARITY_MASK;
             }
             flagQ = true;
             break;
         }
-        case 0x58:
+        case 0x58: OPLABEL(0x58)
         { /* IN E,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_E = Z80Ops::inPort(REG_WZ++);
             sz5h3pnFlags = sz53pn_addTable[REG_E];
             flagQ = true;
             break;
         }
-        case 0x59:
+        case 0x59: OPLABEL(0x59)
         { /* OUT (C),E */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, REG_E);
             break;
         }
-        case 0x5A:
+        case 0x5A: OPLABEL(0x5A)
         { /* ADC HL,DE */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             adc16(REG_DE);
             break;
         }
-        case 0x5B:
+        case 0x5B: OPLABEL(0x5B)
         { /* LD DE,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             REG_DE = Z80Ops::peek16(REG_WZ++);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x5E:
-        case 0x7E:
+        case 0x5E: OPLABEL(0x5E)
+        case 0x7E: OPLABEL(0x7E)
         { /* IM 2 */
             modeINT = IntMode::IM2;
             break;
         }
-        case 0x5F:
+        case 0x5F: OPLABEL(0x5F)
         { /* LD A,R */
+            syncFlags();
             Z80Ops::addressOnBus(getPairIR().word, 1);
             regA = getRegR();
             sz5h3pnFlags = sz53n_addTable[regA];
-            if (ffIFF2 && !Z80Ops::isActiveINT()) {
+            if (ffIFF2 && !activeINT) {
                 sz5h3pnFlags |= PARITY_MASK;
             }
             flagQ = true;
             break;
         }
-        case 0x60:
+        case 0x60: OPLABEL(0x60)
         { /* IN H,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_H = Z80Ops::inPort(REG_WZ++);
             sz5h3pnFlags = sz53pn_addTable[REG_H];
             flagQ = true;
             break;
         }
-        case 0x61:
+        case 0x61: OPLABEL(0x61)
         { /* OUT (C),H */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, REG_H);
             break;
         }
-        case 0x62:
+        case 0x62: OPLABEL(0x62)
         { /* SBC HL,HL */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             sbc16(REG_HL);
             break;
         }
-        case 0x63:
+        case 0x63: OPLABEL(0x63)
         { /* LD (nn),HL */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ++, regHL);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x67:
+        case 0x67: OPLABEL(0x67)
         { /* RRD */
+            syncFlags();
             // A = A7 A6 A5 A4 (HL)3 (HL)2 (HL)1 (HL)0
             // (HL) = A3 A2 A1 A0 (HL)7 (HL)6 (HL)5 (HL)4
             // Los bits 3,2,1 y 0 de (HL) se copian a los bits 3,2,1 y 0 de A.
@@ -5225,35 +5884,37 @@ void Z80::decodeED(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x68:
+        case 0x68: OPLABEL(0x68)
         { /* IN L,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             REG_L = Z80Ops::inPort(REG_WZ++);
             sz5h3pnFlags = sz53pn_addTable[REG_L];
             flagQ = true;
             break;
         }
-        case 0x69:
+        case 0x69: OPLABEL(0x69)
         { /* OUT (C),L */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, REG_L);
             break;
         }
-        case 0x6A:
+        case 0x6A: OPLABEL(0x6A)
         { /* ADC HL,HL */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             adc16(REG_HL);
             break;
         }
-        case 0x6B:
+        case 0x6B: OPLABEL(0x6B)
         { /* LD HL,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             REG_HL = Z80Ops::peek16(REG_WZ++);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x6F:
+        case 0x6F: OPLABEL(0x6F)
         { /* RLD */
+            syncFlags();
             // A = A7 A6 A5 A4 (HL)7 (HL)6 (HL)5 (HL)4
             // (HL) = (HL)3 (HL)2 (HL)1 (HL)0 A3 A2 A1 A0
             // Los 4 bits bajos que había en (HL) se copian a los bits altos de (HL).
@@ -5270,188 +5931,212 @@ void Z80::decodeED(uint8_t opCode) {
             flagQ = true;
             break;
         }
-        case 0x70:
+        case 0x70: OPLABEL(0x70)
         { /* IN (C) */
+            syncFlags();
             REG_WZ = REG_BC;
             uint8_t inPort = Z80Ops::inPort(REG_WZ++);
             sz5h3pnFlags = sz53pn_addTable[inPort];
             flagQ = true;
             break;
         }
-        case 0x71:
+        case 0x71: OPLABEL(0x71)
         { /* OUT (C),0 */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, 0x00);
             break;
         }
-        case 0x72:
+        case 0x72: OPLABEL(0x72)
         { /* SBC HL,SP */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             sbc16(REG_SP);
             break;
         }
-        case 0x73:
+        case 0x73: OPLABEL(0x73)
         { /* LD (nn),SP */
             REG_WZ = Z80Ops::peek16(REG_PC);
             Z80Ops::poke16(REG_WZ++, regSP);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0x78:
+        case 0x78: OPLABEL(0x78)
         { /* IN A,(C) */
+            syncFlags();
             REG_WZ = REG_BC;
             regA = Z80Ops::inPort(REG_WZ++);
             sz5h3pnFlags = sz53pn_addTable[regA];
             flagQ = true;
             break;
         }
-        case 0x79:
+        case 0x79: OPLABEL(0x79)
         { /* OUT (C),A */
             REG_WZ = REG_BC;
             Z80Ops::outPort(REG_WZ++, regA);
             break;
         }
-        case 0x7A:
+        case 0x7A: OPLABEL(0x7A)
         { /* ADC HL,SP */
             Z80Ops::addressOnBus(getPairIR().word, 7);
             adc16(REG_SP);
             break;
         }
-        case 0x7B:
+        case 0x7B: OPLABEL(0x7B)
         { /* LD SP,(nn) */
             REG_WZ = Z80Ops::peek16(REG_PC);
             REG_SP = Z80Ops::peek16(REG_WZ++);
             REG_PC = REG_PC + 2;
             break;
         }
-        case 0xA0:
+        case 0xA0: OPLABEL(0xA0)
         { /* LDI */
             ldi();
             break;
         }
-        case 0xA1:
+        case 0xA1: OPLABEL(0xA1)
         { /* CPI */
             cpi();
             break;
         }
-        case 0xA2:
+        case 0xA2: OPLABEL(0xA2)
         { /* INI */
             ini();
             break;
         }
-        case 0xA3:
+        case 0xA3: OPLABEL(0xA3)
         { /* OUTI */
             outi();
             break;
         }
-        case 0xA8:
+        case 0xA8: OPLABEL(0xA8)
         { /* LDD */
             ldd();
             break;
         }
-        case 0xA9:
+        case 0xA9: OPLABEL(0xA9)
         { /* CPD */
             cpd();
             break;
         }
-        case 0xAA:
+        case 0xAA: OPLABEL(0xAA)
         { /* IND */
             ind();
             break;
         }
-        case 0xAB:
+        case 0xAB: OPLABEL(0xAB)
         { /* OUTD */
             outd();
             break;
         }
-        case 0xB0:
+        case 0xB0: OPLABEL(0xB0)
         { /* LDIR */
             ldi();
-            if (REG_BC != 0) {
+            while (REG_BC != 0) {
                 REG_PC = REG_PC - 2;
                 REG_WZ = REG_PC + 1;
                 Z80Ops::addressOnBus(REG_DE - 1, 5);
+                if (!repeatBlock(0xB0))
+                    break;
+                ldi();
             }
             break;
         }
-        case 0xB1:
+        case 0xB1: OPLABEL(0xB1)
         { /* CPIR */
             cpi();
-            if ((sz5h3pnFlags & PARITY_MASK) == PARITY_MASK
-                    && (sz5h3pnFlags & ZERO_MASK) == 0) {
+            while (isParOverFlag() && !isZeroFlag()) {
                 REG_PC = REG_PC - 2;
                 REG_WZ = REG_PC + 1;
                 Z80Ops::addressOnBus(REG_HL - 1, 5);
+                if (!repeatBlock(0xB1))
+                    break;
+                cpi();
             }
             break;
         }
-        case 0xB2:
+        case 0xB2: OPLABEL(0xB2)
         { /* INIR */
             ini();
-            if (REG_B != 0) {
+            while (REG_B != 0) {
                 REG_PC = REG_PC - 2;
                 Z80Ops::addressOnBus(REG_HL - 1, 5);
+                if (!repeatBlock(0xB2))
+                    break;
+                ini();
             }
             break;
         }
-        case 0xB3:
+        case 0xB3: OPLABEL(0xB3)
         { /* OTIR */
             outi();
-            if (REG_B != 0) {
+            while (REG_B != 0) {
                 REG_PC = REG_PC - 2;
                 Z80Ops::addressOnBus(REG_BC, 5);
+                if (!repeatBlock(0xB3))
+                    break;
+                outi();
             }
             break;
         }
-        case 0xB8:
+        case 0xB8: OPLABEL(0xB8)
         { /* LDDR */
             ldd();
-            if (REG_BC != 0) {
+            while (REG_BC != 0) {
                 REG_PC = REG_PC - 2;
                 REG_WZ = REG_PC + 1;
                 Z80Ops::addressOnBus(REG_DE + 1, 5);
+                if (!repeatBlock(0xB8))
+                    break;
+                ldd();
             }
             break;
         }
-        case 0xB9:
+        case 0xB9: OPLABEL(0xB9)
         { /* CPDR */
             cpd();
-            if ((sz5h3pnFlags & PARITY_MASK) == PARITY_MASK
-                    && (sz5h3pnFlags & ZERO_MASK) == 0) {
+            while (isParOverFlag() && !isZeroFlag()) {
                 REG_PC = REG_PC - 2;
                 REG_WZ = REG_PC + 1;
                 Z80Ops::addressOnBus(REG_HL + 1, 5);
+                if (!repeatBlock(0xB9))
+                    break;
+                cpd();
             }
             break;
         }
-        case 0xBA:
+        case 0xBA: OPLABEL(0xBA)
         { /* INDR */
             ind();
-            if (REG_B != 0) {
+            while (REG_B != 0) {
                 REG_PC = REG_PC - 2;
                 Z80Ops::addressOnBus(REG_HL + 1, 5);
+                if (!repeatBlock(0xBA))
+                    break;
+                ind();
             }
             break;
         }
-        case 0xBB:
+        case 0xBB: OPLABEL(0xBB)
         { /* OTDR */
             outd();
-            if (REG_B != 0) {
+            while (REG_B != 0) {
                 REG_PC = REG_PC - 2;
                 Z80Ops::addressOnBus(REG_BC, 5);
+                if (!repeatBlock(0xBB))
+                    break;
+                outd();
             }
             break;
         }
-        case 0xDD:
+        case 0xDD: OPLABEL(0xDD)
             prefixOpcode = 0xDD;
             break;
-        case 0xED:
+        case 0xED: OPLABEL(0xED)
             prefixOpcode = 0xED;
             break;
-        case 0xFD:
+        case 0xFD: OPLABEL(0xFD)
             prefixOpcode = 0xFD;
             break;
-        default:
+        default: OPLABEL(default)
         {
             break;
         }
@@ -5486,3 +6171,547 @@ void Z80::copyToRegister(uint8_t opCode, uint8_t value)
             break;
     }
 }
+
+
+#if defined(Z80_BLOCK_CACHE) && !defined(Z80_CORE_VARIANT)
+
+#ifdef Z80_PROFILER
+#error "Z80_PROFILER needs every instruction to go through execute(), undefine Z80_BLOCK_CACHE"
+#endif
+
+/* Caché de bloques
+ *
+ * Un bloque básico empieza en cualquier PC y acaba en el primer salto,
+ * CALL, RET o RST, o antes de la primera instrucción que no se traduce
+ * (E/S, prefijos DD/ED/FD, HALT, EI), o a los BLOCK_MAX_OPS instrucciones
+ * o BLOCK_MAX_BYTES bytes. Cada instrucción hace exactamente las mismas
+ * llamadas a Z80Ops que en el intérprete, salvo la lectura del código de
+ * operación y de los operandos inmediatos, que ya vienen en el BlockOp:
+ * sus T-estados (tstates) se suman con Z80Ops::addTstates, acumulados
+ * hasta la siguiente instrucción que pasa por Z80Ops (BLOCK_BUS) o hasta
+ * la salida del bloque. Como el código solo se traduce donde no hay
+ * contención (Z80Ops::isCacheable), el reloj queda igual que con el
+ * intérprete en cada acceso al bus y al final de cada instrucción.
+ *
+ * Las escrituras en memoria invalidan por páginas de 256 bytes las
+ * traducciones que la tocan (Z80::codeWritten). Si una instrucción del
+ * bloque modifica código traducido, el bloque acaba tras ella.
+ */
+#define BLOCK_MAX_OPS     64
+#define BLOCK_MAX_BYTES   256
+// Páginas que mezclan código y datos: tras tantas invalidaciones se dejan
+// al intérprete hasta el siguiente flushBlocks
+#define BLOCK_MAX_INVALIDATIONS 8
+
+void Z80::setBlockCache(bool state) {
+    if (state && blockPool == NULL) {
+        blockPool = (BlockOp*) malloc(BLOCK_POOL_SIZE * sizeof(BlockOp));
+        blockIndex = (BlockEntry*) malloc(BLOCK_CACHE_LIMIT * sizeof(BlockEntry));
+        if (blockPool == NULL || blockIndex == NULL) {
+            free(blockPool);
+            free(blockIndex);
+            blockPool = NULL;
+            blockIndex = NULL;
+            return;
+        }
+    }
+    if (state)
+        flushBlocks();
+    blockCacheEnabled = state;
+}
+
+void Z80::flushBlocks(void) {
+    if (blockIndex == NULL)
+        return;
+    memset(blockIndex, 0xff, BLOCK_CACHE_LIMIT * sizeof(BlockEntry)); // BLOCK_UNKNOWN
+    memset(blockCodePage, 0, sizeof(blockCodePage));
+    memset(blockPageInvalidations, 0, sizeof(blockPageInvalidations));
+    blockPoolUsed = 0;
+    blockGeneration++;
+}
+
+// Un bloque que toca la página puede empezar en ella o en la anterior
+// (BLOCK_MAX_BYTES == 256). Los BlockOp se quedan en blockPool hasta el
+// siguiente flushBlocks, así que el bloque en curso sigue siendo válido.
+void Z80::invalidateBlocks(uint8_t page) {
+    blockCodePage[page] = 0;
+    if (blockPageInvalidations[page] < BLOCK_MAX_INVALIDATIONS)
+        blockPageInvalidations[page]++;
+    uint32_t from = page ? (page - 1) << 8 : 0;
+    for (uint32_t address = from; address < (page + 1u) << 8 && address < BLOCK_CACHE_LIMIT; address++)
+        blockIndex[address] = BLOCK_UNKNOWN;
+    blockGeneration++;
+}
+
+// Ejecuta el bloque que empieza en PC, si lo hay. Vuelve al acabar el
+// bloque, al llegar a 'deadline' o si el bloque se ha modificado.
+bool Z80::runBlock(uint32_t deadline) {
+    int32_t entry = blockIndex[REG_PC];
+    if (entry == BLOCK_UNKNOWN)
+        entry = translateBlock(REG_PC);
+    if (entry < 0)
+        return false;
+
+    const BlockOp* op = &blockPool[entry];
+    uint32_t generation = blockGeneration;
+    uint32_t now = Z80Ops::getTstates();
+    int32_t pending = 0;
+
+    pendingEI = false;
+    for (;;) {
+        regR++;
+        flagQ = false;
+        REG_PC = op->next;
+        if (op->flags & BLOCK_BUS) {
+            Z80Ops::addTstates(pending + op->tstates, true);
+            pending = 0;
+            op->run(*op);
+            now = Z80Ops::getTstates();
+        } else {
+            pending += op->tstates;
+            now += op->tstates;
+            op->run(*op);
+        }
+        lastFlagQ = flagQ;
+
+        if ((op->flags & BLOCK_LAST) || now >= deadline || generation != blockGeneration)
+            break;
+        op++;
+    }
+
+    if (pending)
+        Z80Ops::addTstates(pending, true);
+
+    return true;
+}
+
+int32_t Z80::translateBlock(uint16_t address) {
+    if (blockPoolUsed + BLOCK_MAX_OPS > BLOCK_POOL_SIZE)
+        flushBlocks();
+
+    uint32_t first = blockPoolUsed;
+    uint32_t pc = address;
+    while (blockPoolUsed - first < BLOCK_MAX_OPS) {
+        BlockOp& op = blockPool[blockPoolUsed];
+        uint8_t length = translateOp(pc, op);
+        if (length == 0 || pc + length > 0x10000 || pc + length - address > BLOCK_MAX_BYTES)
+            break;
+
+        for (uint32_t byte = pc; byte < pc + length; byte++) {
+            if (!Z80Ops::isCacheable(byte)
+#ifdef ROM_HLE
+                // las rutinas de la ROM las hace Z80Ops::romRoutine
+                || (byte < 0x4000 && romHookPage[byte >> 8])
+#endif
+                || blockPageInvalidations[byte >> 8] >= BLOCK_MAX_INVALIDATIONS) {
+                length = 0;
+                break;
+            }
+        }
+        if (length == 0)
+            break;
+
+        blockPoolUsed++;
+        for (uint32_t page = pc >> 8; page <= (pc + length - 1) >> 8; page++)
+            blockCodePage[page] = 1;
+        pc += length;
+        if (op.flags & BLOCK_LAST)
+            break;
+    }
+
+    // Sin nada que traducir no se vuelve a intentar hasta el siguiente
+    // flushBlocks (la página no se marca: suele ser memoria con contención)
+    if (blockPoolUsed == first)
+        return blockIndex[address] = BLOCK_NEVER;
+
+    blockPool[blockPoolUsed - 1].flags |= BLOCK_LAST;
+    return blockIndex[address] = first;
+}
+
+// Traduce la instrucción en 'address'. Devuelve su longitud en bytes, o 0
+// si no se traduce.
+uint8_t Z80::translateOp(uint16_t address, BlockOp& op) {
+    // No son static: con MACHINE_PER_THREAD cada hilo tiene sus registros
+    uint8_t* const reg8[8] = {
+        &REG_B, &REG_C, &REG_D, &REG_E, &REG_H, &REG_L, NULL, &regA
+    };
+    RegisterPair* const reg16[4] = { &regBC, &regDE, &regHL, &regSP };
+    RegisterPair* const reg16AF[4] = { &regBC, &regDE, &regHL, NULL };
+
+#define BLOCK_ROW(kind) \
+    &blockRun<kind, 0>, &blockRun<kind, 1>, &blockRun<kind, 2>, &blockRun<kind, 3>, \
+    &blockRun<kind, 4>, &blockRun<kind, 5>, &blockRun<kind, 6>, &blockRun<kind, 7>
+    static const BlockHandler aluR[8] = { BLOCK_ROW(BLOCK_ALU_R) };
+    static const BlockHandler aluN[8] = { BLOCK_ROW(BLOCK_ALU_N) };
+    static const BlockHandler aluHL[8] = { BLOCK_ROW(BLOCK_ALU_HL) };
+    static const BlockHandler jrCC[8] = { BLOCK_ROW(BLOCK_JR_CC) };
+    static const BlockHandler jpCC[8] = { BLOCK_ROW(BLOCK_JP_CC) };
+    static const BlockHandler callCC[8] = { BLOCK_ROW(BLOCK_CALL_CC) };
+    static const BlockHandler retCC[8] = { BLOCK_ROW(BLOCK_RET_CC) };
+#undef BLOCK_ROW
+
+    uint8_t opCode = Z80Ops::peekCode(address);
+    uint8_t n = Z80Ops::peekCode(address + 1);
+    uint16_t nn = n | (Z80Ops::peekCode(address + 2) << 8);
+    uint8_t length = 1;
+
+    op.reg = NULL;
+    op.src = NULL;
+    op.nn = 0;
+    op.tstates = 4;
+    op.flags = 0;
+    op.opCode = opCode;
+
+    switch (opCode) {
+        case 0x00: // NOP
+            op.run = &blockRun<BLOCK_NOP, 0>;
+            break;
+        case 0x01: case 0x11: case 0x21: case 0x31: // LD rr,nn
+            op.run = &blockRun<BLOCK_LD_RR_NN, 0>;
+            op.pair = reg16[opCode >> 4];
+            op.nn = nn;
+            op.tstates = 10;
+            length = 3;
+            break;
+        case 0x03: case 0x13: case 0x23: case 0x33: // INC rr
+            op.run = &blockRun<BLOCK_INC_RR, 0>;
+            op.pair = reg16[opCode >> 4];
+            op.flags = BLOCK_BUS;
+            break;
+        case 0x0B: case 0x1B: case 0x2B: case 0x3B: // DEC rr
+            op.run = &blockRun<BLOCK_DEC_RR, 0>;
+            op.pair = reg16[opCode >> 4];
+            op.flags = BLOCK_BUS;
+            break;
+        case 0x09: case 0x19: case 0x29: case 0x39: // ADD HL,rr
+            op.run = &blockRun<BLOCK_ADD_HL_RR, 0>;
+            op.pair = reg16[opCode >> 4];
+            op.flags = BLOCK_BUS;
+            break;
+        case 0x04: case 0x0C: case 0x14: case 0x1C: case 0x24: case 0x2C: case 0x3C: // INC r
+            op.run = &blockRun<BLOCK_INC_R, 0>;
+            op.reg = reg8[opCode >> 3];
+            break;
+        case 0x05: case 0x0D: case 0x15: case 0x1D: case 0x25: case 0x2D: case 0x3D: // DEC r
+            op.run = &blockRun<BLOCK_DEC_R, 0>;
+            op.reg = reg8[opCode >> 3];
+            break;
+        case 0x06: case 0x0E: case 0x16: case 0x1E: case 0x26: case 0x2E: case 0x3E: // LD r,n
+            op.run = &blockRun<BLOCK_LD_R_N, 0>;
+            op.reg = reg8[opCode >> 3];
+            op.nn = n;
+            op.tstates = 7;
+            length = 2;
+            break;
+        case 0x10: // DJNZ e (lee e después del ciclo extra de M1)
+            op.run = &blockRun<BLOCK_DJNZ, 0>;
+            op.nn = address + 2 + (int8_t) n;
+            op.flags = BLOCK_BUS | BLOCK_LAST;
+            length = 2;
+            break;
+        case 0x18: // JR e
+            op.run = &blockRun<BLOCK_JR, 0>;
+            op.nn = address + 2 + (int8_t) n;
+            op.tstates = 7;
+            op.flags = BLOCK_BUS | BLOCK_LAST;
+            length = 2;
+            break;
+        case 0x20: case 0x28: case 0x30: case 0x38: // JR cc,e
+            op.run = jrCC[(opCode >> 3) & 0x03];
+            op.nn = address + 2 + (int8_t) n;
+            op.tstates = 7;
+            op.flags = BLOCK_BUS | BLOCK_LAST;
+            length = 2;
+            break;
+        // Sin operandos y sin pasar por Z80Ops: RLCA, EX AF,AF', RRCA, RLA,
+        // RRA, DAA, CPL, SCF, CCF, EXX, EX DE,HL, DI
+        case 0x07: case 0x08: case 0x0F: case 0x17: case 0x1F: case 0x27:
+        case 0x2F: case 0x37: case 0x3F: case 0xD9: case 0xEB: case 0xF3:
+            op.run = &blockRun<BLOCK_GENERIC, 0>;
+            break;
+        case 0xE9: // JP (HL)
+            op.run = &blockRun<BLOCK_GENERIC, 0>;
+            op.flags = BLOCK_LAST;
+            break;
+        // El resto lo decodifica el intérprete tras el M1, leyendo él mismo
+        // los operandos: LD (BC)/(DE),A, LD A,(BC)/(DE), INC/DEC/LD (HL),
+        // LD (nn)/HL/A, EX (SP),HL, LD SP,HL y todo el grupo CB
+        case 0x02: case 0x0A: case 0x12: case 0x1A: case 0x34: case 0x35:
+        case 0xE3: case 0xF9: case 0xCB:
+            op.run = &blockRun<BLOCK_GENERIC, 0>;
+            op.flags = BLOCK_BUS;
+            length = (opCode == 0xCB) ? 2 : 1;
+            break;
+        case 0x36:
+            op.run = &blockRun<BLOCK_GENERIC, 0>;
+            op.flags = BLOCK_BUS;
+            length = 2;
+            break;
+        case 0x22: case 0x2A: case 0x32: case 0x3A:
+            op.run = &blockRun<BLOCK_GENERIC, 0>;
+            op.flags = BLOCK_BUS;
+            length = 3;
+            break;
+        case 0xC3: // JP nn
+            op.run = &blockRun<BLOCK_JP, 0>;
+            op.nn = nn;
+            op.tstates = 10;
+            op.flags = BLOCK_LAST;
+            length = 3;
+            break;
+        case 0xCD: // CALL nn
+            op.run = &blockRun<BLOCK_CALL, 0>;
+            op.nn = nn;
+            op.tstates = 10;
+            op.flags = BLOCK_BUS | BLOCK_LAST;
+            length = 3;
+            break;
+        case 0xC9: // RET
+            op.run = &blockRun<BLOCK_RET, 0>;
+            op.flags = BLOCK_BUS | BLOCK_LAST;
+            break;
+        case 0xC1: case 0xD1: case 0xE1: // POP rr
+            op.run = &blockRun<BLOCK_POP, 0>;
+            op.pair = reg16AF[(opCode >> 4) & 0x03];
+            op.flags = BLOCK_BUS;
+            break;
+        case 0xF1: // POP AF
+            op.run = &blockRun<BLOCK_POP_AF, 0>;
+            op.flags = BLOCK_BUS;
+            break;
+        case 0xC5: case 0xD5: case 0xE5: // PUSH rr
+            op.run = &blockRun<BLOCK_PUSH, 0>;
+            op.pair = reg16AF[(opCode >> 4) & 0x03];
+            op.flags = BLOCK_BUS;
+            break;
+        case 0xF5: // PUSH AF
+            op.run = &blockRun<BLOCK_PUSH_AF, 0>;
+            op.flags = BLOCK_BUS;
+            break;
+        // HALT, E/S, prefijos DD/ED/FD y EI se quedan en el intérprete
+        case 0x76: case 0xD3: case 0xDB: case 0xDD: case 0xED: case 0xFB: case 0xFD:
+            return 0;
+        default:
+            if (opCode >= 0x40 && opCode < 0x80) {
+                // LD r,r' / LD r,(HL) / LD (HL),r
+                uint8_t dst = (opCode >> 3) & 0x07;
+                uint8_t src = opCode & 0x07;
+                if (src == 6) {
+                    op.run = &blockRun<BLOCK_LD_R_HL, 0>;
+                    op.reg = reg8[dst];
+                    op.flags = BLOCK_BUS;
+                } else if (dst == 6) {
+                    op.run = &blockRun<BLOCK_LD_HL_R, 0>;
+                    op.src = reg8[src];
+                    op.flags = BLOCK_BUS;
+                } else {
+                    op.run = &blockRun<BLOCK_LD_R_R, 0>;
+                    op.reg = reg8[dst];
+                    op.src = reg8[src];
+                }
+            } else if (opCode >= 0x80 && opCode < 0xC0) {
+                // ADD/ADC/SUB/SBC/AND/XOR/OR/CP r / (HL)
+                uint8_t src = opCode & 0x07;
+                if (src == 6) {
+                    op.run = aluHL[(opCode >> 3) & 0x07];
+                    op.flags = BLOCK_BUS;
+                } else {
+                    op.run = aluR[(opCode >> 3) & 0x07];
+                    op.src = reg8[src];
+                }
+            } else {
+                switch (opCode & 0x07) {
+                    case 0x00: // RET cc
+                        op.run = retCC[(opCode >> 3) & 0x07];
+                        op.flags = BLOCK_BUS | BLOCK_LAST;
+                        break;
+                    case 0x02: // JP cc,nn
+                        op.run = jpCC[(opCode >> 3) & 0x07];
+                        op.nn = nn;
+                        op.tstates = 10;
+                        op.flags = BLOCK_LAST;
+                        length = 3;
+                        break;
+                    case 0x04: // CALL cc,nn
+                        op.run = callCC[(opCode >> 3) & 0x07];
+                        op.nn = nn;
+                        op.tstates = 10;
+                        op.flags = BLOCK_BUS | BLOCK_LAST;
+                        length = 3;
+                        break;
+                    case 0x06: // ADD/ADC/SUB/SBC/AND/XOR/OR/CP n
+                        op.run = aluN[(opCode >> 3) & 0x07];
+                        op.nn = n;
+                        op.tstates = 7;
+                        length = 2;
+                        break;
+                    case 0x07: // RST
+                        op.run = &blockRun<BLOCK_RST, 0>;
+                        op.nn = opCode & 0x38;
+                        op.flags = BLOCK_BUS | BLOCK_LAST;
+                        break;
+                    default:
+                        return 0;
+                }
+            }
+            break;
+    }
+
+    // Los genéricos leen sus operandos, PC va justo detrás del código
+    op.next = (op.run == &blockRun<BLOCK_GENERIC, 0>) ? address + 1 : address + length;
+    return length;
+}
+
+template <int CC>
+inline bool Z80::blockCondition(void) {
+    switch (CC) {
+        case 0: return !isZeroFlag();
+        case 1: return isZeroFlag();
+        case 2: return !isCarryFlag();
+        case 3: return isCarryFlag();
+        case 4: return !isParOverFlag();
+        case 5: return isParOverFlag();
+        case 6: return !isSignFlag();
+        default: return isSignFlag();
+    }
+}
+
+template <int ALU>
+inline void Z80::blockAlu(uint8_t value) {
+    switch (ALU) {
+        case 0: add(value); break;
+        case 1: adc(value); break;
+        case 2: sub(value); break;
+        case 3: sbc(value); break;
+        case 4: and_(value); break;
+        case 5: xor_(value); break;
+        case 6: or_(value); break;
+        default: cp(value); break;
+    }
+}
+
+// Manejadores: KIND es el tipo de instrucción y SUB la operación ALU o la
+// condición, así que cada instancia se queda en unas pocas instrucciones.
+// PC ya apunta detrás de la instrucción (op.next) y los T-estados de M1 y
+// operandos ya están sumados si es BLOCK_BUS.
+template <int KIND, int SUB>
+void Z80::blockRun(const BlockOp& op) {
+    switch (KIND) {
+        case BLOCK_NOP:
+            break;
+        case BLOCK_LD_R_R:
+            *op.reg = *op.src;
+            break;
+        case BLOCK_LD_R_N:
+            *op.reg = op.nn;
+            break;
+        case BLOCK_LD_RR_NN:
+            op.pair->word = op.nn;
+            break;
+        case BLOCK_LD_R_HL:
+            *op.reg = Z80Ops::peek8(REG_HL);
+            break;
+        case BLOCK_LD_HL_R:
+            Z80Ops::poke8(REG_HL, *op.src);
+            break;
+        case BLOCK_INC_R:
+            inc8(*op.reg);
+            break;
+        case BLOCK_DEC_R:
+            dec8(*op.reg);
+            break;
+        case BLOCK_INC_RR:
+            Z80Ops::addressOnBus(getPairIR().word, 2);
+            op.pair->word++;
+            break;
+        case BLOCK_DEC_RR:
+            Z80Ops::addressOnBus(getPairIR().word, 2);
+            op.pair->word--;
+            break;
+        case BLOCK_ADD_HL_RR:
+            Z80Ops::addressOnBus(getPairIR().word, 7);
+            add16(regHL, op.pair->word);
+            break;
+        case BLOCK_ALU_R:
+            blockAlu<SUB>(*op.src);
+            break;
+        case BLOCK_ALU_N:
+            blockAlu<SUB>(op.nn);
+            break;
+        case BLOCK_ALU_HL:
+            blockAlu<SUB>(Z80Ops::peek8(REG_HL));
+            break;
+        case BLOCK_JR:
+            Z80Ops::addressOnBus(op.next - 1, 5);
+            REG_PC = REG_WZ = op.nn;
+            break;
+        case BLOCK_JR_CC:
+            if (blockCondition<SUB>()) {
+                Z80Ops::addressOnBus(op.next - 1, 5);
+                REG_PC = REG_WZ = op.nn;
+            }
+            break;
+        case BLOCK_DJNZ:
+            Z80Ops::addressOnBus(getPairIR().word, 1);
+            Z80Ops::addTstates(3, true); // lectura de e
+            if (--REG_B != 0) {
+                Z80Ops::addressOnBus(op.next - 1, 5);
+                REG_PC = REG_WZ = op.nn;
+            }
+            break;
+        case BLOCK_JP:
+            REG_PC = REG_WZ = op.nn;
+            break;
+        case BLOCK_JP_CC:
+            REG_WZ = op.nn;
+            if (blockCondition<SUB>())
+                REG_PC = op.nn;
+            break;
+        case BLOCK_CALL:
+            REG_WZ = op.nn;
+            Z80Ops::addressOnBus(op.next - 1, 1);
+            push(op.next);
+            REG_PC = op.nn;
+            break;
+        case BLOCK_CALL_CC:
+            REG_WZ = op.nn;
+            if (blockCondition<SUB>()) {
+                Z80Ops::addressOnBus(op.next - 1, 1);
+                push(op.next);
+                REG_PC = op.nn;
+            }
+            break;
+        case BLOCK_RET:
+            REG_PC = REG_WZ = pop();
+            break;
+        case BLOCK_RET_CC:
+            Z80Ops::addressOnBus(getPairIR().word, 1);
+            if (blockCondition<SUB>())
+                REG_PC = REG_WZ = pop();
+            break;
+        case BLOCK_PUSH:
+            Z80Ops::addressOnBus(getPairIR().word, 1);
+            push(op.pair->word);
+            break;
+        case BLOCK_PUSH_AF:
+            Z80Ops::addressOnBus(getPairIR().word, 1);
+            push(getRegAF());
+            break;
+        case BLOCK_POP:
+            op.pair->word = pop();
+            break;
+        case BLOCK_POP_AF:
+            setRegAF(pop());
+            break;
+        case BLOCK_RST:
+            Z80Ops::addressOnBus(getPairIR().word, 1);
+            push(REG_PC);
+            REG_PC = REG_WZ = op.nn;
+            break;
+        case BLOCK_GENERIC:
+            decodeOpcode(op.opCode);
+            break;
+    }
+}
+
+#endif // Z80_BLOCK_CACHE
@@ -0,0 +1,226 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// machinetest - several Machines in one process, one per thread
+//
+//   machinetest <data/rom directory> [threads] [frames]
+//
+// Each thread boots a 48K or a 128K machine (alternately) from the ROMs in
+// data/rom, types "10 FOR I=1 TO 1E9: PRINT AT 0,0;I: NEXT I" and RUN,
+// and hashes its RAM and registers after the given frames (default 3000).
+// Every thread must end with the hash the same machine gets when run
+// alone first, on the main thread; any state shared between threads
+// shows up as a mismatch. Also reports emulated MHz, alone and together.
+//
+// Build from this directory:
+//
+//   g++ -O2 -Wall -Wextra -pthread -DMACHINE_PER_THREAD -I../../include
+//       -o machinetest machinetest.cpp
+//       ../../src/Machine.cpp ../../src/Mem.cpp ../../src/Z80_JLS.cpp
+//
+// (one command line)
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Machine.h"
+#include "Mem.h"
+#include "Z80_JLS/z80.h"
+
+#ifndef MACHINE_PER_THREAD
+#error "build with -DMACHINE_PER_THREAD"
+#endif
+
+// frames a key is held down, then released
+#define KEY_FRAMES 4
+
+// Keystrokes: '^' SYMBOL SHIFT and '~' CAPS SHIFT with the next key, '\n'
+// ENTER, '.' nothing for a key's time. On 48K keywords are single keys;
+// on 128K, DOWN (CAPS SHIFT 6) and ENTER pick 128 BASIC from the menu
+static const char* keys48 = "10FI^L1^F1E9^ZP^I0^N0^OI^ZNI\nR\n";
+static const char* keys128 = "~6\n..........10 FOR I^L1 TO 1E9^Z PRINT AT 0^N0^OI^Z NEXT I\n..........RUN\n";
+
+// keyboard half rows, bit 0 first ('\001' CAPS SHIFT, '\002' SYMBOL SHIFT)
+static const char* keyRowChars[8] = {
+    "\001ZXCV", "ASDFG", "QWERT", "12345", "09876", "POIUY", "\nLKJH", " \002MNB"
+};
+
+static uint8_t rom48[0x4000];
+static uint8_t rom128[2][0x4000];
+
+struct Run {
+    bool is128K;
+    uint32_t frames;
+    uint32_t hash;
+    uint64_t tstates;
+    double seconds;
+};
+
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool loadRom(const std::string& path, uint8_t* page) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == NULL) {
+        perror(path.c_str());
+        return false;
+    }
+    size_t len = fread(page, 1, 0x4000, f);
+    fclose(f);
+    if (len != 0x4000) {
+        fprintf(stderr, "%s: not a 16K ROM\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+static void pressKey(uint8_t rows[8], char key) {
+    for (int row = 0; row < 8; row++) {
+        const char* bit = strchr(keyRowChars[row], key);
+        if (bit != NULL && key != 0)
+            rows[row] |= 1 << (bit - keyRowChars[row]);
+    }
+}
+
+static uint32_t fnv(uint32_t hash, uint32_t value) {
+    return (hash ^ value) * 16777619u;
+}
+
+// everything runs on the calling thread's machine
+static void runMachine(Run& run) {
+    std::vector<uint8_t> memory(8 * 0x4000);
+    uint8_t* ram[8];
+    for (int bank = 0; bank < 8; bank++)
+        ram[bank] = &memory[bank * 0x4000];
+    uint8_t* rom[4] = { run.is128K ? rom128[0] : rom48, rom128[1], rom128[1], rom128[1] };
+
+    Machine::attachMemory(rom, ram, run.is128K);
+    Machine::reset();
+
+    // typing starts once the ROM has cleared RAM and shown its message
+    const uint32_t typeFrom = run.is128K ? 250 : 150;
+    const char* key = run.is128K ? keys128 : keys48;
+    run.tstates = 0;
+    double start = now();
+    for (uint32_t frame = 0; frame < run.frames; frame++) {
+        if (frame >= typeFrom && *key) {
+            uint32_t phase = (frame - typeFrom) % (2 * KEY_FRAMES);
+            bool shift = key[0] == '^' || key[0] == '~';
+            uint8_t rows[8] = { 0 };
+            if (phase < KEY_FRAMES) {
+                if (shift) pressKey(rows, key[0] == '^' ? '\002' : '\001');
+                pressKey(rows, key[shift ? 1 : 0] == '.' ? 0 : key[shift ? 1 : 0]);
+            } else if (phase == 2 * KEY_FRAMES - 1) {
+                key += shift ? 2 : 1;
+            }
+            for (int row = 0; row < 8; row++)
+                Machine::setKeys(row, rows[row]);
+        }
+        run.tstates += Machine::runFrame();
+    }
+    run.seconds = now() - start;
+
+    uint32_t hash = 2166136261u;
+    for (size_t addr = 0; addr < memory.size(); addr++)
+        hash = fnv(hash, memory[addr]);
+    hash = fnv(hash, Z80::getRegAF()); hash = fnv(hash, Z80::getRegBC());
+    hash = fnv(hash, Z80::getRegDE()); hash = fnv(hash, Z80::getRegHL());
+    hash = fnv(hash, Z80::getRegIX()); hash = fnv(hash, Z80::getRegIY());
+    hash = fnv(hash, Z80::getRegSP()); hash = fnv(hash, Z80::getRegPC());
+    hash = fnv(hash, Z80::getRegR()); hash = fnv(hash, Mem::bankLatch);
+    run.hash = fnv(hash, (uint32_t) run.tstates);
+
+    // BASIC running line 10 with no error (PPC and ERR_NR in bank 5)
+    uint16_t ppc = ram[5][0x1c45] | (ram[5][0x1c46] << 8);
+    if (ppc != 10 || ram[5][0x1c3a] != 0xff)
+        run.hash = 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <data/rom directory> [threads] [frames]\n", argv[0]);
+        return 2;
+    }
+    std::string dir = argv[1];
+    unsigned threads = argc > 2 ? strtoul(argv[2], NULL, 10) : 4;
+    uint32_t frames = argc > 3 ? strtoul(argv[3], NULL, 10) : 3000;
+    if (!loadRom(dir + "/48K/SINCLAIR/0.rom", rom48)
+        || !loadRom(dir + "/128K/SINCLAIR/0.rom", rom128[0])
+        || !loadRom(dir + "/128K/SINCLAIR/1.rom", rom128[1]))
+        return 2;
+
+    // each machine alone on the main thread
+    Run alone[2] = { { false, frames, 0, 0, 0 }, { true, frames, 0, 0, 0 } };
+    double aloneSeconds = 0;
+    for (Run& run : alone) {
+        runMachine(run);
+        aloneSeconds += run.seconds;
+        printf("%s alone:    hash %08X, %.1f MHz emulated\n", run.is128K ? "128K" : " 48K",
+            run.hash, run.tstates / run.seconds / 1e6);
+    }
+
+    std::vector<Run> runs;
+    for (unsigned i = 0; i < threads; i++)
+        runs.push_back({ (i & 1) != 0, frames, 0, 0, 0 });
+    std::vector<std::thread> workers;
+    double start = now();
+    for (Run& run : runs)
+        workers.emplace_back(runMachine, std::ref(run));
+    for (std::thread& worker : workers)
+        worker.join();
+    double elapsed = now() - start;
+
+    int failed = 0;
+    uint64_t total = 0;
+    for (unsigned i = 0; i < threads; i++) {
+        const Run& ref = alone[runs[i].is128K];
+        bool ok = ref.hash != 0 && runs[i].hash == ref.hash;
+        failed += !ok;
+        total += runs[i].tstates;
+        printf("%s thread %u: hash %08X %s\n", runs[i].is128K ? "128K" : " 48K", i,
+            runs[i].hash, ok ? "ok" : "MISMATCH");
+    }
+    printf("%u machines on %u threads: %.1f MHz emulated in total (%.1f MHz one at a time)\n",
+        threads, threads, total / elapsed / 1e6,
+        (alone[0].tstates + alone[1].tstates) / aloneSeconds / 1e6);
+
+    return failed ? 1 : 0;
+}
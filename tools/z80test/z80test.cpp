@@ -0,0 +1,686 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// ZX-ESPectrum - ZX Spectrum emulator for ESP32
+//
+// Copyright (c) 2020, 2021 David Crespo [dcrespo3d]
+// https://github.com/dcrespo3d/ZX-ESPectrum-Wiimote
+//
+// Based on previous work by Ramón Martinez, Jorge Fuertes and many others
+// https://github.com/rampa069/ZX-ESPectrum
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+// 
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// z80test - host side conformance and throughput test for the JLS Z80 core
+//
+// Runs src/Z80_JLS.cpp on a PC with a flat 64K RAM Z80Ops, no contention:
+//
+//   z80test zex <zexdoc.com|zexall.com> [max Mtstates] [nocache|fast]
+//       CP/M .COM exerciser, BDOS functions 2 and 9 go to stdout.
+//       Reports pass/fail (no "ERROR" in output) and emulated MHz.
+//       Built with -DZ80_BLOCK_CACHE it runs on the block cache, unless
+//       "nocache" is given. Built with -DZ80_FAST_CORE (and
+//       ../../src/Z80_Fast.cpp), "fast" runs it on the fast core.
+//
+//   z80test fuse <tests.in> <tests.expected>
+//       FUSE core tests: registers, T-states and memory after every test,
+//       with the T-state mismatches listed per opcode.
+//
+//   z80test rom <48K .rom> [frames] [nocache|fast]
+//       Boots a 48K ROM (data/rom/48K/SINCLAIR/0.rom), 0000-3FFF read only,
+//       one interrupt every 69888 T-states, types a BASIC loop and runs it.
+//       Reports emulated MHz and a hash of RAM and registers, which must be
+//       the same for every core variant and block cache setting.
+//       Built with -DROM_PREDECODE the block cache covers only the ROM,
+//       as on the device.
+//
+//   z80test random [runs] [nocache|fast]
+//       Random RAM and registers, 200000 T-states per run with an
+//       interrupt every 10000. Prints a hash of every run's final state:
+//       compares core variants against each other (every opcode, prefixes
+//       and self-modifying code included), not against real hardware.
+//
+// Build from this directory (add -D flags from hardconfig.h to test them):
+//
+//   g++ -O2 -Wall -Wextra -I../../include -o z80test z80test.cpp ../../src/Z80_JLS.cpp
+//
+// and for the fast core:
+//
+//   g++ -O2 -Wall -Wextra -I../../include -DZ80_FAST_CORE -o z80test
+//       z80test.cpp ../../src/Z80_JLS.cpp ../../src/Z80_Fast.cpp
+//
+// (one command line)
+//
+// zexdoc/zexall and the FUSE test data are not part of this tree and have
+// not been run yet. Every core variant gives the same rom and random
+// hashes (rom 20000 frames: 9809D677, random 5000 runs: DD6E55DD) with
+// the default core, -DZ80_LAZY_FLAGS, -DZ80_THREADED_DISPATCH,
+// -DZ80_BLOCK_CACHE (with and without "nocache"), -DROM_PREDECODE and the
+// fast core ("fast"), and with all of them at once.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <map>
+#include <string>
+
+#include "hardconfig.h"
+#include "Z80_JLS/z80.h"
+#ifdef Z80_FAST_CORE
+#include "Z80_JLS/z80fast.h"
+#endif
+
+#define ZEX_FRAME_TSTATES 69888
+
+static uint8_t ram[0x10000];
+static uint32_t tstates;
+static bool cpmTraps;
+static bool cpmExit;
+// rom test: 0000-3FFF read only, keyboard on port FE
+static bool romMode;
+static uint8_t keyRows[8];
+// run on Z80Fast instead of Z80
+static bool fastCore;
+
+// zex output is echoed and also scanned for "ERROR"
+static int zexErrors;
+static const char* zexMatch = "ERROR";
+static int zexMatched;
+
+static int zexPutchar(int c) {
+    zexMatched = (c == zexMatch[zexMatched]) ? zexMatched + 1 : (c == zexMatch[0]);
+    if (zexMatch[zexMatched] == 0) {
+        zexErrors++;
+        zexMatched = 0;
+    }
+    return fputc(c, stdout);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Z80Ops for a flat RAM machine
+
+uint8_t Z80Ops::fetchOpcode(uint16_t address) {
+    tstates += 4;
+
+    // CP/M warm boot and BDOS entry, only used by the zex test
+    if (cpmTraps && address == 0x0000) {
+        cpmExit = true;
+        return 0x76; // HALT
+    }
+    if (cpmTraps && address == 0x0005) {
+        if (Z80::getRegC() == 2) {
+            zexPutchar(Z80::getRegE());
+        } else if (Z80::getRegC() == 9) {
+            for (uint16_t addr = Z80::getRegDE(); ram[addr] != '$'; addr++)
+                zexPutchar(ram[addr]);
+        }
+        fflush(stdout);
+    }
+
+    return ram[address];
+}
+
+uint8_t Z80Ops::peek8(uint16_t address) {
+    tstates += 3;
+    return ram[address];
+}
+
+void Z80Ops::poke8(uint16_t address, uint8_t value) {
+    tstates += 3;
+    if (romMode && address < 0x4000)
+        return;
+    ram[address] = value;
+#ifdef Z80_BLOCK_CACHE
+    Z80::codeWritten(address);
+#endif
+}
+
+uint16_t Z80Ops::peek16(uint16_t address) {
+    uint8_t lsb = peek8(address);
+    uint8_t msb = peek8(address + 1);
+    return (msb << 8) | lsb;
+}
+
+void Z80Ops::poke16(uint16_t address, RegisterPair word) {
+    poke8(address, word.byte8.lo);
+    poke8(address + 1, word.byte8.hi);
+}
+
+// FUSE tests expect the high byte of the port on reads
+uint8_t Z80Ops::inPort(uint16_t port) {
+    tstates += 4;
+    if (romMode) {
+        uint8_t data = 0xff;
+        if ((port & 0x01) == 0)
+            for (int row = 0; row < 8; row++)
+                if (!(port & (0x100 << row)))
+                    data &= ~keyRows[row];
+        return data;
+    }
+    return port >> 8;
+}
+
+void Z80Ops::outPort(uint16_t /*port*/, uint8_t /*value*/) {
+    tstates += 4;
+}
+
+void Z80Ops::addressOnBus(uint16_t /*address*/, int32_t wstates) {
+    tstates += wstates;
+}
+
+void Z80Ops::interruptHandlingTime(int32_t wstates) {
+    tstates += wstates;
+}
+
+uint32_t Z80Ops::getTstates(void) {
+    return tstates;
+}
+
+bool Z80Ops::isRepeatAllowed(void) {
+    return true;
+}
+
+void Z80Ops::addTstates(int32_t tstatestoadd, bool /*dovideo*/) {
+    tstates += tstatestoadd;
+}
+
+#ifdef Z80_BLOCK_CACHE
+// The CP/M traps need their fetchOpcode() calls
+bool Z80Ops::isCacheable(uint16_t address) {
+    return !(cpmTraps && address < 0x0008);
+}
+
+uint8_t Z80Ops::peekCode(uint16_t address) {
+    return ram[address];
+}
+#endif
+
+#ifdef ROM_HLE
+// No Spectrum ROM here: everything runs on the core
+bool Z80Ops::romRoutine(uint16_t /*address*/) {
+    return false;
+}
+#endif
+
+#ifdef INSTR_TRACE
+void Z80Ops::traceInstruction(uint16_t /*address*/) {
+}
+#endif
+
+#ifdef Z80_FAST_CORE
+// The fast core sees the same flat RAM: with no contention nor video its
+// timing is the same as the precise core's
+uint8_t Z80OpsFast::fetchOpcode(uint16_t address) { return Z80Ops::fetchOpcode(address); }
+uint8_t Z80OpsFast::peek8(uint16_t address) { return Z80Ops::peek8(address); }
+void Z80OpsFast::poke8(uint16_t address, uint8_t value) { Z80Ops::poke8(address, value); }
+uint16_t Z80OpsFast::peek16(uint16_t address) { return Z80Ops::peek16(address); }
+void Z80OpsFast::poke16(uint16_t address, RegisterPair word) { Z80Ops::poke16(address, word); }
+uint8_t Z80OpsFast::inPort(uint16_t port) { return Z80Ops::inPort(port); }
+void Z80OpsFast::outPort(uint16_t port, uint8_t value) { Z80Ops::outPort(port, value); }
+void Z80OpsFast::addressOnBus(uint16_t address, int32_t wstates) { Z80Ops::addressOnBus(address, wstates); }
+void Z80OpsFast::interruptHandlingTime(int32_t wstates) { Z80Ops::interruptHandlingTime(wstates); }
+uint32_t Z80OpsFast::getTstates(void) { return tstates; }
+bool Z80OpsFast::isRepeatAllowed(void) { return true; }
+void Z80OpsFast::addTstates(int32_t tstatestoadd, bool /*dovideo*/) { tstates += tstatestoadd; }
+#ifdef INSTR_TRACE
+void Z80OpsFast::traceInstruction(uint16_t /*address*/) {
+}
+#endif
+#endif
+
+static void executeUntil(uint32_t deadline) {
+#ifdef Z80_FAST_CORE
+    if (fastCore) {
+        Z80Fast::executeUntil(deadline);
+        return;
+    }
+#endif
+    Z80::executeUntil(deadline);
+}
+
+static double seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// zexdoc / zexall
+
+static int runZex(const char* path, uint64_t maxTstates, bool blockCache) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    memset(ram, 0, sizeof(ram));
+    size_t len = fread(ram + 0x100, 1, sizeof(ram) - 0x100, f);
+    fclose(f);
+    printf("%s: %u bytes\n", path, (unsigned) len);
+
+    // BDOS: RET at 0005, top of TPA at 0006
+    ram[0x0005] = 0xC9;
+    ram[0x0006] = 0x00;
+    ram[0x0007] = 0xFE;
+
+    Z80::create();
+    Z80::reset();
+    Z80::setRegPC(0x0100);
+    Z80::setRegSP(0xFE00);
+#ifdef Z80_BLOCK_CACHE
+    Z80::setBlockCache(blockCache);
+#else
+    (void) blockCache;
+#endif
+
+    uint64_t total = 0;
+    double start = seconds();
+    cpmTraps = true;
+    cpmExit = false;
+    while (!cpmExit && (maxTstates == 0 || total < maxTstates)) {
+        tstates = 0;
+        executeUntil(ZEX_FRAME_TSTATES);
+        if (Z80::isHalted() && !cpmExit) {
+            printf("\nHALT at %04X\n", Z80::getRegPC());
+            break;
+        }
+        total += tstates;
+    }
+    double elapsed = seconds() - start;
+
+    printf("\n%s: %s, %llu tstates in %.2f s, %.1f MHz emulated\n", path,
+        !cpmExit ? "STOPPED" : (zexErrors ? "FAIL" : "PASS"),
+        (unsigned long long) total, elapsed, total / elapsed / 1e6);
+
+    return (cpmExit && zexErrors == 0) ? 0 : 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// 48K ROM boot
+
+#define ROM_FRAME_TSTATES 69888
+// frames a key is held down, then released
+#define ROM_KEY_FRAMES 4
+
+// 10 FOR I=1 TO 1E9: PRINT AT 0,0;I: NEXT I / RUN, as 48K keystrokes
+// (keywords are single keys, '^' is SYMBOL SHIFT, '\n' is ENTER)
+static const char* romKeys = "10FI^L1^F1E9^ZP^I0^N0^OI^ZNI\nR\n";
+
+// keyboard half rows, bit 0 first
+static const char* romKeyRows[8] = {
+    "\001ZXCV", "ASDFG", "QWERT", "12345", "09876", "POIUY", "\nLKJH", " \002MNB"
+};
+
+static void setKey(char key, bool down) {
+    for (int row = 0; row < 8; row++) {
+        const char* bit = strchr(romKeyRows[row], key);
+        if (bit != NULL && key != 0) {
+            if (down) keyRows[row] |= 1 << (bit - romKeyRows[row]);
+            else keyRows[row] &= ~(1 << (bit - romKeyRows[row]));
+        }
+    }
+}
+
+static uint32_t fnv(uint32_t hash, uint32_t value) {
+    return (hash ^ value) * 16777619u;
+}
+
+static int runRom(const char* path, uint32_t frames, bool blockCache) {
+    FILE* f = fopen(path, "rb");
+    if (f == NULL) {
+        perror(path);
+        return 2;
+    }
+    memset(ram, 0, sizeof(ram));
+    size_t len = fread(ram, 1, 0x4000, f);
+    fclose(f);
+    if (len != 0x4000) {
+        fprintf(stderr, "%s: not a 16K ROM\n", path);
+        return 2;
+    }
+
+    romMode = true;
+    Z80::create();
+    Z80::reset();
+#ifdef Z80_BLOCK_CACHE
+    Z80::setBlockCache(blockCache);
+#else
+    (void) blockCache;
+#endif
+
+    // typing starts once the ROM has cleared RAM and shown its message
+    const uint32_t typeFrom = 150;
+    const char* key = romKeys;
+    uint64_t total = 0;
+    double start = seconds();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+        if (frame >= typeFrom && *key) {
+            uint32_t phase = (frame - typeFrom) % (2 * ROM_KEY_FRAMES);
+            bool symbol = key[0] == '^';
+            char k = key[symbol ? 1 : 0];
+            if (phase == 0) {
+                setKey(k, true);
+                if (symbol) setKey('\002', true);
+            } else if (phase == ROM_KEY_FRAMES) {
+                setKey(k, false);
+                if (symbol) setKey('\002', false);
+                key += symbol ? 2 : 1;
+            }
+        }
+
+        tstates = 0;
+        while (tstates < ROM_FRAME_TSTATES) {
+            executeUntil(ROM_FRAME_TSTATES);
+            if (Z80::isHalted() && tstates < ROM_FRAME_TSTATES) {
+                uint32_t steps = (ROM_FRAME_TSTATES - tstates + 3) >> 2;
+                Z80::skipHalt(steps);
+                tstates += steps << 2;
+            }
+        }
+        total += tstates;
+        Z80::triggerINT();
+    }
+    double elapsed = seconds() - start;
+
+    uint32_t hash = 2166136261u;
+    for (uint32_t addr = 0x4000; addr < 0x10000; addr++)
+        hash = fnv(hash, ram[addr]);
+    hash = fnv(hash, Z80::getRegAF()); hash = fnv(hash, Z80::getRegBC());
+    hash = fnv(hash, Z80::getRegDE()); hash = fnv(hash, Z80::getRegHL());
+    hash = fnv(hash, Z80::getRegIX()); hash = fnv(hash, Z80::getRegIY());
+    hash = fnv(hash, Z80::getRegSP()); hash = fnv(hash, Z80::getRegPC());
+    hash = fnv(hash, Z80::getRegR()); hash = fnv(hash, total);
+
+    printf("%s: %u frames, %llu tstates in %.2f s, %.1f MHz emulated, hash %08X\n",
+        path, frames, (unsigned long long) total, elapsed, total / elapsed / 1e6, hash);
+
+    return *key ? 1 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// Random code
+
+static uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static uint32_t stateHash(uint32_t hash) {
+    for (uint32_t addr = 0; addr < 0x10000; addr++)
+        hash = fnv(hash, ram[addr]);
+    hash = fnv(hash, Z80::getRegAF()); hash = fnv(hash, Z80::getRegBC());
+    hash = fnv(hash, Z80::getRegDE()); hash = fnv(hash, Z80::getRegHL());
+    hash = fnv(hash, Z80::getRegAFx()); hash = fnv(hash, Z80::getRegBCx());
+    hash = fnv(hash, Z80::getRegDEx()); hash = fnv(hash, Z80::getRegHLx());
+    hash = fnv(hash, Z80::getRegIX()); hash = fnv(hash, Z80::getRegIY());
+    hash = fnv(hash, Z80::getRegSP()); hash = fnv(hash, Z80::getRegPC());
+    hash = fnv(hash, Z80::getMemPtr()); hash = fnv(hash, Z80::getRegI());
+    hash = fnv(hash, Z80::getRegR()); hash = fnv(hash, Z80::isIFF1());
+    hash = fnv(hash, Z80::isIFF2()); hash = fnv(hash, Z80::getIM());
+    hash = fnv(hash, Z80::isHalted());
+    return fnv(hash, tstates);
+}
+
+static int runRandom(uint32_t runs, bool blockCache) {
+    Z80::create();
+#ifdef Z80_BLOCK_CACHE
+    Z80::setBlockCache(blockCache);
+#else
+    (void) blockCache;
+#endif
+
+    uint32_t hash = 2166136261u;
+    uint64_t total = 0;
+    double start = seconds();
+    for (uint32_t run = 1; run <= runs; run++) {
+        uint32_t seed = run * 2654435761u;
+        // no HALT opcodes to begin with, or most runs would sit in one
+        for (uint32_t addr = 0; addr < 0x10000; addr++)
+            do ram[addr] = xorshift(seed); while (ram[addr] == 0x76);
+
+        Z80::reset();
+        Z80::setRegAF(xorshift(seed)); Z80::setRegBC(xorshift(seed));
+        Z80::setRegDE(xorshift(seed)); Z80::setRegHL(xorshift(seed));
+        Z80::setRegAFx(xorshift(seed)); Z80::setRegBCx(xorshift(seed));
+        Z80::setRegDEx(xorshift(seed)); Z80::setRegHLx(xorshift(seed));
+        Z80::setRegIX(xorshift(seed)); Z80::setRegIY(xorshift(seed));
+        Z80::setRegSP(xorshift(seed)); Z80::setRegPC(xorshift(seed));
+        Z80::setRegI(xorshift(seed));
+        Z80::setIM((Z80::IntMode) (xorshift(seed) % 3));
+#ifdef Z80_BLOCK_CACHE
+        Z80::flushBlocks();
+#endif
+
+        tstates = 0;
+        for (uint32_t deadline = 10000; deadline <= 200000; deadline += 10000) {
+            while (tstates < deadline) {
+                executeUntil(deadline);
+                if (Z80::isHalted() && tstates < deadline) {
+                    uint32_t steps = (deadline - tstates + 3) >> 2;
+                    Z80::skipHalt(steps);
+                    tstates += steps << 2;
+                }
+            }
+            Z80::triggerINT();
+        }
+        total += tstates;
+        hash = stateHash(hash);
+    }
+    double elapsed = seconds() - start;
+
+    printf("random: %u runs, %llu tstates in %.2f s, hash %08X\n",
+        runs, (unsigned long long) total, elapsed, hash);
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// FUSE core tests
+
+struct FuseState {
+    unsigned af, bc, de, hl, afx, bcx, dex, hlx, ix, iy, sp, pc, memptr;
+    unsigned i, r, iff1, iff2, im, halted, tstates;
+};
+
+static bool readState(FILE* f, FuseState& s) {
+    return fscanf(f, "%x %x %x %x %x %x %x %x %x %x %x %x %x",
+            &s.af, &s.bc, &s.de, &s.hl, &s.afx, &s.bcx, &s.dex, &s.hlx,
+            &s.ix, &s.iy, &s.sp, &s.pc, &s.memptr) == 13
+        && fscanf(f, "%x %x %u %u %u %u %u",
+            &s.i, &s.r, &s.iff1, &s.iff2, &s.im, &s.halted, &s.tstates) == 7;
+}
+
+// tests.in memory blocks "addr byte byte ... -1", ending with a lone -1
+static void readMemory(FILE* f) {
+    char word[16];
+    while (fscanf(f, "%15s", word) == 1 && strcmp(word, "-1") != 0) {
+        unsigned addr = strtoul(word, NULL, 16);
+        while (fscanf(f, "%15s", word) == 1 && strcmp(word, "-1") != 0)
+            ram[addr++ & 0xffff] = strtoul(word, NULL, 16);
+    }
+}
+
+// tests.expected memory lines "addr byte byte ... -1", ending with a blank line
+static void checkMemory(FILE* f, std::string& diff) {
+    char line[256];
+    // rest of the register line
+    if (fgets(line, sizeof(line), f) == NULL) return;
+    while (fgets(line, sizeof(line), f) != NULL && strspn(line, " \t\r\n") != strlen(line)) {
+        char* next;
+        unsigned addr = strtoul(line, &next, 16);
+        for (char* word = strtok(next, " \t\r\n"); word != NULL && strcmp(word, "-1") != 0;
+                word = strtok(NULL, " \t\r\n"), addr++) {
+            uint8_t value = strtoul(word, NULL, 16);
+            if (ram[addr & 0xffff] != value) {
+                char buf[32];
+                snprintf(buf, sizeof(buf), " (%04X)=%02X!=%02X", addr & 0xffff, ram[addr & 0xffff], value);
+                diff += buf;
+            }
+        }
+    }
+}
+
+static bool readName(FILE* f, char* name, size_t size) {
+    while (fgets(name, size, f) != NULL) {
+        name[strcspn(name, "\r\n")] = 0;
+        if (name[0] != 0) return true;
+    }
+    return false;
+}
+
+// tests.expected: events lines (indented) until the register line
+static bool skipEvents(FILE* f) {
+    int c;
+    while ((c = fgetc(f)) == ' ' || c == '\t') {
+        while ((c = fgetc(f)) != '\n' && c != EOF);
+    }
+    if (c == EOF) return false;
+    ungetc(c, f);
+    return true;
+}
+
+#define CHECK(field, value) \
+    if ((unsigned)(value) != exp.field) { \
+        snprintf(buf, sizeof(buf), " " #field "=%X!=%X", (unsigned)(value), exp.field); \
+        diff += buf; \
+    }
+
+static int runFuse(const char* inPath, const char* expPath) {
+    FILE* in = fopen(inPath, "r");
+    FILE* ex = fopen(expPath, "r");
+    if (in == NULL || ex == NULL) {
+        perror(in == NULL ? inPath : expPath);
+        return 2;
+    }
+
+    Z80::create();
+
+    std::map<std::string, int> timing;
+    char name[64], expName[64], buf[64];
+    int tests = 0, failed = 0;
+
+    while (readName(in, name, sizeof(name))) {
+        FuseState init, exp;
+        if (!readState(in, init)) break;
+
+        for (uint32_t addr = 0; addr < 0x10000; addr += 4) {
+            ram[addr] = 0xde; ram[addr + 1] = 0xad;
+            ram[addr + 2] = 0xbe; ram[addr + 3] = 0xef;
+        }
+        readMemory(in);
+
+        Z80::reset();
+        Z80::setRegAF(init.af); Z80::setRegBC(init.bc);
+        Z80::setRegDE(init.de); Z80::setRegHL(init.hl);
+        Z80::setRegAFx(init.afx); Z80::setRegBCx(init.bcx);
+        Z80::setRegDEx(init.dex); Z80::setRegHLx(init.hlx);
+        Z80::setRegIX(init.ix); Z80::setRegIY(init.iy);
+        Z80::setRegSP(init.sp); Z80::setRegPC(init.pc);
+        Z80::setMemPtr(init.memptr);
+        Z80::setRegI(init.i); Z80::setRegR(init.r);
+        Z80::setIFF1(init.iff1); Z80::setIFF2(init.iff2);
+        Z80::setIM((Z80::IntMode) init.im);
+        Z80::setHalted(init.halted);
+
+        tstates = 0;
+        do {
+            Z80::execute();
+        } while (tstates < init.tstates);
+
+        if (!readName(ex, expName, sizeof(expName)) || strcmp(name, expName) != 0
+                || !skipEvents(ex) || !readState(ex, exp)) {
+            fprintf(stderr, "%s: %s out of step at test %s\n", inPath, expPath, name);
+            return 2;
+        }
+
+        std::string diff;
+        CHECK(af, Z80::getRegAF()); CHECK(bc, Z80::getRegBC());
+        CHECK(de, Z80::getRegDE()); CHECK(hl, Z80::getRegHL());
+        CHECK(afx, Z80::getRegAFx()); CHECK(bcx, Z80::getRegBCx());
+        CHECK(dex, Z80::getRegDEx()); CHECK(hlx, Z80::getRegHLx());
+        CHECK(ix, Z80::getRegIX()); CHECK(iy, Z80::getRegIY());
+        CHECK(sp, Z80::getRegSP()); CHECK(pc, Z80::getRegPC());
+        CHECK(memptr, Z80::getMemPtr());
+        CHECK(i, Z80::getRegI()); CHECK(r, Z80::getRegR());
+        CHECK(iff1, Z80::isIFF1()); CHECK(iff2, Z80::isIFF2());
+        CHECK(im, Z80::getIM()); CHECK(halted, Z80::isHalted());
+        if (tstates != exp.tstates) {
+            CHECK(tstates, tstates);
+            timing[name] = (int) tstates - (int) exp.tstates;
+        }
+        checkMemory(ex, diff);
+
+        tests++;
+        if (!diff.empty()) {
+            failed++;
+            printf("%s:%s\n", name, diff.c_str());
+        }
+    }
+    fclose(in);
+    fclose(ex);
+
+    if (!timing.empty()) {
+        printf("T-state mismatches (got - expected):\n");
+        for (std::map<std::string, int>::iterator it = timing.begin(); it != timing.end(); ++it)
+            printf("  %-10s %+d\n", it->first.c_str(), it->second);
+    }
+    printf("%s: %d tests, %d failed, %u T-state mismatches\n", inPath, tests, failed, (unsigned) timing.size());
+
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    // last argument of zex, rom and random: nocache or fast
+    bool random = argc >= 2 && strcmp(argv[1], "random") == 0;
+    const char* option = argc > (random ? 3 : 4) ? argv[random ? 3 : 4] : "";
+    fastCore = strcmp(option, "fast") == 0;
+#ifndef Z80_FAST_CORE
+    if (fastCore) {
+        fprintf(stderr, "%s: built without -DZ80_FAST_CORE\n", argv[0]);
+        return 2;
+    }
+#endif
+    bool blockCache = strcmp(option, "nocache") != 0;
+
+    if (argc >= 3 && strcmp(argv[1], "zex") == 0)
+        return runZex(argv[2], argc > 3 ? strtoull(argv[3], NULL, 10) * 1000000 : 0, blockCache);
+    if (argc >= 4 && strcmp(argv[1], "fuse") == 0)
+        return runFuse(argv[2], argv[3]);
+    if (argc >= 3 && strcmp(argv[1], "rom") == 0)
+        return runRom(argv[2], argc > 3 ? strtoul(argv[3], NULL, 10) : 3000, blockCache);
+    if (random)
+        return runRandom(argc > 2 ? strtoul(argv[2], NULL, 10) : 1000, blockCache);
+
+    fprintf(stderr, "usage: %s zex <file.com> [max Mtstates] [nocache|fast]\n"
+                    "       %s fuse <tests.in> <tests.expected>\n"
+                    "       %s rom <file.rom> [frames] [nocache|fast]\n"
+                    "       %s random [runs] [nocache|fast]\n", argv[0], argv[0], argv[0], argv[0]);
+    return 2;
+}